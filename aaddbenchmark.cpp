@@ -0,0 +1,152 @@
+/*
+ * Benchmarks of the core engines through the C++ wrapper aaddheaderlib.hpp, including the cost of the calls
+ * into the shared library; the Kotlin benchmarks in src/commonBenchmark measure the engines without it.
+ *
+ * Requires Google Benchmark (https://github.com/google/benchmark). Build against it, the shared library
+ * and its header in build/bin/native/releaseShared, e.g. on Linux:
+ *
+ *   g++ -O2 -std=c++17 -I build/bin/native/releaseShared aaddbenchmark.cpp \
+ *       -L build/bin/native/releaseShared -laadd -lbenchmark -lpthread -o aaddbenchmark
+ *   ./aaddbenchmark --benchmark_format=json --benchmark_out=aaddbenchmark.json
+ */
+#include <benchmark/benchmark.h>
+#include "aaddheaderlib.hpp"
+#include <cstdio>
+#include <string>
+
+static libnative_ExportedSymbols* lib = libnative_symbols();
+
+/*
+ * A piecewise AADD of the inputs x and u, as a loop with a branch creates it, the same as in the Kotlin benchmarks:
+ * each step compares the state with a bound, so the AADD has up to 2^steps leaves.
+ */
+static AADD piecewise(DDBuilder& builder, int steps, const std::string& name) {
+	AADD x = builder.range(0.0, 1.0, (name + "x").c_str());
+	AADD u = builder.range(-0.5, 0.5, (name + "u").c_str());
+	AADD y = x;
+	for (int k = 0; k < steps; k++) {
+		BDD c = (y + u * 0.5) > 0.25 * (k + 1);
+		builder.IF(c);
+		y = builder.assign(y, y * 0.5 + u);
+		builder.ELSE();
+		y = builder.assign(y, y + 0.1);
+		builder.END();
+	}
+	return y;
+}
+
+/* A sum of ranges with the given number of noise symbols, starting with symbol first. */
+static AADD affine(DDBuilder& builder, int first, int symbols) {
+	AADD sum = builder.scalar(0.0);
+	for (int k = first; k < first + symbols; k++)
+		sum = sum + builder.range(0.0, 1.0 + k, ("x" + std::to_string(k)).c_str());
+	return sum;
+}
+
+/* Affine arithmetic on two forms that share half of their noise symbols. */
+static void BM_AffineAdd(benchmark::State& state) {
+	DDBuilder builder(lib);
+	int symbols = static_cast<int>(state.range(0));
+	AADD a = affine(builder, 0, symbols);
+	AADD b = affine(builder, symbols / 2, symbols);
+	for (auto _ : state) {
+		AADD c = a + b;
+		benchmark::DoNotOptimize(c.getStruct());
+	}
+}
+BENCHMARK(BM_AffineAdd)->Arg(4)->Arg(32)->Arg(256);
+
+static void BM_AffineMultiply(benchmark::State& state) {
+	DDBuilder builder(lib);
+	int symbols = static_cast<int>(state.range(0));
+	AADD a = affine(builder, 0, symbols);
+	AADD b = affine(builder, symbols / 2, symbols);
+	for (auto _ : state) {
+		AADD c = a * b;
+		benchmark::DoNotOptimize(c.getStruct());
+	}
+}
+BENCHMARK(BM_AffineMultiply)->Arg(4)->Arg(32)->Arg(256);
+
+/*
+ * The builder caches the results of operations, comparisons create new conditions, and getRange keeps
+ * its results in the builder and the root. The operations on DDs are therefore measured on a new builder
+ * in each iteration, whose creation is not timed.
+ */
+static void BM_DDApply(benchmark::State& state) {
+	int steps = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		DDBuilder builder(lib);
+		AADD a = piecewise(builder, steps, "a");
+		AADD b = piecewise(builder, steps, "b");
+		state.ResumeTiming();
+		AADD c = a * b + a;
+		benchmark::DoNotOptimize(c.getStruct());
+	}
+}
+BENCHMARK(BM_DDApply)->Arg(2)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+static void BM_Compare(benchmark::State& state) {
+	int steps = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		DDBuilder builder(lib);
+		AADD a = piecewise(builder, steps, "a");
+		state.ResumeTiming();
+		BDD c = a > 0.5;
+		benchmark::DoNotOptimize(c.getStruct());
+	}
+}
+BENCHMARK(BM_Compare)->Arg(2)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+static void BM_GetRange(benchmark::State& state) {
+	int steps = static_cast<int>(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		DDBuilder builder(lib);
+		AADD a = piecewise(builder, steps, "a");
+		state.ResumeTiming();
+		a.getRange();
+		benchmark::DoNotOptimize(a.get_max());
+	}
+}
+BENCHMARK(BM_GetRange)->Arg(2)->Arg(4)->Arg(6)->Unit(benchmark::kMicrosecond);
+
+/* Serialization: a full checkpoint of the builder session and an AADD, and its restore into a new builder. */
+static void BM_CheckpointSave(benchmark::State& state) {
+	DDBuilder builder(lib);
+	AADD a = piecewise(builder, static_cast<int>(state.range(0)), "a");
+	std::string path = "aaddbenchmark-save-" + std::to_string(state.range(0)) + ".aadc";
+	// The file is opened once by the first save; each full checkpoint is appended to it.
+	Checkpoint checkpoint = builder.checkpoint(path.c_str());
+	checkpoint.set("a", a);
+	checkpoint.save(true);
+	for (auto _ : state)
+		checkpoint.save(true);
+	checkpoint.close();
+	std::remove(path.c_str());
+}
+BENCHMARK(BM_CheckpointSave)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+static void BM_CheckpointRestore(benchmark::State& state) {
+	std::string path = "aaddbenchmark-restore-" + std::to_string(state.range(0)) + ".aadc";
+	{
+		DDBuilder builder(lib);
+		Checkpoint checkpoint = builder.checkpoint(path.c_str());
+		checkpoint.set("a", piecewise(builder, static_cast<int>(state.range(0)), "a"));
+		checkpoint.save(true);
+		checkpoint.close();
+	}
+	for (auto _ : state) {
+		state.PauseTiming();
+		DDBuilder builder(lib);
+		Checkpoint checkpoint = builder.checkpoint(path.c_str());
+		state.ResumeTiming();
+		benchmark::DoNotOptimize(checkpoint.restore());
+	}
+	std::remove(path.c_str());
+}
+BENCHMARK(BM_CheckpointRestore)->Arg(4)->Arg(8)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
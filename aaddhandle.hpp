@@ -0,0 +1,136 @@
+#pragma once
+#ifndef AADDHANDLE
+#define AADDHANDLE
+
+#include "libnative_api.h"
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+/*
+ * Ownership of the stable pointers that the library returns for Kotlin objects.
+ * Each result of a library call is wrapped in exactly one KHandle; copies of the handle share it by reference
+ * counting, moves transfer it, and the last handle disposes the stable pointer. Hence, temporaries created by
+ * operators no longer keep their Kotlin objects alive.
+ */
+
+/* Number of stable pointers currently owned by handles. Should stay flat in long simulations; for debugging. */
+inline std::atomic<long>& aaddLiveHandleCounter() {
+	static std::atomic<long> counter(0);
+	return counter;
+}
+
+inline long aaddLiveHandles() {
+	return aaddLiveHandleCounter().load();
+}
+
+template <typename KRef>
+class KHandle {
+public:
+	KHandle() : ref(), lib(nullptr), count(nullptr) {}
+
+	KHandle(KRef _ref, libnative_ExportedSymbols* _lib) : ref(_ref), lib(_lib), count(new std::atomic<long>(1)) {
+		++aaddLiveHandleCounter();
+	}
+
+	KHandle(const KHandle& other) : ref(other.ref), lib(other.lib), count(other.count) {
+		if (count) ++*count;
+	}
+
+	KHandle(KHandle&& other) noexcept : ref(other.ref), lib(other.lib), count(other.count) {
+		other.count = nullptr;
+	}
+
+	KHandle& operator =(KHandle other) noexcept {
+		swap(other);
+		return *this;
+	}
+
+	~KHandle() {
+		release();
+	}
+
+	void swap(KHandle& other) noexcept {
+		std::swap(ref, other.ref);
+		std::swap(lib, other.lib);
+		std::swap(count, other.count);
+	}
+
+	/* True if this is the only reference. */
+	bool unique() const {
+		return count && *count == 1;
+	}
+
+	/* Gives up the reference; disposes the stable pointer if it was the last one. */
+	void release() {
+		if (count && --*count == 0) {
+			lib->DisposeStablePointer(ref.pinned);
+			delete count;
+			--aaddLiveHandleCounter();
+		}
+		count = nullptr;
+	}
+
+	KRef get() const {
+		return ref;
+	}
+
+	bool valid() const {
+		return count != nullptr;
+	}
+
+	long useCount() const {
+		return count ? count->load() : 0;
+	}
+
+private:
+	KRef ref;
+	libnative_ExportedSymbols* lib;
+	std::atomic<long>* count;
+};
+
+/* Number of buckets of the histogram of the LP time; TimeHistogram.BUCKETS of the library. */
+#define AADD_TIME_BUCKETS 40
+
+/*
+ * Statistics of a builder, see DDStatistics of the library: the nodes created by type, the operations,
+ * the LP solver, noise symbols and conditions. Bucket k of the histogram of the LP time counts the solves
+ * that took [2^(k-1), 2^k) ns; the last bucket all longer ones.
+ * The layout is that of DDStatistics.Snapshot.toLongArray(); leafMergeLoss is copied as the bits of a double.
+ */
+struct AADDStatistics {
+	int64_t aaddLeaves;
+	int64_t aaddInternals;
+	int64_t bddInternals;
+	int64_t iddLeaves;
+	int64_t iddInternals;
+	int64_t strDDLeaves;
+	int64_t strDDInternals;
+	int64_t peakNodes;
+	int64_t applyCalls;
+	int64_t applyComputed;
+	int64_t leafMerges;
+	double leafMergeLoss;
+	int64_t lpSolves;
+	int64_t lpAvoided;
+	int64_t lpPivots;
+	int64_t noiseSymbolsCreated;
+	int64_t noiseSymbolsCompressed;
+	int64_t noiseSymbolsReclaimed;
+	int64_t conditionsCreated;
+	int64_t conditionsCollected;
+	int64_t lpTimeCount;
+	int64_t lpTimeTotalNanos;
+	int64_t lpTimeMaxNanos;
+	int64_t lpTimeBuckets[AADD_TIME_BUCKETS];
+};
+
+/* Fetches the statistics of the builder with the given stable pointer; reset sets them to zero after the copy. */
+inline AADDStatistics aaddStatistics(void* builder, bool reset = false) {
+	AADDStatistics statistics = {};
+	static_assert(sizeof(double) == sizeof(int64_t), "AADDStatistics is an array of 64-bit values");
+	aadd_statistics(builder, &statistics, sizeof(statistics) / sizeof(int64_t), reset);
+	return statistics;
+}
+
+#endif // !AADDHANDLE
@@ -3,7 +3,11 @@
 #define AADDWRAPPER
 
 #include "libnative_api.h"
+#include "aaddhandle.hpp"
 #include <iostream>
+#include <string>
+#include <cstdio>
+#include <stdexcept>
 
 /*
  * !!! Needs update !!!
@@ -14,21 +18,15 @@
 
 class NumberRange {
 public:
-	NumberRange(libnative_kref_com_github_tukcps_aadd_values_NumberRange _numberRangeStruct, libnative_ExportedSymbols* _lib) {
-		numberRangeStruct = _numberRangeStruct;
-		lib = _lib;
-	}
-
-	~NumberRange() {
-		lib->DisposeStablePointer(numberRangeStruct.pinned);
-	}
+	NumberRange(libnative_kref_com_github_tukcps_aadd_values_NumberRange _numberRangeStruct, libnative_ExportedSymbols* _lib)
+		: numberRangeHandle(_numberRangeStruct, _lib), lib(_lib) {}
 
-	libnative_kref_com_github_tukcps_aadd_values_NumberRange getStruct() {
-		return numberRangeStruct;
+	libnative_kref_com_github_tukcps_aadd_values_NumberRange getStruct() const {
+		return numberRangeHandle.get();
 	}
 
 private:
-	libnative_kref_com_github_tukcps_aadd_values_NumberRange numberRangeStruct;
+	KHandle<libnative_kref_com_github_tukcps_aadd_values_NumberRange> numberRangeHandle;
 	libnative_ExportedSymbols* lib;
 };
 
@@ -36,15 +34,8 @@ private:
 class BDD {
 
 public:
-	BDD(libnative_kref_com_github_tukcps_aadd_BDD _bddStruct, libnative_ExportedSymbols* _lib) {
-		bddStruct = _bddStruct;
-		lib = _lib;
-	}
-
-	/*
-	~BDD() {
-		lib->DisposeStablePointer(bddStruct.pinned);
-	}*/
+	BDD(libnative_kref_com_github_tukcps_aadd_BDD _bddStruct, libnative_ExportedSymbols* _lib)
+		: bddHandle(_bddStruct, _lib), lib(_lib) {}
 
 	/*
 	 * Operator Overloads:
@@ -63,7 +54,7 @@ public:
 	}
 
 	BDD and_(BDD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.and_(bddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.and_(bddHandle.get(), other.getStruct());
 		return BDD(res,lib);
 	}
 
@@ -71,67 +62,67 @@ public:
 
 
 	BDD evaluate() {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.evaluate(bddStruct);
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.evaluate(bddHandle.get());
 		return BDD(res, lib);
 	}
 
 	BDD intersect(BDD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.intersect(bddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.intersect(bddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 	/*
 	AADD ite(AADD t, AADD e) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.ite(bddStruct, t.getStruct(), e.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.ite(bddHandle.get(), t.getStruct(), e.getStruct());
 		return AADD(res, lib);
 	}
 
 	BDD ite(BDD t, BDD e) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.ite_(bddStruct, t.getStruct(), e.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.ite_(bddHandle.get(), t.getStruct(), e.getStruct());
 		return BDD(res, lib);
 	}*/
 
 	BDD nand(BDD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.nand(bddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.nand(bddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	BDD not_() {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.not_(bddStruct);
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.not_(bddHandle.get());
 		return BDD(res, lib);
 	}
 
 	BDD or_(BDD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.or_(bddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.or_(bddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	BDD xor_(BDD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.xor_(bddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.BDD.xor_(bddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	bool satisfiable() {
-		return lib->kotlin.root.io.github.tukcps.aadd.BDD.satisfiable(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.BDD.satisfiable(bddHandle.get());
 	}
 
 	int numFalse() {
-		return lib->kotlin.root.io.github.tukcps.aadd.BDD.numFalse(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.BDD.numFalse(bddHandle.get());
 	}
 
 	int numTrue() {
-		return lib->kotlin.root.io.github.tukcps.aadd.BDD.numTrue(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.BDD.numTrue(bddHandle.get());
 	}
 
 	const char* toIteString() {
-		return lib->kotlin.root.io.github.tukcps.aadd.BDD.toIteString(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.BDD.toIteString(bddHandle.get());
 	}
 
-	libnative_kref_com_github_tukcps_aadd_BDD getStruct() {
-		return bddStruct;
+	libnative_kref_com_github_tukcps_aadd_BDD getStruct() const {
+		return bddHandle.get();
 	}
 
 private:
-	libnative_kref_com_github_tukcps_aadd_BDD bddStruct;
+	KHandle<libnative_kref_com_github_tukcps_aadd_BDD> bddHandle;
 	libnative_ExportedSymbols* lib;
 };
 
@@ -141,10 +132,8 @@ class AADD {
 public:
 
 
-	AADD(libnative_kref_com_github_tukcps_aadd_AADD _aaddStruct, libnative_ExportedSymbols* _lib) {
-		aaddStruct = _aaddStruct;
-		lib = _lib;
-	}
+	AADD(libnative_kref_com_github_tukcps_aadd_AADD _aaddStruct, libnative_ExportedSymbols* _lib)
+		: aaddHandle(_aaddStruct, _lib), lib(_lib) {}
 
 	/*
 	 * Operator Overloads:
@@ -199,123 +188,118 @@ public:
 		return greaterThanOrEquals(other);
 	}
 
-	/*
-	~AADD() {
-		lib->DisposeStablePointer(aaddStruct.pinned);
-	}*/
-
-	libnative_kref_com_github_tukcps_aadd_AADD getStruct() {
-		return aaddStruct;
+	libnative_kref_com_github_tukcps_aadd_AADD getStruct() const {
+		return aaddHandle.get();
 	}
 
 	AADD plus(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.plus(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.plus(aaddHandle.get(), other.getStruct());
 		return AADD(res, lib);
 	}
 
 	int get_index() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_index(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_index(aaddHandle.get());
 	}
 
 	double get_max() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_max(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_max(aaddHandle.get());
 	}
 
 	bool get_maxIsInf() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_maxIsInf(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_maxIsInf(aaddHandle.get());
 	}
 
 	bool get_maxIsNaN() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_maxIsNaN(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_maxIsNaN(aaddHandle.get());
 	}
 
 	double get_min() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_min(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_min(aaddHandle.get());
 	}
 
 	bool get_minIsInf() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_minIsInf(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_minIsInf(aaddHandle.get());
 	}
 
 	bool get_minIsNaN() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_minIsNaN(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.get_minIsNaN(aaddHandle.get());
 	}
 
 	AADD ceil() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.ceil(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.ceil(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	long long ceilAsLong() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.ceilAsLong(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.ceilAsLong(aaddHandle.get());
 	}
 
 	AADD constrainTo(NumberRange other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.constrainTo(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.constrainTo(aaddHandle.get(), other.getStruct());
 		return AADD(res, lib);
 	}
 
 	bool contains(double value) {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.contains(aaddStruct, value);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.contains(aaddHandle.get(), value);
 	}
 
 	AADD div(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.div(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.div(aaddHandle.get(), other.getStruct());
 		return AADD(res, lib);
 	}
 
 	AADD div(double other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.div__(aaddStruct, other);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.div__(aaddHandle.get(), other);
 		return AADD(res, lib);
 	}
 
 	AADD evaluate() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.evaluate(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.evaluate(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD exp() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.exp(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.exp(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	BDD greaterThan(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThan(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThan(aaddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	BDD greaterThan(double other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThan__(aaddStruct, other);
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThan__(aaddHandle.get(), other);
 		return BDD(res, lib);
 	}
 
 	BDD greaterThanOrEquals(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThanOrEquals(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThanOrEquals(aaddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	BDD greaterThanOrEquals(double other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThanOrEquals__(aaddStruct, other);
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.greaterThanOrEquals__(aaddHandle.get(), other);
 		return BDD(res, lib);
 	}
 
 	AADD intersect(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.intersect(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.intersect(aaddHandle.get(), other.getStruct());
 		return AADD(res, lib);
 	}
 
 	AADD inv() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.inv(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.inv(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD invCeil() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.invCeil(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.invCeil(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD invFloor() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.invFloor(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.invFloor(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
@@ -324,123 +308,125 @@ public:
 	}
 
 	BDD lessThan(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThan(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThan(aaddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	BDD lessThan(double other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThan__(aaddStruct, other);
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThan__(aaddHandle.get(), other);
 		return BDD(res, lib);
 	}
 
 	BDD lessThanOrEquals(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThanOrEquals(aaddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThanOrEquals(aaddHandle.get(), other.getStruct());
 		return BDD(res, lib);
 	}
 
 	BDD lessThanOrEquals(double other) {
-		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThanOrEquals__(aaddStruct, other);
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.lessThanOrEquals__(aaddHandle.get(), other);
 		return BDD(res, lib);
 	}
 
 	AADD log() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.log(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.log(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	// TODO switch to new Form
 	/*
 	AADD log(double base) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.log_(aaddStruct, base);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.log_(aaddHandle.get(), base);
 		return AADD(res, lib);
 	}*/
 
 	AADD minus(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.minus(aaddStruct,other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.minus(aaddHandle.get(),other.getStruct());
 		return AADD(res, lib);
 
 	}
 
 	AADD minus(double other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.minus__(aaddStruct,other);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.minus__(aaddHandle.get(),other);
 		return AADD(res, lib);
 	}
 
 	AADD negate() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.negate(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.negate(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD floor() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.floor(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.floor(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD plus(double other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.plus__(aaddStruct,other);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.plus__(aaddHandle.get(),other);
 		return AADD(res, lib);
 	}
 
 	AADD pow(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.pow(aaddStruct,other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.pow(aaddHandle.get(),other.getStruct());
 		return AADD(res, lib);
 	}
 
 	AADD pow(double other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.pow___(aaddStruct,other);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.pow___(aaddHandle.get(),other);
 		return AADD(res, lib);
 	}
 
 	AADD power(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.power(aaddStruct,other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.power(aaddHandle.get(),other.getStruct());
 		return AADD(res, lib);
 	}
 
 	AADD power2() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.power2(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.power2(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD sqrt() {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.sqrt(aaddStruct);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.sqrt(aaddHandle.get());
 		return AADD(res, lib);
 	}
 
 	AADD times(AADD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.times(aaddStruct,other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.times(aaddHandle.get(),other.getStruct());
 		return AADD(res, lib);
 	}
 
 	AADD times(BDD other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.times_(aaddStruct,other.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.times_(aaddHandle.get(),other.getStruct());
 		return AADD(res, lib);
 	}
 
 	AADD times(double other) {
-		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.times___(aaddStruct,other);
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.AADD.times___(aaddHandle.get(),other);
 		return AADD(res, lib);
 	}
 
 	const char* toString() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.toString(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.toString(aaddHandle.get());
 	}
 
 	const char* toIteString() {
-		return lib->kotlin.root.io.github.tukcps.aadd.AADD.toIteString(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.aadd.AADD.toIteString(aaddHandle.get());
 	}
 
 	void getRange() {
-		lib->kotlin.root.io.github.tukcps.aadd.AADD.getRange(aaddStruct);
+		lib->kotlin.root.io.github.tukcps.aadd.AADD.getRange(aaddHandle.get());
 	}
 
 private:
-	libnative_kref_com_github_tukcps_aadd_AADD aaddStruct;
+	KHandle<libnative_kref_com_github_tukcps_aadd_AADD> aaddHandle;
 	libnative_ExportedSymbols* lib;
 };
 
 
 
 /* Wrapper for the DDBuilder Class */
+class Checkpoint;
+
 class DDBuilder {
 
 public:
@@ -452,60 +438,373 @@ public:
 		// Builder Noise Vars Creation
 		libnative_kref_com_github_tukcps_aadd_NoiseVariables noiseVars = lib->kotlin.root.io.github.tukcps.aadd.NoiseVariables.NoiseVariables();
 		// Initialize our Builder Struct
-		builderStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.DDBuilder__(noiseVars,false);
-	}
-
-	/* Destructors */
-
-	~DDBuilder() {
-		lib->DisposeStablePointer(builderStruct.pinned);
+		builderHandle = KHandle<libnative_kref_com_github_tukcps_aadd_DDBuilder>(
+			lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.DDBuilder__(noiseVars,false), lib);
+		lib->DisposeStablePointer(noiseVars.pinned);
 	}
 
 
 	AADD range(double min, double max, int index) {
-		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.range(builderStruct, min, max, index);
+		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.range(builderHandle.get(), min, max, index);
 		return AADD(aaddStruct, lib);
 	}
 
 	AADD range(double min, double max, const char* id) {
-		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.range_(builderStruct, min, max, id);
+		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.range_(builderHandle.get(), min, max, id);
 		return AADD(aaddStruct, lib);
 	}
 
 	AADD scalar(double value) {
-		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.scalar(builderStruct, value);
+		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.scalar(builderHandle.get(), value);
 		return AADD(aaddStruct, lib);
 	}
 
 	AADD assign(AADD old,AADD new_) {
-		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.assign(builderStruct, old.getStruct(), new_.getStruct());
+		libnative_kref_com_github_tukcps_aadd_AADD aaddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.assign(builderHandle.get(), old.getStruct(), new_.getStruct());
 		return AADD(aaddStruct, lib);
 	}
 
 	BDD assign(BDD old, BDD new_) {
-		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.assign_(builderStruct, old.getStruct(), new_.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.assign_(builderHandle.get(), old.getStruct(), new_.getStruct());
 		return BDD(bddStruct, lib);
 	}
 
 	BDD IF(BDD cond) {
-		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.IF(builderStruct, cond.getStruct());
+		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.IF(builderHandle.get(), cond.getStruct());
 		return BDD(bddStruct, lib);
 	}
 
 	BDD END() {
-		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.END(builderStruct);
+		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.END(builderHandle.get());
 		return BDD(bddStruct, lib);
 	}
 
 	BDD ELSE() {
-		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.ELSE(builderStruct);
+		libnative_kref_com_github_tukcps_aadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.ELSE(builderHandle.get());
 		return BDD(bddStruct, lib);
 	}
 
+	/* Number of leaves solved by the LP solver, and decided without it, by this builder. */
+	long lpCalls() {
+		return lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.get_lpCalls(builderHandle.get());
+	}
+
+	long lpCallsAvoided() {
+		return lib->kotlin.root.io.github.tukcps.aadd.DDBuilder.get_lpCallsAvoided(builderHandle.get());
+	}
+
+	/* Statistics of this builder, see AADDStatistics; reset sets them to zero after the copy. */
+	AADDStatistics statistics(bool reset = false) {
+		return aaddStatistics(builderHandle.get().pinned, reset);
+	}
+
+	/* Checkpoints of this builder in a file, see Checkpoint. */
+	Checkpoint checkpoint(const char* path);
+
+	libnative_kref_com_github_tukcps_aadd_DDBuilder getStruct() const {
+		return builderHandle.get();
+	}
+
+	libnative_ExportedSymbols* getLib() {
+		return lib;
+	}
+
 private:
-	libnative_kref_com_github_tukcps_aadd_DDBuilder builderStruct;
+	KHandle<libnative_kref_com_github_tukcps_aadd_DDBuilder> builderHandle;
 	libnative_ExportedSymbols* lib;
 
 };
 
+/*
+ * Checkpoints of a builder session in a file: settings, conditions, noise variables and named DDs.
+ * Periodic checkpoints only append what was created since the last one:
+ *
+ *   Checkpoint cp = builder.checkpoint("run.aadc");
+ *   cp.set("x", x);
+ *   cp.save();               // full at first, incremental afterwards
+ *
+ * A warm start restores into a new builder, and continues checkpointing into the same file;
+ * the first full checkpoint is written to "run.aadc.tmp", which replaces the file only when it is complete:
+ *
+ *   DDBuilder restored(lib);
+ *   Checkpoint cp = restored.checkpoint("run.aadc");
+ *   cp.restore();
+ *   AADD x = cp.getReal("x");
+ */
+class Checkpoint {
+public:
+	Checkpoint(libnative_kref_com_github_tukcps_aadd_dao_CheckpointFile _checkpointStruct, libnative_ExportedSymbols* _lib)
+		: checkpointHandle(_checkpointStruct, _lib), lib(_lib) {}
+
+	Checkpoint(const Checkpoint&) = default;
+	Checkpoint(Checkpoint&&) noexcept = default;
+
+	Checkpoint& operator =(Checkpoint other) noexcept {
+		checkpointHandle.swap(other.checkpointHandle);
+		std::swap(lib, other.lib);
+		return *this;
+	}
+
+	/* The file is closed when the last copy is released. */
+	~Checkpoint() {
+		if (checkpointHandle.unique()) close();
+	}
+
+	/* Restores the session into the builder, which must be new; returns the number of named DDs. */
+	int restore() {
+		return lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.restore(checkpointHandle.get());
+	}
+
+	void set(const char* name, AADD dd) {
+		lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.setReal(checkpointHandle.get(), name, dd.getStruct());
+	}
+
+	void set(const char* name, BDD dd) {
+		lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.setBool(checkpointHandle.get(), name, dd.getStruct());
+	}
+
+	void remove(const char* name) {
+		lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.remove(checkpointHandle.get(), name);
+	}
+
+	AADD getReal(const char* name) {
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.getReal(checkpointHandle.get(), name);
+		if (res.pinned == nullptr)
+			throw std::out_of_range(std::string("no AADD in checkpoint: ") + name);
+		return AADD(res, lib);
+	}
+
+	BDD getBool(const char* name) {
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.getBool(checkpointHandle.get(), name);
+		if (res.pinned == nullptr)
+			throw std::out_of_range(std::string("no BDD in checkpoint: ") + name);
+		return BDD(res, lib);
+	}
+
+	/* Appends a checkpoint to the file; returns true if it is full. */
+	bool save(bool full = false) {
+		return lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.save(checkpointHandle.get(), full);
+	}
+
+	void close() {
+		lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.close(checkpointHandle.get());
+	}
+
+private:
+	KHandle<libnative_kref_com_github_tukcps_aadd_dao_CheckpointFile> checkpointHandle;
+	libnative_ExportedSymbols* lib;
+};
+
+inline Checkpoint DDBuilder::checkpoint(const char* path) {
+	libnative_kref_com_github_tukcps_aadd_dao_CheckpointFile res =
+		lib->kotlin.root.io.github.tukcps.aadd.dao.CheckpointFile.CheckpointFile(builderHandle.get(), path);
+	return Checkpoint(res, lib);
+}
+
+/*
+ * Batched evaluation of expressions.
+ * An ExpressionRecorder records a computation on registers instead of calling the library for each operation.
+ * The recorded program is passed to the library once, and then runs with a single call per evaluation:
+ *
+ *   ExpressionRecorder rec;
+ *   Expr x = rec.input(), u = rec.input();
+ *   Expr next = rec.ite(x < 1.0, x + u * 0.1, x);
+ *   rec.output(next);
+ *   ExpressionBatch batch = rec.compile(builder);
+ *   batch.set(x, xValue); batch.set(u, uValue);
+ *   batch.run();
+ *   AADD result = batch.getReal(next);
+ */
+
+class ExpressionRecorder;
+
+/* A register of a recorded expression; operators append operations to the recorder. */
+class Expr {
+public:
+	Expr(ExpressionRecorder* _rec, int _reg) : rec(_rec), reg(_reg) {}
+
+	int getRegister() const {
+		return reg;
+	}
+
+	Expr operator +(const Expr& other) const;
+	Expr operator -(const Expr& other) const;
+	Expr operator *(const Expr& other) const;
+	Expr operator /(const Expr& other) const;
+	Expr operator +(double other) const;
+	Expr operator -(double other) const;
+	Expr operator *(double other) const;
+	Expr operator /(double other) const;
+	Expr operator -() const;
+
+	Expr operator <(const Expr& other) const;
+	Expr operator <=(const Expr& other) const;
+	Expr operator >(const Expr& other) const;
+	Expr operator >=(const Expr& other) const;
+	Expr operator <(double other) const;
+	Expr operator <=(double other) const;
+	Expr operator >(double other) const;
+	Expr operator >=(double other) const;
+
+	Expr operator &&(const Expr& other) const;
+	Expr operator ||(const Expr& other) const;
+	Expr operator !() const;
+
+private:
+	ExpressionRecorder* rec;
+	int reg;
+};
+
+
+/* Wrapper for a compiled program; inputs are set and results fetched by register. */
+class ExpressionBatch {
+public:
+	ExpressionBatch(libnative_kref_com_github_tukcps_aadd_ExpressionBatch _batchStruct, libnative_ExportedSymbols* _lib)
+		: batchHandle(_batchStruct, _lib), lib(_lib) {}
+
+	libnative_kref_com_github_tukcps_aadd_ExpressionBatch getStruct() const {
+		return batchHandle.get();
+	}
+
+	void set(const Expr& input, AADD value) {
+		lib->kotlin.root.io.github.tukcps.aadd.ExpressionBatch.setReal(batchHandle.get(), input.getRegister(), value.getStruct());
+	}
+
+	void set(const Expr& input, BDD value) {
+		lib->kotlin.root.io.github.tukcps.aadd.ExpressionBatch.setBool(batchHandle.get(), input.getRegister(), value.getStruct());
+	}
+
+	/* Runs all recorded operations in one call. */
+	void run() {
+		lib->kotlin.root.io.github.tukcps.aadd.ExpressionBatch.run(batchHandle.get());
+	}
+
+	AADD getReal(const Expr& output) {
+		libnative_kref_com_github_tukcps_aadd_AADD res = lib->kotlin.root.io.github.tukcps.aadd.ExpressionBatch.getReal(batchHandle.get(), output.getRegister());
+		return AADD(res, lib);
+	}
+
+	BDD getBool(const Expr& output) {
+		libnative_kref_com_github_tukcps_aadd_BDD res = lib->kotlin.root.io.github.tukcps.aadd.ExpressionBatch.getBool(batchHandle.get(), output.getRegister());
+		return BDD(res, lib);
+	}
+
+private:
+	KHandle<libnative_kref_com_github_tukcps_aadd_ExpressionBatch> batchHandle;
+	libnative_ExportedSymbols* lib;
+};
+
+
+/* Records operations as a compact program for ExpressionBatch; no library calls until compile(). */
+class ExpressionRecorder {
+public:
+	ExpressionRecorder() : registers(0) {}
+
+	/* A register whose value is set before each run. */
+	Expr input() {
+		Expr r = next();
+		emit("in", r.getRegister());
+		return r;
+	}
+
+	/* Marks a register as a result; only results can be fetched, and they keep their value across runs. */
+	void output(const Expr& e) {
+		emit("out", e.getRegister());
+	}
+
+	Expr constant(double value) {
+		Expr r = next();
+		char buf[32];
+		std::snprintf(buf, sizeof(buf), "%.17g", value);
+		program += "const " + std::to_string(r.getRegister()) + " " + buf + ";";
+		return r;
+	}
+
+	/* Copies the value of e to the register to, e.g. to update a state that is an output. */
+	void assign(const Expr& to, const Expr& e) {
+		emit("mov", to.getRegister(), e.getRegister());
+	}
+
+	Expr unary(const char* op, const Expr& a) {
+		Expr r = next();
+		emit(op, r.getRegister(), a.getRegister());
+		return r;
+	}
+
+	Expr binary(const char* op, const Expr& a, const Expr& b) {
+		Expr r = next();
+		emit(op, r.getRegister(), a.getRegister(), b.getRegister());
+		return r;
+	}
+
+	Expr ite(const Expr& c, const Expr& t, const Expr& e) {
+		Expr r = next();
+		emit("ite", r.getRegister(), c.getRegister(), t.getRegister(), e.getRegister());
+		return r;
+	}
+
+	Expr exp(const Expr& a) { return unary("exp", a); }
+	Expr log(const Expr& a) { return unary("ln", a); }
+	Expr sqrt(const Expr& a) { return unary("sqrt", a); }
+	Expr power2(const Expr& a) { return unary("sqr", a); }
+	Expr inv(const Expr& a) { return unary("inv", a); }
+	Expr floor(const Expr& a) { return unary("floor", a); }
+	Expr ceil(const Expr& a) { return unary("ceil", a); }
+	Expr pow(const Expr& a, const Expr& b) { return binary("pow", a, b); }
+	Expr xor_(const Expr& a, const Expr& b) { return binary("xor", a, b); }
+	Expr nand(const Expr& a, const Expr& b) { return binary("nand", a, b); }
+
+	const std::string& getProgram() const {
+		return program;
+	}
+
+	/* Passes the recorded program to the library, in one call. */
+	ExpressionBatch compile(DDBuilder& builder) {
+		libnative_ExportedSymbols* lib = builder.getLib();
+		libnative_kref_com_github_tukcps_aadd_ExpressionBatch res =
+			lib->kotlin.root.io.github.tukcps.aadd.ExpressionBatch.ExpressionBatch(builder.getStruct(), program.c_str());
+		return ExpressionBatch(res, lib);
+	}
+
+private:
+	Expr next() {
+		return Expr(this, registers++);
+	}
+
+	void emit(const char* op, int r, int a = -1, int b = -1, int c = -1) {
+		program += op;
+		program += " " + std::to_string(r);
+		if (a >= 0) program += " " + std::to_string(a);
+		if (b >= 0) program += " " + std::to_string(b);
+		if (c >= 0) program += " " + std::to_string(c);
+		program += ";";
+	}
+
+	int registers;
+	std::string program;
+};
+
+inline Expr Expr::operator +(const Expr& other) const { return rec->binary("add", *this, other); }
+inline Expr Expr::operator -(const Expr& other) const { return rec->binary("sub", *this, other); }
+inline Expr Expr::operator *(const Expr& other) const { return rec->binary("mul", *this, other); }
+inline Expr Expr::operator /(const Expr& other) const { return rec->binary("div", *this, other); }
+inline Expr Expr::operator +(double other) const { return *this + rec->constant(other); }
+inline Expr Expr::operator -(double other) const { return *this - rec->constant(other); }
+inline Expr Expr::operator *(double other) const { return *this * rec->constant(other); }
+inline Expr Expr::operator /(double other) const { return *this / rec->constant(other); }
+inline Expr Expr::operator -() const { return rec->unary("neg", *this); }
+
+inline Expr Expr::operator <(const Expr& other) const { return rec->binary("lt", *this, other); }
+inline Expr Expr::operator <=(const Expr& other) const { return rec->binary("le", *this, other); }
+inline Expr Expr::operator >(const Expr& other) const { return rec->binary("gt", *this, other); }
+inline Expr Expr::operator >=(const Expr& other) const { return rec->binary("ge", *this, other); }
+inline Expr Expr::operator <(double other) const { return *this < rec->constant(other); }
+inline Expr Expr::operator <=(double other) const { return *this <= rec->constant(other); }
+inline Expr Expr::operator >(double other) const { return *this > rec->constant(other); }
+inline Expr Expr::operator >=(double other) const { return *this >= rec->constant(other); }
+
+inline Expr Expr::operator &&(const Expr& other) const { return rec->binary("and", *this, other); }
+inline Expr Expr::operator ||(const Expr& other) const { return rec->binary("or", *this, other); }
+inline Expr Expr::operator !() const { return rec->unary("not", *this); }
+
 #endif // !AADDWRAPPER
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+#ifndef AADDSESSION
+#define AADDSESSION
+
+#include "aaddheaderlib.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Parallel sessions: runs many independent scenarios, e.g. the corners of a parameter sweep, on a pool of threads.
+ *
+ * Thread safety of the library:
+ * - The Kotlin/Native runtime can be called from any native thread; a thread is attached on its first call.
+ *   The exported symbols (libnative_symbols()) are immutable and can be shared by all threads.
+ * - A DDBuilder, and all AADD and BDD created by it, are not thread-safe. They must be used by one thread only.
+ *   Library objects of different builders do not share state, so different threads can use different builders.
+ *
+ * A session has one worker thread per core (or as given), and each worker creates its own DDBuilder on its thread.
+ * A scenario is a function that gets the builder of the worker that runs it, computes an AADD, and must not keep
+ * or pass on any DD after it returns. The session computes the range of the returned AADD and returns its bounds
+ * together with the statistics of the scenario:
+ *
+ *   AADDSession session(libnative_symbols());
+ *   std::vector<AADDSession::Scenario> corners;
+ *   for (double k : gains)
+ *       corners.push_back([k](DDBuilder& b) { return b.range(0.0, 1.0, "x").times(k); });
+ *   std::vector<ScenarioResult> results = session.run(corners);
+ *   SessionStatistics total = session.statistics();
+ *
+ * Scenarios on the same worker share its builder, which keeps the conditions and noise symbols of all of them.
+ * After scenariosPerBuilder scenarios, the worker replaces its builder by a new one to bound memory.
+ * Errors are reported by C++ exceptions in the scenario; an exception raised in the Kotlin code terminates the process.
+ */
+
+/* Result of one scenario. */
+struct ScenarioResult {
+	double min = std::numeric_limits<double>::quiet_NaN();
+	double max = std::numeric_limits<double>::quiet_NaN();
+	long lpCalls = 0;
+	long lpCallsAvoided = 0;
+	double seconds = 0.0;
+	bool ok = false;
+	std::string error;
+};
+
+/* Statistics of all scenarios that a session completed. */
+struct SessionStatistics {
+	long scenarios = 0;
+	long failed = 0;
+	long lpCalls = 0;
+	long lpCallsAvoided = 0;
+	/* Sum of the run times of the scenarios; compare with the wall-clock time for the speedup. */
+	double seconds = 0.0;
+	/* Hull of the bounds of all successful scenarios. */
+	double min = std::numeric_limits<double>::infinity();
+	double max = -std::numeric_limits<double>::infinity();
+};
+
+class AADDSession {
+public:
+	using Scenario = std::function<AADD(DDBuilder&)>;
+
+	AADDSession(libnative_ExportedSymbols* _lib, unsigned workers = std::thread::hardware_concurrency(), long _scenariosPerBuilder = 1000)
+		: lib(_lib), scenariosPerBuilder(_scenariosPerBuilder) {
+		if (workers == 0) workers = 1;
+		for (unsigned i = 0; i < workers; i++)
+			threads.emplace_back(&AADDSession::work, this);
+	}
+
+	/* Completes all submitted scenarios, then stops the workers. */
+	~AADDSession() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		available.notify_all();
+		for (std::thread& t : threads) t.join();
+	}
+
+	AADDSession(const AADDSession&) = delete;
+	AADDSession& operator=(const AADDSession&) = delete;
+
+	/* Queues a scenario; it runs on the next free worker. */
+	std::future<ScenarioResult> submit(Scenario scenario) {
+		std::shared_ptr<std::promise<ScenarioResult>> promise = std::make_shared<std::promise<ScenarioResult>>();
+		std::future<ScenarioResult> future = promise->get_future();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.push_back([this, scenario, promise](DDBuilder& builder) {
+				promise->set_value(runScenario(scenario, builder));
+			});
+		}
+		available.notify_one();
+		return future;
+	}
+
+	/* Runs all scenarios and returns their results in the same order. */
+	std::vector<ScenarioResult> run(const std::vector<Scenario>& scenarios) {
+		std::vector<std::future<ScenarioResult>> futures;
+		futures.reserve(scenarios.size());
+		for (const Scenario& scenario : scenarios) futures.push_back(submit(scenario));
+		std::vector<ScenarioResult> results;
+		results.reserve(scenarios.size());
+		for (std::future<ScenarioResult>& future : futures) results.push_back(future.get());
+		return results;
+	}
+
+	SessionStatistics statistics() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return total;
+	}
+
+	unsigned workers() const {
+		return static_cast<unsigned>(threads.size());
+	}
+
+private:
+	using Job = std::function<void(DDBuilder&)>;
+
+	libnative_ExportedSymbols* lib;
+	long scenariosPerBuilder;
+	std::vector<std::thread> threads;
+	std::deque<Job> jobs;
+	mutable std::mutex mutex;
+	std::condition_variable available;
+	bool stopping = false;
+	SessionStatistics total;
+
+	void work() {
+		std::unique_ptr<DDBuilder> builder;
+		long used = 0;
+		for (;;) {
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				available.wait(lock, [this] { return stopping || !jobs.empty(); });
+				if (jobs.empty()) return;
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+			if (!builder || used >= scenariosPerBuilder) {
+				builder.reset();
+				builder.reset(new DDBuilder(lib));
+				used = 0;
+			}
+			used++;
+			job(*builder);
+		}
+	}
+
+	ScenarioResult runScenario(const Scenario& scenario, DDBuilder& builder) {
+		ScenarioResult result;
+		long calls = builder.lpCalls();
+		long avoided = builder.lpCallsAvoided();
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		try {
+			AADD value = scenario(builder);
+			value.getRange();
+			result.min = value.get_min();
+			result.max = value.get_max();
+			result.ok = true;
+		} catch (const std::exception& e) {
+			result.error = e.what();
+		} catch (...) {
+			result.error = "unknown exception in scenario";
+		}
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.lpCalls = builder.lpCalls() - calls;
+		result.lpCallsAvoided = builder.lpCallsAvoided() - avoided;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		total.scenarios++;
+		total.lpCalls += result.lpCalls;
+		total.lpCallsAvoided += result.lpCallsAvoided;
+		total.seconds += result.seconds;
+		if (result.ok) {
+			total.min = std::min(total.min, result.min);
+			total.max = std::max(total.max, result.max);
+		} else
+			total.failed++;
+		return result;
+	}
+};
+
+#endif // !AADDSESSION
@@ -5,6 +5,7 @@ plugins {
     alias(libs.plugins.kotlin.multiplatform)
     alias(libs.plugins.kotlin.serialization)
     alias(libs.plugins.dokka)
+    alias(libs.plugins.kotlinx.benchmark)
 
     id("idea")
     id("maven-publish")
@@ -17,7 +18,9 @@ repositories {
 
 kotlin {
     jvmToolchain(21)
-    jvm {}
+    jvm {
+        compilations.create("benchmark") { associateWith(this@jvm.compilations.getByName("main")) }
+    }
 
     val hostOs = System.getProperty("os.name")
     val procArch = System.getProperty("os.arch")
@@ -27,7 +30,6 @@ kotlin {
     val isArm64 = procArch.startsWith("aarch64")
     val isX64 = procArch.startsWith("x86_64") || procArch.startsWith("x64") || procArch.startsWith("amd64")
 
-    @Suppress("UNUSED_VARIABLE")
     val nativeTarget = when {
         isMacOs -> {
             when {
@@ -51,6 +53,7 @@ kotlin {
 
         else -> throw GradleException("Host OS is not supported in Kotlin/Native.")
     }
+    nativeTarget.compilations.create("benchmark") { associateWith(nativeTarget.compilations.getByName("main")) }
 
     sourceSets {
         val commonMain by getting {
@@ -68,12 +71,49 @@ kotlin {
         val nativeTest by getting {
             dependencies { implementation(kotlin("test")) }
         }
+        // Benchmarks of the library, see the benchmark block below; they are not part of the published artifacts.
+        val commonBenchmark by creating {
+            dependencies {
+                implementation(libs.kotlinx.benchmark.runtime)
+                implementation(libs.kotlinx.serialization.json)
+            }
+        }
+        val jvmBenchmark by getting { dependsOn(commonBenchmark) }
+        val nativeBenchmark by getting { dependsOn(commonBenchmark) }
     }
     sourceSets.commonTest.dependencies {
         implementation(kotlin("test"))
     }
 }
 
+/*
+ * Benchmarks of the core engines: `gradle benchmark` runs them on the JVM and native targets,
+ * `gradle smokeBenchmark` runs a short version. The results are written as JSON to
+ * build/reports/benchmarks/<configuration>/<timestamp>/ for comparison between releases.
+ */
+benchmark {
+    targets {
+        register("jvmBenchmark")
+        register("nativeBenchmark")
+    }
+    configurations {
+        named("main") {
+            warmups = 3
+            iterations = 5
+            iterationTime = 1
+            iterationTimeUnit = "s"
+            reportFormat = "json"
+        }
+        register("smoke") {
+            warmups = 1
+            iterations = 2
+            iterationTime = 200
+            iterationTimeUnit = "ms"
+            reportFormat = "json"
+        }
+    }
+}
+
 val javadocJar by tasks.registering(Jar::class) {
     group = JavaBasePlugin.DOCUMENTATION_GROUP
     description = "Assembles Javadoc JAR"
@@ -0,0 +1,37 @@
+package benchmarks
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.plus
+import io.github.tukcps.aadd.values.real.aa.times
+import kotlinx.benchmark.*
+
+/**
+ * Affine arithmetic on two forms that share half of their noise symbols.
+ * Multiplication adds a new noise symbol for the nonlinear part.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.NANOSECONDS)
+open class AffineFormBenchmark {
+
+    @Param("4", "32", "256")
+    var symbols = 0
+
+    private lateinit var a: AffineForm
+    private lateinit var b: AffineForm
+
+    @Setup
+    fun setup() {
+        val builder = DDBuilder(benchmarkSettings())
+        val inputs = List(2 * symbols) { AffineForm.range(builder, 0.0..1.0 + it, "x$it") }
+        a = inputs.subList(0, symbols).reduce { s, x -> s + x }
+        b = inputs.subList(symbols / 2, symbols / 2 + symbols).reduce { s, x -> s + x * 0.5 }
+    }
+
+    @Benchmark
+    fun add(): AffineForm = a + b
+
+    @Benchmark
+    fun multiply(): AffineForm = a * b
+}
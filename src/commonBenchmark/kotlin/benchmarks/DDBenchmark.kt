@@ -0,0 +1,54 @@
+package benchmarks
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilder.RealMath.times
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.values.real.ia.RealRange
+import kotlinx.benchmark.*
+
+/**
+ * Operations on DD: apply of arithmetic, comparisons, and bounds by the LP solver.
+ *
+ * Comparisons create new conditions, and getRange keeps the results of the LP solver in the
+ * [io.github.tukcps.aadd.dd.LpResultCache] of the builder and in the root.
+ * Both are therefore measured on a new builder in each invocation; [build] measures the creation of
+ * the inputs alone, so that its time can be subtracted.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.MICROSECONDS)
+open class DDBenchmark {
+
+    @Param("2", "4", "6")
+    var steps = 0
+
+    private lateinit var a: AADD
+    private lateinit var b: AADD
+
+    @Setup
+    fun setup() {
+        with(DDBuilder(benchmarkSettings())) {
+            a = piecewise(steps, "a")
+            b = piecewise(steps, "b")
+        }
+    }
+
+    @Benchmark
+    fun applyAdd(): AADD = a + b
+
+    @Benchmark
+    fun applyMultiply(): AADD = a * b
+
+    @Benchmark
+    fun build(): AADD = DDBuilder(benchmarkSettings()).piecewise(steps, "a")
+
+    @Benchmark
+    fun compare(): BDD = with(DDBuilder(benchmarkSettings())) {
+        piecewise(steps, "a") greaterThan piecewise(steps, "b")
+    }
+
+    @Benchmark
+    fun getRange(): RealRange = DDBuilder(benchmarkSettings()).piecewise(steps, "a").getRange()
+}
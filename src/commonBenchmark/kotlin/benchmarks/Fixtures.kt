@@ -0,0 +1,30 @@
+package benchmarks
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilder.RealMath.times
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+
+/*
+ * Inputs shared by the benchmarks; all are deterministic, so that results of releases can be compared.
+ */
+
+/** Settings of the benchmarks: sequential, and without the operation cache, so that each operation is computed. */
+internal fun benchmarkSettings() = DDBuilderSettings(lpParallelWorkers = 1, ddOperationCacheSize = 0)
+
+/**
+ * A piecewise AADD of the inputs x and u, as a loop with a branch creates it:
+ * each step compares the state with a bound, so the AADD has up to 2^steps leaves
+ * whose LP problems have the conditions of their path.
+ */
+internal fun DDBuilder.piecewise(steps: Int, name: String): AADD {
+    val x = real(0.0..1.0, "${name}x")
+    val u = real(-0.5..0.5, "${name}u")
+    var y = x
+    for (k in 0 until steps) {
+        val c = y + u * 0.5
+        y = (c greaterThan 0.25 * (k + 1)).ite(y * 0.5 + u, y + 0.1)
+    }
+    return y
+}
@@ -0,0 +1,80 @@
+package benchmarks
+
+import io.github.tukcps.aadd.lpsolver.*
+import kotlinx.benchmark.*
+import kotlin.random.Random
+
+/**
+ * Compares the simplex engines on LP problems as callLPSolver creates them for a leaf:
+ * noise symbols in [-1, 1], one sparse constraint per condition on the path, and the affine form
+ * of the leaf as function. Each invocation solves the same set of problems.
+ * The CLRS tableau of [solve] gets the bounds of the symbols as two rows each, as it did before.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.MICROSECONDS)
+open class LpSolverBenchmark {
+
+    @Param("4", "16", "32")
+    var pathLength = 0
+
+    private val symbols = 64
+    private val termsPerCondition = 4
+    private val termsPerLeaf = 16
+    private val problems = 50
+
+    private class Problem(val variables: List<LpVariable>, val constraints: List<LpConstraint>, val function: LpExpression)
+
+    private lateinit var instances: List<Problem>
+
+    @Setup
+    fun setup() {
+        val random = Random(pathLength)
+        instances = List(problems) { problem(random) }
+    }
+
+    private fun problem(random: Random): Problem {
+        val variables = List(symbols) { LpVariable("e$it", canBeNegative = true) }
+        fun sparse(terms: Int) = LpExpression(
+            List(terms) { variables[random.nextInt(symbols)] }.associateWith { random.nextDouble(-1.0, 1.0) }
+        )
+        // Conditions with a positive constant are feasible at the origin.
+        val constraints = List(pathLength) {
+            val sign = if (random.nextBoolean()) LpConstraintSign.GREATER_OR_EQUAL else LpConstraintSign.LESS_OR_EQUAL
+            val rhs = if (sign == LpConstraintSign.GREATER_OR_EQUAL) -random.nextDouble(0.1, 1.0) else random.nextDouble(0.1, 1.0)
+            LpConstraint(sparse(termsPerCondition), sign, rhs)
+        }
+        return Problem(variables, constraints, sparse(termsPerLeaf))
+    }
+
+    private fun boxRows(variables: List<LpVariable>) = variables.flatMap {
+        listOf(
+            LpConstraint(LpExpression(mapOf(it to 1.0)), LpConstraintSign.LESS_OR_EQUAL, 1.0),
+            LpConstraint(LpExpression(mapOf(it to 1.0)), LpConstraintSign.GREATER_OR_EQUAL, -1.0)
+        )
+    }
+
+    private fun solveAll(engine: LpSolverEngine): Double {
+        var sum = 0.0
+        for (p in instances) sum += (solveMinMax(p.constraints, p.function, engine = engine) as SolvedMinMax).max
+        return sum
+    }
+
+    @Benchmark
+    fun dense(): Double = solveAll(LpSolverEngine.DENSE)
+
+    @Benchmark
+    fun sparse(): Double = solveAll(LpSolverEngine.SPARSE)
+
+    @Benchmark
+    fun tableauWithBoundRows(): Double {
+        var sum = 0.0
+        for (p in instances) {
+            val constraints = boxRows(p.variables) + p.constraints
+            val max = solve(LpProblem(p.variables, constraints, LpFunction(p.function, LpFunctionOptimization.MAXIMIZE)))
+            solve(LpProblem(p.variables, constraints, LpFunction(p.function, LpFunctionOptimization.MINIMIZE)))
+            sum += (max as Solved).functionValue
+        }
+        return sum
+    }
+}
@@ -0,0 +1,50 @@
+package benchmarks
+
+import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.NoiseTerms
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import kotlinx.benchmark.*
+
+/**
+ * Compares the sorted sparse vector of noise terms with the hash maps used before,
+ * on the addition of two vectors that share a third of their noise symbols.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.NANOSECONDS)
+open class NoiseTermsBenchmark {
+
+    @Param("16", "256")
+    var terms = 0
+
+    private lateinit var a: NoiseTerms
+    private lateinit var b: NoiseTerms
+    private lateinit var mapA: HashMap<Long, Double>
+    private lateinit var mapB: HashMap<Long, Double>
+
+    @Setup
+    fun setup() {
+        a = NoiseTerms()
+        b = NoiseTerms()
+        for (i in 0 until terms) {
+            a[i.toLong() * 2] = 1.0 + i
+            b[i.toLong() * 3] = 0.5 + i
+        }
+        mapA = HashMap(a)
+        mapB = HashMap(b)
+    }
+
+    @Benchmark
+    fun addSparse(): NoiseTerms = NoiseTerms.add(a, b)
+
+    /** The add operation as it was implemented on hash maps. */
+    @Benchmark
+    fun addHashMap(): HashMap<Long, Double> {
+        val newXi = HashMap<Long, Double>(2 * 300)
+        for (i in mapA.keys + mapB.keys) {
+            val sum = AffineForm.math.add(mapA[i] ?: 0.0, mapB[i] ?: 0.0, Rounding.AWAY)
+            if (sum != 0.0) newXi[i] = sum
+        }
+        return newXi
+    }
+}
@@ -0,0 +1,63 @@
+package benchmarks
+
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingBackend
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
+import kotlinx.benchmark.*
+import kotlin.random.Random
+
+/**
+ * Compares the throughput of the rounding backends, for single operations and for operations on arrays.
+ * The hardware backend sets the rounding mode for each single operation, but only once per array.
+ * Where it is not available, e.g. on the JVM, both use the software rounding.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.NANOSECONDS)
+open class RoundingBackendBenchmark {
+
+    @Param("SOFTWARE", "HARDWARE")
+    var backend = ""
+
+    private val n = 64
+    private lateinit var math: RoundingMath
+    private lateinit var x: DoubleArray
+    private lateinit var y: DoubleArray
+    private lateinit var result: DoubleArray
+
+    @Setup
+    fun setup() {
+        math = RoundingBackend.valueOf(backend).math
+        val random = Random(16)
+        x = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        y = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        result = DoubleArray(n)
+    }
+
+    @Benchmark
+    fun addScalar(): DoubleArray {
+        for (k in 0 until n) result[k] = math.add(x[k], y[k], Rounding.UP)
+        return result
+    }
+
+    @Benchmark
+    fun mulScalar(): DoubleArray {
+        for (k in 0 until n) result[k] = math.mul(x[k], y[k], Rounding.UP)
+        return result
+    }
+
+    @Benchmark
+    fun addArray(): DoubleArray {
+        math.add(x, y, result, n, Rounding.UP)
+        return result
+    }
+
+    @Benchmark
+    fun mulArray(): DoubleArray {
+        math.mul(x, 0.1, result, n, Rounding.UP)
+        return result
+    }
+
+    @Benchmark
+    fun absSumArray(): Double = math.absSum(x, n, Rounding.UP)
+}
@@ -0,0 +1,80 @@
+package benchmarks
+
+import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingKernels
+import kotlinx.benchmark.*
+import kotlin.math.abs
+import kotlin.random.Random
+
+/**
+ * Compares the array kernels with directed rounding with the scalar functions of [IEEE754RoundingMath],
+ * for arrays of the size of typical noise terms and larger ones.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.NANOSECONDS)
+open class RoundingKernelsBenchmark {
+
+    @Param("16", "256", "4096")
+    var n = 0
+
+    private val math = IEEE754RoundingMath
+    private lateinit var x: DoubleArray
+    private lateinit var y: DoubleArray
+    private lateinit var result: DoubleArray
+
+    @Setup
+    fun setup() {
+        val random = Random(15)
+        x = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        y = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        result = DoubleArray(n)
+    }
+
+    @Benchmark
+    fun addScalar(): DoubleArray {
+        for (k in 0 until n) result[k] = math.add(x[k], y[k], Rounding.AWAY)
+        return result
+    }
+
+    @Benchmark
+    fun addKernel(): DoubleArray {
+        RoundingKernels.add(x, y, result, n, Rounding.AWAY)
+        return result
+    }
+
+    @Benchmark
+    fun mulScalar(): DoubleArray {
+        for (k in 0 until n) result[k] = math.mul(x[k], 0.1, Rounding.AWAY)
+        return result
+    }
+
+    @Benchmark
+    fun mulKernel(): DoubleArray {
+        RoundingKernels.mul(x, 0.1, result, n, Rounding.AWAY)
+        return result
+    }
+
+    @Benchmark
+    fun fmaScalar(): DoubleArray {
+        for (k in 0 until n) result[k] = math.add(math.mul(x[k], 0.1, Rounding.UP), y[k], Rounding.UP)
+        return result
+    }
+
+    @Benchmark
+    fun fmaKernel(): DoubleArray {
+        RoundingKernels.fma(x, 0.1, y, result, n, Rounding.UP)
+        return result
+    }
+
+    @Benchmark
+    fun absSumScalar(): Double {
+        var sum = 0.0
+        for (k in 0 until n) sum = math.add(sum, abs(x[k]), Rounding.UP)
+        return sum
+    }
+
+    @Benchmark
+    fun absSumKernel(): Double = RoundingKernels.absSum(x, n, Rounding.UP)
+}
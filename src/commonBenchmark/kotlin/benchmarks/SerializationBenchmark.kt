@@ -0,0 +1,42 @@
+package benchmarks
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.dao.*
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.DD
+import kotlinx.benchmark.*
+
+/** Writing and reading an AADD in the binary format and as JSON; reading creates the nodes in the same builder. */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(BenchmarkTimeUnit.MICROSECONDS)
+open class SerializationBenchmark {
+
+    @Param("4", "8")
+    var steps = 0
+
+    private lateinit var builder: DDBuilder
+    private lateinit var dd: AADD
+    private lateinit var binary: ByteArray
+    private lateinit var text: String
+
+    @Setup
+    fun setup() {
+        builder = DDBuilder(benchmarkSettings())
+        dd = builder.piecewise(steps, "a")
+        binary = dd.toBinary()
+        text = dd.toDAO().toJson()
+    }
+
+    @Benchmark
+    fun writeBinary(): ByteArray = dd.toBinary()
+
+    @Benchmark
+    fun readBinary(): DD<*> = builder.fromBinary(binary)
+
+    @Benchmark
+    fun writeJson(): String = dd.toDAO().toJson()
+
+    @Benchmark
+    fun readJson(): AADD = json.decodeFromString<AaddDAO>(text).toAADD(builder)
+}
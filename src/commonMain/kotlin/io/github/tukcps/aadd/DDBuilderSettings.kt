@@ -1,6 +1,9 @@
 package io.github.tukcps.aadd
 
 import io.github.tukcps.aadd.DDBuilder.ApproximationScheme
+import io.github.tukcps.aadd.dd.ReorderingMethod
+import io.github.tukcps.aadd.lpsolver.LpSolverEngine
+import io.github.tukcps.aadd.values.real.rounding.RoundingBackend
 import kotlinx.serialization.Serializable
 
 /**
@@ -11,6 +14,20 @@ import kotlinx.serialization.Serializable
  * the size of the DD; increases speed, reduces accuracy.
  * @param affineFormMaxNumberOfNoiseSymbols AADD library uses (constrained) affine forms that use symbols to models linear dependencies.
  * maxSymbols is the maximum size for the number of symbols; if the number is reached, symbols are reduced to have that size.
+ * @param ddUniqueTable whether the builder shares isomorphic nodes via a unique table (hash-consing).
+ * @param ddOperationCacheSize number of entries of the cache for results of operations on DD; 0 disables the cache.
+ * @param lpIncremental whether getRange solves the LP problems of leaves with a shared prefix of the path incrementally.
+ * @param lpSolverEngine the simplex used if the LP problem of a leaf is solved from scratch, i.e. without lpIncremental.
+ * @param lpResultCacheSize maximum number of LP results kept by the builder for reuse by other leaves; 0 disables the cache.
+ * @param lpBoundPropagation whether bound propagation over the path conditions decides leaves before the LP solver is called.
+ * @param lpParallelWorkers number of workers that compute the bounds of leaves in getRange; 1 is sequential.
+ * @param lpParallelCutoff number of paths of a subgraph below which it is traversed sequentially by one worker.
+ * @param roundingBackend directed rounding of the affine arithmetic: error-free transformations, or the FPU on native targets.
+ * @param noiseReclaimInterval number of noise symbols created after which unused ones are reclaimed when a real variable is created; 0 disables it.
+ * @param conditionsCollectInterval number of conditions created after which unreferenced ones are removed at the next IF or new real variable; 0 disables it.
+ * @param ddReorderThreshold number of nodes of the unique table above which the conditions are reordered at the next IF or new real variable; 0 disables it.
+ * @param ddReorderMethod the method used for reordering the conditions.
+ * @param ddMaxLeaves maximum number of leaves of an AADD after an assignment; leaves are merged soundly above it; 0 disables it.
  */
 @Serializable
 data class DDBuilderSettings(
@@ -18,7 +35,22 @@ data class DDBuilderSettings(
     var ddJoinLeavesThreshold:Double = 0.001,
     var affineFormMaxNumberOfNoiseSymbols: Int = 64,
     var lpCallThreshold: Double = 0.001,
+    @Deprecated("Noise terms are stored as sorted sparse vectors that grow as needed; the setting has no effect")
     var affineFormHashMapSize: Int = 300,
     @Deprecated("Approximation scheme will be selected on split ranges depending on numerical properties")
     var affineFormLinearizationScheme: ApproximationScheme = ApproximationScheme.MinRange,
+    var ddUniqueTable: Boolean = true,
+    var ddOperationCacheSize: Int = 1 shl 16,
+    var lpIncremental: Boolean = true,
+    var lpSolverEngine: LpSolverEngine = LpSolverEngine.DENSE,
+    var lpResultCacheSize: Int = 1 shl 14,
+    var lpBoundPropagation: Boolean = true,
+    var lpParallelWorkers: Int = 1,
+    var lpParallelCutoff: Int = 64,
+    var roundingBackend: RoundingBackend = RoundingBackend.SOFTWARE,
+    var noiseReclaimInterval: Int = 0,
+    var conditionsCollectInterval: Int = 0,
+    var ddReorderThreshold: Int = 0,
+    var ddReorderMethod: ReorderingMethod = ReorderingMethod.SIFTING,
+    var ddMaxLeaves: Int = 0,
 )
@@ -0,0 +1,317 @@
+@file:OptIn(ExperimentalAtomicApi::class)
+
+package io.github.tukcps.aadd
+
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.DD
+import io.github.tukcps.aadd.dd.IDD
+import io.github.tukcps.aadd.dd.StrDD
+import kotlinx.serialization.Serializable
+import kotlin.concurrent.atomics.AtomicLong
+import kotlin.concurrent.atomics.ExperimentalAtomicApi
+import kotlin.time.TimeSource
+
+/**
+ * ## Statistics of a builder
+ *
+ * Counters of the work done by a [DDBuilder], and a histogram of the time of the LP solver,
+ * to find hot spots without a profiler. The counters are atomic, as the workers of a parallel
+ * getRange update them concurrently; each event costs one or a few atomic additions.
+ *
+ * [snapshot] returns a copy of all values; [reset] sets them to zero. Both can be called while
+ * the builder is in use; a snapshot taken during a parallel getRange might then be partially updated.
+ * For periodic reports, [snapshotAndReset] takes each value and sets it to zero atomically,
+ * so that no event between a snapshot and a reset is lost.
+ */
+class DDStatistics internal constructor() {
+
+    private val aaddLeaves = AtomicLong(0L)
+    private val aaddInternals = AtomicLong(0L)
+    private val bddInternals = AtomicLong(0L)
+    private val iddLeaves = AtomicLong(0L)
+    private val iddInternals = AtomicLong(0L)
+    private val strDDLeaves = AtomicLong(0L)
+    private val strDDInternals = AtomicLong(0L)
+    private val peakNodes = AtomicLong(0L)
+    private val applyCalls = AtomicLong(0L)
+    private val applyComputed = AtomicLong(0L)
+    private val leafMerges = AtomicLong(0L)
+    private val leafMergeLoss = AtomicLong(0.0.toRawBits())
+    private val lpSolves = AtomicLong(0L)
+    private val lpAvoided = AtomicLong(0L)
+    private val lpPivots = AtomicLong(0L)
+    private val noiseSymbolsCreated = AtomicLong(0L)
+    private val noiseSymbolsCompressed = AtomicLong(0L)
+    private val noiseSymbolsReclaimed = AtomicLong(0L)
+    private val conditionsCreated = AtomicLong(0L)
+    private val conditionsCollected = AtomicLong(0L)
+    private val lpTime = TimeHistogram()
+
+    /** A node was created by a factory of the builder; size is the number of entries of the unique table. */
+    internal fun nodeCreated(node: DD<*>, size: Int) {
+        when (node) {
+            is AADD.Leaf -> aaddLeaves
+            is AADD.Internal -> aaddInternals
+            is BDD.Internal -> bddInternals
+            is IDD.Leaf -> iddLeaves
+            is IDD.Internal -> iddInternals
+            is StrDD.Leaf -> strDDLeaves
+            is StrDD.Internal -> strDDInternals
+            else -> null
+        }?.incrementAndFetch()
+        peakNodes.max(size.toLong())
+    }
+
+    /** An operation was applied to an internal node; computed if its result was not in the operation cache. */
+    internal fun applied(computed: Boolean) {
+        applyCalls.incrementAndFetch()
+        if (computed) applyComputed.incrementAndFetch()
+    }
+
+    /** A leaf was merged, with the increase of the width of its range. */
+    internal fun leafMerged(loss: Double) {
+        leafMerges.incrementAndFetch()
+        leafMergeLoss.add(loss)
+    }
+
+    /** The LP problem of a leaf was solved, with the number of pivots, from the time mark taken before. */
+    internal fun lpSolved(start: TimeSource.Monotonic.ValueTimeMark, pivots: Long) {
+        lpTime.record(start.elapsedNow().inWholeNanoseconds)
+        lpSolves.incrementAndFetch()
+        lpPivots.addAndFetch(pivots)
+    }
+
+    /** The LP problem of a leaf was decided without the LP solver, by bound propagation. */
+    internal fun lpAvoided() {
+        lpAvoided.incrementAndFetch()
+    }
+
+    internal fun noiseSymbolCreated() {
+        noiseSymbolsCreated.incrementAndFetch()
+    }
+
+    /** Noise symbols were merged into one. */
+    internal fun noiseSymbolsCompressed(count: Int) {
+        noiseSymbolsCompressed.addAndFetch(count.toLong())
+    }
+
+    internal fun noiseSymbolsReclaimed(count: Int) {
+        noiseSymbolsReclaimed.addAndFetch(count.toLong())
+    }
+
+    internal fun conditionCreated() {
+        conditionsCreated.incrementAndFetch()
+    }
+
+    internal fun conditionsCollected(count: Int) {
+        conditionsCollected.addAndFetch(count.toLong())
+    }
+
+    /** Number of LP solves, for [DDBuilder.lpCalls]. */
+    internal var lpCalls: Long
+        get() = lpSolves.load()
+        set(value) = lpSolves.store(value)
+
+    /** Number of leaves decided by bound propagation, for [DDBuilder.lpCallsAvoided]. */
+    internal var lpCallsAvoided: Long
+        get() = lpAvoided.load()
+        set(value) = lpAvoided.store(value)
+
+    /** Number of leaves merged, for [DDBuilder.leafMerges]. */
+    internal var leafMergeCount: Long
+        get() = leafMerges.load()
+        set(value) = leafMerges.store(value)
+
+    /** Sum of the losses of the merged leaves, for [DDBuilder.leafMergeLoss]. */
+    internal var leafMergeLossSum: Double
+        get() = Double.fromBits(leafMergeLoss.load())
+        set(value) = leafMergeLoss.store(value.toRawBits())
+
+    /** @return a copy of the current values. */
+    fun snapshot() = read(reset = false)
+
+    /** @return a copy of the current values, each of which is set to zero in the same atomic step. */
+    fun snapshotAndReset() = read(reset = true)
+
+    private fun read(reset: Boolean) = Snapshot(
+        aaddLeaves = aaddLeaves.read(reset),
+        aaddInternals = aaddInternals.read(reset),
+        bddInternals = bddInternals.read(reset),
+        iddLeaves = iddLeaves.read(reset),
+        iddInternals = iddInternals.read(reset),
+        strDDLeaves = strDDLeaves.read(reset),
+        strDDInternals = strDDInternals.read(reset),
+        peakNodes = peakNodes.read(reset),
+        applyCalls = applyCalls.read(reset),
+        applyComputed = applyComputed.read(reset),
+        leafMerges = leafMerges.read(reset),
+        leafMergeLoss = Double.fromBits(leafMergeLoss.read(reset)),
+        lpSolves = lpSolves.read(reset),
+        lpAvoided = lpAvoided.read(reset),
+        lpPivots = lpPivots.read(reset),
+        noiseSymbolsCreated = noiseSymbolsCreated.read(reset),
+        noiseSymbolsCompressed = noiseSymbolsCompressed.read(reset),
+        noiseSymbolsReclaimed = noiseSymbolsReclaimed.read(reset),
+        conditionsCreated = conditionsCreated.read(reset),
+        conditionsCollected = conditionsCollected.read(reset),
+        lpTime = lpTime.read(reset)
+    )
+
+    /** Sets all values to zero. */
+    fun reset() {
+        for (counter in listOf(aaddLeaves, aaddInternals, bddInternals, iddLeaves, iddInternals, strDDLeaves,
+            strDDInternals, peakNodes, applyCalls, applyComputed, leafMerges, leafMergeLoss, lpSolves, lpAvoided, lpPivots,
+            noiseSymbolsCreated, noiseSymbolsCompressed, noiseSymbolsReclaimed, conditionsCreated, conditionsCollected))
+            counter.store(0L)
+        lpTime.reset()
+    }
+
+    override fun toString(): String = snapshot().toString()
+
+    /**
+     * The values of the statistics at one point in time.
+     * @param aaddLeaves number of AADD leaves created; the same for the other types of nodes.
+     *   BDD leaves are constants of the builder and not counted.
+     * @param peakNodes maximum number of nodes in the unique table, including nodes not yet collected; 0 without unique table.
+     * @param applyCalls number of operations on internal nodes, i.e. the steps of the apply algorithms.
+     * @param applyComputed number of the apply steps that were computed, i.e. not found in the operation cache.
+     * @param leafMerges number of leaves merged to bound the size of AADD, see [io.github.tukcps.aadd.dd.bounded].
+     * @param leafMergeLoss sum of the increase of the width of the ranges of the merged leaves.
+     * @param lpSolves number of leaves whose LP problem was solved by an LP solver.
+     * @param lpAvoided number of leaves whose LP problem was decided by bound propagation instead.
+     * @param lpPivots number of pivots of the LP solvers for the solved leaves.
+     * @param noiseSymbolsCreated number of noise symbols created, including those for approximation errors.
+     * @param noiseSymbolsCompressed number of noise symbols of affine forms merged into new ones, see [io.github.tukcps.aadd.values.real.aa.NoiseVariables.compressGarbageVariables].
+     * @param noiseSymbolsReclaimed number of noise symbols reclaimed, see [DDBuilder.reclaimNoiseSymbols].
+     * @param conditionsCreated number of conditions created.
+     * @param conditionsCollected number of conditions removed, see [DDBuilder.collectConditions].
+     * @param lpTime histogram of the time of the LP solver per solved leaf.
+     */
+    @Serializable
+    data class Snapshot(
+        val aaddLeaves: Long = 0L,
+        val aaddInternals: Long = 0L,
+        val bddInternals: Long = 0L,
+        val iddLeaves: Long = 0L,
+        val iddInternals: Long = 0L,
+        val strDDLeaves: Long = 0L,
+        val strDDInternals: Long = 0L,
+        val peakNodes: Long = 0L,
+        val applyCalls: Long = 0L,
+        val applyComputed: Long = 0L,
+        val leafMerges: Long = 0L,
+        val leafMergeLoss: Double = 0.0,
+        val lpSolves: Long = 0L,
+        val lpAvoided: Long = 0L,
+        val lpPivots: Long = 0L,
+        val noiseSymbolsCreated: Long = 0L,
+        val noiseSymbolsCompressed: Long = 0L,
+        val noiseSymbolsReclaimed: Long = 0L,
+        val conditionsCreated: Long = 0L,
+        val conditionsCollected: Long = 0L,
+        val lpTime: TimeHistogram.Snapshot = TimeHistogram.Snapshot()
+    ) {
+        /** Number of nodes created of all types. */
+        val nodesCreated: Long
+            get() = aaddLeaves + aaddInternals + bddInternals + iddLeaves + iddInternals + strDDLeaves + strDDInternals
+
+        /**
+         * The values as an array in the order of the parameters, followed by those of [lpTime];
+         * the layout of the struct AADDStatistics of the C++ wrapper. [leafMergeLoss] is given by its bits.
+         */
+        fun toLongArray(): LongArray = longArrayOf(
+            aaddLeaves, aaddInternals, bddInternals, iddLeaves, iddInternals, strDDLeaves, strDDInternals,
+            peakNodes, applyCalls, applyComputed, leafMerges, leafMergeLoss.toRawBits(), lpSolves, lpAvoided,
+            lpPivots, noiseSymbolsCreated, noiseSymbolsCompressed, noiseSymbolsReclaimed, conditionsCreated, conditionsCollected,
+            lpTime.count, lpTime.totalNanos, lpTime.maxNanos
+        ) + lpTime.counts.toLongArray()
+    }
+}
+
+/**
+ * Histogram of durations in buckets of powers of two:
+ * bucket 0 counts durations below 1 ns, bucket k durations in [2^(k-1), 2^k) ns, the last bucket all longer ones.
+ */
+class TimeHistogram internal constructor() {
+    private val buckets = Array(BUCKETS) { AtomicLong(0L) }
+    private val count = AtomicLong(0L)
+    private val total = AtomicLong(0L)
+    private val max = AtomicLong(0L)
+
+    internal fun record(nanos: Long) {
+        val n = nanos.coerceAtLeast(0L)
+        buckets[(64 - n.countLeadingZeroBits()).coerceAtMost(BUCKETS - 1)].incrementAndFetch()
+        count.incrementAndFetch()
+        total.addAndFetch(n)
+        max.max(n)
+    }
+
+    internal fun reset() {
+        buckets.forEach { it.store(0L) }
+        count.store(0L)
+        total.store(0L)
+        max.store(0L)
+    }
+
+    fun snapshot() = read(reset = false)
+
+    /** The values, each of which is set to zero if reset holds. */
+    internal fun read(reset: Boolean) =
+        Snapshot(buckets.map { it.read(reset) }, count.read(reset), total.read(reset), max.read(reset))
+
+    /**
+     * @param counts number of durations per bucket.
+     * @param count number of durations.
+     * @param totalNanos sum of the durations in ns.
+     * @param maxNanos maximum of the durations in ns.
+     */
+    @Serializable
+    data class Snapshot(
+        val counts: List<Long> = List(BUCKETS) { 0L },
+        val count: Long = 0L,
+        val totalNanos: Long = 0L,
+        val maxNanos: Long = 0L
+    ) {
+        /** Mean duration in ns; 0.0 if there is none. */
+        val meanNanos: Double
+            get() = if (count == 0L) 0.0 else totalNanos.toDouble() / count.toDouble()
+
+        /** Upper bound of the bucket that contains the q-quantile of the durations, in ns; 0 if there is none. */
+        fun quantileNanos(q: Double): Long {
+            require(q in 0.0..1.0) { "quantile must be in [0, 1]" }
+            if (count == 0L) return 0L
+            val rank = maxOf(1L, kotlin.math.ceil(q * count).toLong())
+            var sum = 0L
+            for ((k, n) in counts.withIndex()) {
+                sum += n
+                if (sum >= rank) return if (k == counts.size - 1) maxNanos else minOf(1L shl k, maxNanos)
+            }
+            return maxNanos
+        }
+    }
+
+    companion object {
+        /** Number of buckets; the last one starts at 2^38 ns, about 4.6 minutes. */
+        const val BUCKETS = 40
+    }
+}
+
+/** The value, which is set to zero in the same atomic step if reset holds. */
+private fun AtomicLong.read(reset: Boolean): Long = if (reset) exchange(0L) else load()
+
+/** Adds v to the value, which holds the bits of a Double. */
+private fun AtomicLong.add(v: Double) {
+    while (true) {
+        val current = load()
+        if (compareAndSet(current, (Double.fromBits(current) + v).toRawBits())) return
+    }
+}
+
+/** Sets the value to the maximum of the value and v. */
+private fun AtomicLong.max(v: Long) {
+    while (true) {
+        val current = load()
+        if (v <= current || compareAndSet(current, v)) return
+    }
+}
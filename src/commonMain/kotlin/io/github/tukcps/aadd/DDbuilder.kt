@@ -14,9 +14,12 @@ import io.github.tukcps.aadd.values.integer.IntegerRange
 import io.github.tukcps.aadd.values.integer.LongBound
 import io.github.tukcps.aadd.values.real.DoubleBound
 import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.NoiseTerms
 import io.github.tukcps.aadd.values.real.aa.NoiseVariables
 import io.github.tukcps.aadd.values.real.ia.RealRange
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
 import io.github.tukcps.aadd.values.real.toDoubleBound
+import kotlinx.coroutines.sync.Mutex
 import kotlinx.serialization.json.Json
 import kotlin.jvm.JvmName
 
@@ -75,6 +78,87 @@ class DDBuilder(
     @Deprecated("Replace with conditions", ReplaceWith("conditions"))
     val conds: Conditions get() = conditions
 
+    /**
+     * Unique table that makes nodes created by this builder canonical (hash-consing).
+     */
+    internal val uniqueTable = UniqueTable()
+
+    /**
+     * Cache for the results of operations on DD (computed table), with hit/miss statistics.
+     */
+    val operationCache = OperationCache(this)
+
+    /**
+     * Cache for the results of the LP solver, shared by all leaves with the same path conditions, with hit/miss statistics.
+     */
+    val lpResultCache = LpResultCache(this)
+
+    /**
+     * Guards the [lpResultCache] and the results per path of an AADD during concurrent getRange().
+     */
+    internal val lpResultLock = Mutex()
+
+    /**
+     * Discards the results of the LP solver per path, in the [lpResultCache] and in the roots of the AADD,
+     * as they are keyed by the indexes of the conditions.
+     */
+    internal fun discardPathResults() {
+        lpResultCache.clear()
+        uniqueTable.forEachNode { if (it is AADD.Internal) it.pathResults = null }
+    }
+
+    /**
+     * Counters of the work done by this builder and the time of the LP solver, see [DDStatistics].
+     */
+    val statistics = DDStatistics()
+
+    /**
+     * Directed rounding of the affine arithmetic of this builder, as selected by [DDBuilderSettings.roundingBackend].
+     */
+    val math: RoundingMath
+        get() = settings.roundingBackend.math
+
+    /**
+     * Reclaims the noise symbols that are no longer used by reachable DD or conditions,
+     * and renumbers the remaining ones densely; see [NoiseVariables.reclaim].
+     * @return the number of reclaimed noise symbols.
+     */
+    fun reclaimNoiseSymbols(): Int = noiseVariables.reclaim()
+
+    /**
+     * Removes the conditions that are no longer referenced by reachable DD,
+     * and compacts the indexes of the remaining ones; see [Conditions.collect].
+     * @return the number of removed conditions.
+     */
+    fun collectConditions(): Int = conditions.collect()
+
+    /**
+     * Reorders the conditions of all DD of this builder to reduce the number of nodes; see [Reordering].
+     * Unreferenced conditions are collected before.
+     * @param method the reordering method.
+     * @return the number of internal nodes before and after the reordering.
+     */
+    fun reorder(method: ReorderingMethod = settings.ddReorderMethod): ReorderingResult =
+        Reordering(this).run(method)
+
+    /** Size of the unique table above which the conditions are reordered, see [DDBuilderSettings.ddReorderThreshold]. */
+    private var nextReordering = 0
+
+    /**
+     * Collects conditions and noise symbols, and reorders the conditions, if due by the settings.
+     * Called only between operations, where all DD in use are reachable by the caller.
+     */
+    private fun collectIfDue() {
+        conditions.collectIfDue()
+        noiseVariables.reclaimIfDue()
+        val threshold = settings.ddReorderThreshold
+        if (threshold > 0 && uniqueTable.size > maxOf(threshold, nextReordering)) {
+            reorder()
+            uniqueTable.sweep()
+            nextReordering = 2 * uniqueTable.size
+        }
+    }
+
     /**
      * Creates an Integer scalar with given finite Long value.
      * @param scalar the value of the integer constant as Long.
@@ -124,19 +208,23 @@ class DDBuilder(
      * @param range bounds of the real variable
      * @param id noise symbol as a string
      */
-    fun real(range: ClosedRange<DoubleBound>, id: String? = null): Real =
-        leaf(AffineForm.range(this, range.start, range.endInclusive, id))
+    fun real(range: ClosedRange<DoubleBound>, id: String? = null): Real {
+        collectIfDue()
+        return leaf(AffineForm.range(this, range.start, range.endInclusive, id))
+    }
 
     /**
      * Creates a real variable bounded by a range
      * @param range - bounds of the real variable
      */
-    fun real(range: ClosedRange<Double>, id: String? = null) =
-        leaf(AffineForm.range(this,
+    fun real(range: ClosedRange<Double>, id: String? = null): Real {
+        collectIfDue()
+        return leaf(AffineForm.range(this,
             range.start.toDoubleBound() ?: DoubleBound.NegativeInfinity,
             range.endInclusive.toDoubleBound() ?: DoubleBound.PositiveInfinity,
             id)
         )
+    }
 
     /**
      * Creates a constant of a value typed by Number
@@ -181,7 +269,7 @@ class DDBuilder(
      * Creates a string constant with a given value
      * @param value the value of the string
      */
-    fun string(value: String): StrDD = StrDD.Leaf(this, Str(value))
+    fun string(value: String): StrDD = leaf(value)
 
     @Deprecated("No longer needed")
     enum class ApproximationScheme{
@@ -199,18 +287,32 @@ class DDBuilder(
     // -------------- Below here, only for internal use! -----------------
     //
 
+    /** Returns the canonical leaf for value and status from the unique table, if enabled. */
+    private inline fun <N: DD<*>> uniqueLeaf(value: Any, status: Status, crossinline create: () -> N): N =
+        if (settings.ddUniqueTable) uniqueTable.leaf(value, status) { created(create()) } else created(create())
+
+    /** Returns the canonical internal node for index, T, F from the unique table, if enabled. */
+    private inline fun <N: DD<*>> uniqueInternal(index: Int, T: DD<*>, F: DD<*>, crossinline create: () -> N): N =
+        if (settings.ddUniqueTable) uniqueTable.internal(index, T, F) { created(create()) } else created(create())
+
+    /** Counts a new node in the [statistics]; it is added to the unique table after. */
+    private fun <N: DD<*>> created(node: N): N {
+        statistics.nodeCreated(node, if (settings.ddUniqueTable) uniqueTable.size + 1 else 0)
+        return node
+    }
+
     /** Factory: Creates a new AADD.Leaf with an affine form as value.  */
     internal fun leaf(value: AffineForm, status: Status): AADD.Leaf = when {
         status == Status.Infeasible -> Reals.Infeasible
         value.isEmpty()     -> Reals.Empty
-        else                -> AADD.Leaf(this, value.clone(), status)
+        else                -> uniqueLeaf(value, status) { AADD.Leaf(this, value.clone(), status) }
     }
 
     /** Creates a new AADD.Leaf with an affine form as value.  */
     internal fun leaf(value: AffineForm): AADD.Leaf = when {
         value.isEmpty() -> Reals.Empty
         value.isReals() -> Reals.All
-        else -> AADD.Leaf(this, value)
+        else -> uniqueLeaf(value, Status.NotSolved) { AADD.Leaf(this, value) }
     }
 
     internal fun leaf(value: NumberRange<DoubleBound>): AADD.Leaf =
@@ -219,11 +321,13 @@ class DDBuilder(
     internal fun leaf(value: NumberRange<LongBound>, status: Status = Status.NotSolved): IDD.Leaf = when {
         status == Status.Infeasible -> Integers.Infeasible
         value.isEmpty()             -> Integers.Empty
-        else                        -> IDD.Leaf(this, IntegerRange(value), status)
+        else                        -> IntegerRange(value).let { range ->
+            uniqueLeaf(range, status) { IDD.Leaf(this, range, status) }
+        }
     }
 
     internal fun leaf(value: String): StrDD.Leaf =
-        StrDD.Leaf(this, Str(value))
+        uniqueLeaf(value, Status.NotSolved) { StrDD.Leaf(this, Str(value)) }
 
     /**
      * Generic creation of internal node.
@@ -232,11 +336,13 @@ class DDBuilder(
     internal fun <DDType: DD<ValueType>, ValueType: ScalarValue> internal(index: Int, T: DDType, F: DDType): DDType =
         if (T is DD.Leaf<*> && F is DD.Leaf<*> && T.value == F.value)
             if (T is BDD) T else leaf(T.value as ValueType)
-        else when (T) {
-            is AADD -> AADD.Internal(this, index, T, F as AADD) as DDType
-            is BDD -> BDD.Internal(this, index, T, F as BDD) as DDType
-            is IDD -> IDD.Internal(this, index, T, F as IDD) as DDType
-            is StrDD -> StrDD.Internal(this, index, T, F as StrDD) as DDType
+        else uniqueInternal(index, T, F) {
+            when (T) {
+                is AADD -> AADD.Internal(this, index, T, F as AADD) as DDType
+                is BDD -> BDD.Internal(this, index, T, F as BDD) as DDType
+                is IDD -> IDD.Internal(this, index, T, F as IDD) as DDType
+                is StrDD -> StrDD.Internal(this, index, T, F as StrDD) as DDType
+            }
         }
 
     /**
@@ -257,16 +363,15 @@ class DDBuilder(
     internal fun internal(index: Int, T: AADD, F: AADD): AADD =
         if (T is AADD.Leaf && F is AADD.Leaf && T.value.isSimilar(F.value, this.settings.ddJoinLeavesThreshold))
             leaf(T.value.join(F.value))
-        else {
-            AADD.Internal(this, index, T, F)
-        }
+        else
+            uniqueInternal(index, T, F) { AADD.Internal(this, index, T, F) }
 
     /** Creates a new IDD internal node with index 'index' and child nodes T and F. */
     internal fun internal(index: Int, T: IDD, F: IDD) : IDD =
         if (T is IDD.Leaf && F is IDD.Leaf && T.value==F.value)
             leaf(T.value.join(F.value))
         else
-            IDD.Internal(this, index, T, F)
+            uniqueInternal(index, T, F) { IDD.Internal(this, index, T, F) }
 
     /*
     internal fun internal(index: Int, T: StrDD, F: StrDD): StrDD =
@@ -302,12 +407,13 @@ class DDBuilder(
     /** Creates an internal node with a given index that must refer to an existing condition. */
     internal fun internal(index: Int, T: BDD, F: BDD): BDD =
         if (T === F)  T
-        else  BDD.Internal(this, index, T, F)
+        else  uniqueInternal(index, T, F) { BDD.Internal(this, index, T, F) }
 
     private var pathConds: ArrayDeque<BDD> = ArrayDeque()
 
     /** Functions for modeling control-flow in a human-readable way: IF() .. END(): x = x.assignS(thenval) */
     fun IF(cond: BDD): BDD {
+        collectIfDue()
         pathConds.addFirst(cond)
         return  cond
     }
@@ -326,10 +432,11 @@ class DDBuilder(
         return pathConjunction.ite(new,old)
     }
 
+    /** Assigns new to old on the current path; the result is bounded to [DDBuilderSettings.ddMaxLeaves] leaves. */
     fun assign(old: AADD, new: AADD): AADD {
         var pathConjunction = pathConds[0]
         for(i in 1 until pathConds.size) pathConjunction = pathConjunction and pathConds[i]
-        return pathConjunction.ite(new,old)
+        return pathConjunction.ite(new,old).bounded()
     }
 
     fun assign(old: IDD, new: IDD):IDD{
@@ -380,10 +487,10 @@ class DDBuilder(
      */
     internal val AF = AFNamespace()
     inner class AFNamespace {
-        val All   = AffineForm(this@DDBuilder, RealRange.Reals.min, RealRange.Reals.max, Double.NaN, hashMapOf())
-        val Empty = AffineForm(this@DDBuilder, RealRange.Empty.min, RealRange.Empty.max, Double.NaN, hashMapOf())
-        val Zero  = AffineForm(this@DDBuilder, RealRange.Zero.min, RealRange.Zero.max, 0.0, hashMapOf())
-        val One   = AffineForm(this@DDBuilder, RealRange.One.min, RealRange.One.max, 1.0, hashMapOf())
+        val All   = AffineForm(this@DDBuilder, RealRange.Reals.min, RealRange.Reals.max, Double.NaN, NoiseTerms(0))
+        val Empty = AffineForm(this@DDBuilder, RealRange.Empty.min, RealRange.Empty.max, Double.NaN, NoiseTerms(0))
+        val Zero  = AffineForm(this@DDBuilder, RealRange.Zero.min, RealRange.Zero.max, 0.0, NoiseTerms(0))
+        val One   = AffineForm(this@DDBuilder, RealRange.One.min, RealRange.One.max, 1.0, NoiseTerms(0))
     }
 
     /** Constants for the Reals */
@@ -430,7 +537,25 @@ class DDBuilder(
     //
     // ------------------------ Other stuff --------------------------
     //
-    var lpCalls = 0
+    /** Number of leaves whose LP problem was solved by the LP solver; see [statistics]. */
+    var lpCalls: Int
+        get() = statistics.lpCalls.toInt()
+        set(value) { statistics.lpCalls = value.toLong() }
+
+    /** Number of leaves whose LP problem was decided by bound propagation instead of the LP solver. */
+    var lpCallsAvoided: Int
+        get() = statistics.lpCallsAvoided.toInt()
+        set(value) { statistics.lpCallsAvoided = value.toLong() }
+
+    /** Number of leaves merged to bound the size of AADD, see [bounded]. */
+    var leafMerges: Int
+        get() = statistics.leafMergeCount.toInt()
+        set(value) { statistics.leafMergeCount = value.toLong() }
+
+    /** Sum of the increase of the width of the ranges of the leaves merged to bound the size of AADD. */
+    var leafMergeLoss: Double
+        get() = statistics.leafMergeLossSum
+        set(value) { statistics.leafMergeLossSum = value }
 
     val jsonMapper = Json {
         prettyPrint = true
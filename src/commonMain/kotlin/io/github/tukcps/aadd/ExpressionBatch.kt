@@ -0,0 +1,210 @@
+package io.github.tukcps.aadd
+
+import io.github.tukcps.aadd.DDBuilder.BoolMath.and
+import io.github.tukcps.aadd.DDBuilder.BoolMath.nand
+import io.github.tukcps.aadd.DDBuilder.BoolMath.not
+import io.github.tukcps.aadd.DDBuilder.BoolMath.or
+import io.github.tukcps.aadd.DDBuilder.BoolMath.xor
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.DD
+import io.github.tukcps.aadd.dd.timesBDD
+
+/**
+ * ### ExpressionBatch
+ *
+ * A computation on AADD and BDD that is recorded as a whole, e.g. the update expression of a
+ * SystemC process, and that is executed in a single call.
+ * It is the entry point for the expression recorder of the C++ wrapper: instead of one call through
+ * the native interface (and one new stable pointer) per operation, a whole expression is passed once
+ * as a program and then executed by [run]; only the requested results are fetched via [getReal] and [getBool].
+ *
+ * The program is compiled once, when the batch is created. It is a sequence of instructions separated by
+ * `;` or new lines; each instruction is an operation followed by register numbers:
+ * - `const r v` loads the real constant v into register r (evaluated once, at compilation),
+ * - `in r` declares r as an input, set via [setReal] or [setBool],
+ * - `out r` declares r as a result; results keep their value across runs and can serve as state,
+ * - `mov r a`, and the unary real operations `neg exp ln sqrt sqr inv floor ceil` with `op r a`,
+ * - the binary real operations `add sub mul div pow` with `op r a b`; `mul` with a BDD b is timesBDD,
+ * - the comparisons `lt le gt ge` with `op r a b`, resulting in a BDD,
+ * - the Boolean operations `and or xor nand` with `op r a b`, and `not r a`,
+ * - `ite r c t e` for a BDD c and either two AADD or two BDD t, e.
+ *
+ * Registers that are neither input nor result are released after each run.
+ *
+ * @param builder the builder of all DD in the registers.
+ * @param program the program as described above.
+ */
+class ExpressionBatch(
+    val builder: DDBuilder,
+    program: String
+) {
+    private val code: IntArray
+    private val constants: DoubleArray
+    private val kept: BooleanArray
+    private val registers: Array<DD<*>?>
+
+    /** Number of registers used by the program. */
+    val size: Int get() = registers.size
+
+    /** Number of operations executed per run. */
+    val length: Int get() = code.size / STRIDE
+
+    init {
+        val instructions = program.split(';', '\n').map { it.trim() }.filter { it.isNotEmpty() }
+        val ops = ArrayList<Int>(instructions.size * STRIDE)
+        val consts = ArrayList<Double>()
+        val inputs = HashSet<Int>()
+        val outputs = HashSet<Int>()
+        var registerCount = 0
+        for (instruction in instructions) {
+            val tokens = instruction.split(' ', '\t').filter { it.isNotEmpty() }
+            val name = tokens[0]
+            val opcode = MNEMONICS.indexOf(name)
+            if (opcode < 0) throw DDException("Unknown operation '$name' in expression batch")
+            val arity = ARITY[opcode]
+            if (tokens.size != arity + 1)
+                throw DDException("Operation '$name' expects $arity operands, found ${tokens.size - 1}")
+            val operands = IntArray(STRIDE - 1)
+            for (k in 0 until arity) {
+                operands[k] = if (opcode == CONST && k == 1) {
+                    consts.add(tokens[2].toDoubleOrNull() ?: throw DDException("Invalid constant '${tokens[2]}'"))
+                    consts.size - 1
+                } else {
+                    val r = tokens[k + 1].toIntOrNull()
+                    if (r == null || r < 0) throw DDException("Invalid register '${tokens[k + 1]}'")
+                    if (r >= registerCount) registerCount = r + 1
+                    r
+                }
+            }
+            when (opcode) {
+                IN  -> inputs.add(operands[0])
+                OUT -> outputs.add(operands[0])
+                else -> {
+                    ops.add(opcode)
+                    for (operand in operands) ops.add(operand)
+                }
+            }
+        }
+        registers = arrayOfNulls(registerCount)
+        kept = BooleanArray(registerCount) { it in inputs || it in outputs }
+        constants = consts.toDoubleArray()
+
+        // Constants are evaluated once; they are kept and not part of the code that is run.
+        val runCode = ArrayList<Int>(ops.size)
+        for (pc in ops.indices step STRIDE) {
+            if (ops[pc] == CONST) {
+                registers[ops[pc + 1]] = builder.real(constants[ops[pc + 2]])
+                kept[ops[pc + 1]] = true
+            } else
+                for (k in 0 until STRIDE) runCode.add(ops[pc + k])
+        }
+        code = runCode.toIntArray()
+    }
+
+    /** Sets an input register to a real value. */
+    fun setReal(register: Int, value: AADD) {
+        checkBuilder(value)
+        registers[register] = value
+    }
+
+    /** Sets an input register to a Boolean value. */
+    fun setBool(register: Int, value: BDD) {
+        checkBuilder(value)
+        registers[register] = value
+    }
+
+    /** @return the real value of a register after [run]. */
+    fun getReal(register: Int): AADD = real(register)
+
+    /** @return the Boolean value of a register after [run]. */
+    fun getBool(register: Int): BDD = bool(register)
+
+    /**
+     * Executes the program once.
+     * Results remain available until the next run; all other intermediate results are released.
+     */
+    fun run() {
+        with(DDBuilder.RealMath) {
+            for (pc in code.indices step STRIDE) {
+                val r = code[pc + 1]
+                val a = code[pc + 2]
+                val b = code[pc + 3]
+                val c = code[pc + 4]
+                registers[r] = when (code[pc]) {
+                    MOV   -> registers[a] ?: throw DDException("Register $a is not set")
+                    NEG   -> negate(real(a))
+                    EXP   -> exp(real(a))
+                    LN    -> ln(real(a))
+                    SQRT  -> sqrt(real(a))
+                    SQR   -> sqr(real(a))
+                    INV   -> inv(real(a))
+                    FLOOR -> floor(real(a))
+                    CEIL  -> ceil(real(a))
+                    ADD   -> add(real(a), real(b))
+                    SUB   -> subtract(real(a), real(b))
+                    MUL   -> registers[b].let { if (it is BDD) real(a).timesBDD(it) else multiply(real(a), real(b)) }
+                    DIV   -> divide(real(a), real(b))
+                    POW   -> pow(real(a), real(b))
+                    LT    -> real(a) lessThan real(b)
+                    LE    -> real(a) lessThanOrEquals real(b)
+                    GT    -> real(a) greaterThan real(b)
+                    GE    -> real(a) greaterThanOrEquals real(b)
+                    AND   -> bool(a) and bool(b)
+                    OR    -> bool(a) or bool(b)
+                    XOR   -> bool(a) xor bool(b)
+                    NAND  -> bool(a) nand bool(b)
+                    NOT   -> bool(a).not()
+                    ITE   -> registers[b].let {
+                        if (it is BDD) bool(a).ite(it, bool(c)) else bool(a).ite(real(b), real(c))
+                    }
+                    else  -> throw DDInternalError("Invalid opcode ${code[pc]} in expression batch")
+                }
+            }
+        }
+        for (r in registers.indices)
+            if (!kept[r]) registers[r] = null
+    }
+
+    private fun real(register: Int): AADD =
+        registers[register] as? AADD ?: throw DDException("Register $register does not hold a real value")
+
+    private fun bool(register: Int): BDD =
+        registers[register] as? BDD ?: throw DDException("Register $register does not hold a Boolean value")
+
+    private fun checkBuilder(value: DD<*>) {
+        if (value.builder !== builder) throw DDException("Value of expression batch was created by another builder")
+    }
+
+    override fun toString(): String = "ExpressionBatch: $length operations, $size registers"
+
+    private companion object {
+        /** Opcode, result register, and up to three operands. */
+        const val STRIDE = 5
+
+        val MNEMONICS = listOf(
+            "const", "in", "out", "mov",
+            "neg", "exp", "ln", "sqrt", "sqr", "inv", "floor", "ceil",
+            "add", "sub", "mul", "div", "pow",
+            "lt", "le", "gt", "ge",
+            "and", "or", "xor", "nand", "not",
+            "ite"
+        )
+        val ARITY = intArrayOf(
+            2, 1, 1, 2,
+            2, 2, 2, 2, 2, 2, 2, 2,
+            3, 3, 3, 3, 3,
+            3, 3, 3, 3,
+            3, 3, 3, 3, 2,
+            4
+        )
+
+        const val CONST = 0; const val IN = 1; const val OUT = 2; const val MOV = 3
+        const val NEG = 4; const val EXP = 5; const val LN = 6; const val SQRT = 7
+        const val SQR = 8; const val INV = 9; const val FLOOR = 10; const val CEIL = 11
+        const val ADD = 12; const val SUB = 13; const val MUL = 14; const val DIV = 15; const val POW = 16
+        const val LT = 17; const val LE = 18; const val GT = 19; const val GE = 20
+        const val AND = 21; const val OR = 22; const val XOR = 23; const val NAND = 24; const val NOT = 25
+        const val ITE = 26
+    }
+}
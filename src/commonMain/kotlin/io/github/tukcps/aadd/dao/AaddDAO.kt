@@ -2,6 +2,8 @@
 
 package io.github.tukcps.aadd.dao
 
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDException
 import io.github.tukcps.aadd.dd.AADD
 import io.github.tukcps.aadd.dd.DD
 import kotlinx.serialization.Serializable
@@ -25,4 +27,15 @@ fun AADD.toDAO(): AaddDAO = AaddDAO(
     value = if (this is AADD.Leaf) value.toDAO() else null,
     T = if (this is AADD.Internal) T.toDAO() else null,
     F = if (this is AADD.Internal) F.toDAO() else null
-)
\ No newline at end of file
+)
+
+/** Creates the AADD of a DAO with the builder; indexes and noise symbols refer to the builder. */
+fun AaddDAO.toAADD(builder: DDBuilder): AADD = when (type) {
+    "AADD.Leaf" -> value?.toLeaf(builder) ?: throw DDException("AADD.Leaf without value")
+    "AADD.Internal" -> builder.internal(
+        index ?: throw DDException("AADD.Internal without index"),
+        T?.toAADD(builder) ?: throw DDException("AADD.Internal without T"),
+        F?.toAADD(builder) ?: throw DDException("AADD.Internal without F")
+    )
+    else -> throw DDException("Unknown type of AADD: $type")
+}
@@ -1,6 +1,10 @@
 package io.github.tukcps.aadd.dao
 
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.DD
 import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.NoiseTerms
 import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
 import kotlinx.serialization.Serializable
 
@@ -22,5 +26,9 @@ fun AffineForm.toDAO() = AffineFormDAO(
     min = min.toDouble(),
     max = max.toDouble(),
     central = central,
-    xi = xi
-)
\ No newline at end of file
+    xi = HashMap(xi)
+)
+
+/** Creates an AADD leaf with the affine form of the DAO. */
+fun AffineFormDAO.toLeaf(builder: DDBuilder): AADD.Leaf =
+    builder.aaddLeaf(builder.affineForm(min, max, central, NoiseTerms(xi)), DD.Status.NotSolved)
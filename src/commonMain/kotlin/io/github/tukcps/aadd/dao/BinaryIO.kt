@@ -0,0 +1,179 @@
+package io.github.tukcps.aadd.dao
+
+import io.github.tukcps.aadd.DDException
+
+/*
+ * Primitives of the binary formats.
+ * Integers are written as LEB128 varints, signed ones zigzag encoded; doubles are written as raw
+ * IEEE-754 bits, little endian; strings are written once into a string pool and then referenced by number.
+ */
+
+/** Destination of a binary stream, e.g. a file or a socket. */
+fun interface ByteSink {
+    fun write(bytes: ByteArray, offset: Int, length: Int)
+}
+
+/** Source of a binary stream; returns the number of bytes read, or -1 at the end of the stream. */
+fun interface ByteSource {
+    fun read(bytes: ByteArray, offset: Int, length: Int): Int
+}
+
+/** A sink that collects the bytes in memory. */
+class ByteArraySink : ByteSink {
+    private var bytes = ByteArray(1 shl 12)
+    var size = 0
+        private set
+
+    override fun write(bytes: ByteArray, offset: Int, length: Int) {
+        if (size + length > this.bytes.size)
+            this.bytes = this.bytes.copyOf(maxOf(size + length, 2 * this.bytes.size))
+        bytes.copyInto(this.bytes, size, offset, offset + length)
+        size += length
+    }
+
+    fun toByteArray(): ByteArray = bytes.copyOf(size)
+}
+
+/** A source that reads from a byte array, e.g. a memory mapped file. */
+class ByteArraySource(private val bytes: ByteArray, private var position: Int = 0) : ByteSource {
+    override fun read(bytes: ByteArray, offset: Int, length: Int): Int {
+        if (position >= this.bytes.size) return -1
+        val n = minOf(length, this.bytes.size - position)
+        this.bytes.copyInto(bytes, offset, position, position + n)
+        position += n
+        return n
+    }
+}
+
+/** Buffered output of the primitives to a sink. */
+internal class BinaryOutput(private val sink: ByteSink) {
+    private val buffer = ByteArray(1 shl 13)
+    private var position = 0
+
+    /** Numbers of the strings written to the string pool. */
+    private val strings = HashMap<String, Int>()
+
+    fun byte(value: Int) {
+        if (position == buffer.size) flush()
+        buffer[position++] = value.toByte()
+    }
+
+    fun varint(value: Long) {
+        var v = value
+        while (v and 0x7FL.inv() != 0L) {
+            byte(((v and 0x7F) or 0x80).toInt())
+            v = v ushr 7
+        }
+        byte(v.toInt())
+    }
+
+    fun varint(value: Int) = varint(value.toLong() and 0xFFFFFFFFL)
+
+    fun zigzag(value: Long) = varint((value shl 1) xor (value shr 63))
+
+    fun zigzag(value: Int) = zigzag(value.toLong())
+
+    fun double(value: Double) {
+        val bits = value.toRawBits()
+        for (k in 0 until 8) byte((bits ushr (8 * k)).toInt())
+    }
+
+    /** Writes the number of a string in the pool; a new string follows its number as UTF-8. */
+    fun string(value: String) {
+        val number = strings[value]
+        if (number != null) {
+            varint(number)
+            return
+        }
+        strings[value] = strings.size
+        varint(strings.size - 1)
+        val utf8 = value.encodeToByteArray()
+        varint(utf8.size)
+        for (b in utf8) byte(b.toInt())
+    }
+
+    fun header(magic: ByteArray, version: Int) {
+        for (b in magic) byte(b.toInt())
+        varint(version)
+    }
+
+    fun flush() {
+        if (position > 0) sink.write(buffer, 0, position)
+        position = 0
+    }
+}
+
+/** Buffered input of the primitives from a source. */
+internal class BinaryInput(private val source: ByteSource) {
+    private val buffer = ByteArray(1 shl 13)
+    private var position = 0
+    private var limit = 0
+
+    /** The string pool, by number. */
+    private val strings = ArrayList<String>()
+
+    /** @return the next byte as 0..255, or -1 at the end of the stream. */
+    fun byteOrEnd(): Int {
+        if (position == limit) {
+            limit = source.read(buffer, 0, buffer.size)
+            position = 0
+            if (limit <= 0) {
+                limit = 0
+                return -1
+            }
+        }
+        return buffer[position++].toInt() and 0xFF
+    }
+
+    fun byte(): Int {
+        val b = byteOrEnd()
+        if (b < 0) throw DDException("Binary format: unexpected end of stream")
+        return b
+    }
+
+    fun varint(): Long {
+        var result = 0L
+        var shift = 0
+        while (true) {
+            val b = byte()
+            result = result or ((b and 0x7F).toLong() shl shift)
+            if (b and 0x80 == 0) return result
+            shift += 7
+            if (shift > 63) throw DDException("Binary format: malformed varint")
+        }
+    }
+
+    fun int(): Int {
+        val value = varint()
+        if (value < 0 || value > 0xFFFFFFFFL) throw DDException("Binary format: malformed int")
+        return value.toInt()
+    }
+
+    fun zigzag(): Long {
+        val value = varint()
+        return (value ushr 1) xor -(value and 1)
+    }
+
+    fun double(): Double {
+        var bits = 0L
+        for (k in 0 until 8) bits = bits or (byte().toLong() shl (8 * k))
+        return Double.fromBits(bits)
+    }
+
+    /** Reads and checks the magic bytes and the version of a stream. */
+    fun header(magic: ByteArray, version: Int) {
+        for (b in magic)
+            if (byte() != b.toInt()) throw DDException("Binary format: not a ${magic.decodeToString()} stream")
+        val found = int()
+        if (found > version) throw DDException("Binary format: unsupported version $found")
+    }
+
+    fun string(): String {
+        val number = int()
+        if (number < strings.size) return strings[number]
+        if (number != strings.size) throw DDException("Binary format: string $number not in pool")
+        val utf8 = ByteArray(int())
+        for (k in utf8.indices) utf8[k] = byte().toByte()
+        return utf8.decodeToString().also { strings.add(it) }
+    }
+}
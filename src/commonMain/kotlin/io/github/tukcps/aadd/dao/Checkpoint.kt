@@ -0,0 +1,198 @@
+package io.github.tukcps.aadd.dao
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.DD
+import io.github.tukcps.aadd.dd.IDD
+import io.github.tukcps.aadd.values.integer.IntegerRange
+
+/**
+ * ## Checkpoint
+ *
+ * Saves the session of a builder to a stream, so that it can be restored by [restore]:
+ * the settings, the noise variables, the conditions with their names and decision-variable maps,
+ * and a set of named DD that are live.
+ *
+ * The stream starts with the magic bytes "AADC" and the version, followed by one segment per [save].
+ * A segment is either full, or incremental: it only contains the noise variables and conditions
+ * created since the last segment, and the DD nodes that have not been written before (see [DDBinaryWriter]).
+ * A segment is full if it is the first one, if it is requested, or if the existing conditions or
+ * noise variables have changed, e.g. by [DDBuilder.collectConditions], [DDBuilder.reorder] or
+ * [DDBuilder.reclaimNoiseSymbols]. The checkpoint keeps the nodes it has written; a full segment releases them.
+ *
+ * A checkpoint must be saved between operations.
+ * @param builder the builder whose session is saved.
+ * @param sink the stream; each segment is flushed.
+ */
+class Checkpoint(val builder: DDBuilder, sink: ByteSink) {
+    private val out = BinaryOutput(sink)
+    private val dds = DDBinaryWriter(out)
+    private val live = LinkedHashMap<String, DD<*>>()
+
+    private var segments = 0
+    private var topIndex = 0
+    private var maxIndex = 0L
+    private var epoch = 0
+    private var generation = 0
+
+    init {
+        out.header(MAGIC, VERSION)
+    }
+
+    /** Adds or replaces a named DD that is saved with each checkpoint. */
+    operator fun set(name: String, dd: DD<*>) {
+        live[name] = dd
+    }
+
+    operator fun get(name: String): DD<*>? = live[name]
+
+    fun remove(name: String) {
+        live.remove(name)
+    }
+
+    /**
+     * Writes a segment with the session of the builder.
+     * @param full if true, writes all conditions, noise variables and nodes, as for the first segment.
+     * @return true if the segment is full.
+     */
+    fun save(full: Boolean = false): Boolean {
+        val conditions = builder.conditions
+        val noise = builder.noiseVariables
+        val isFull = full || segments == 0 || conditions.epoch != epoch || noise.generation != generation ||
+                conditions.topIndex < topIndex || noise.maxIndex < maxIndex
+        if (isFull) {
+            dds.reset()
+            topIndex = Int.MIN_VALUE
+            maxIndex = Long.MIN_VALUE
+        }
+        out.byte(if (isFull) 1 else 0)
+        out.string(json.encodeToString(builder.settings))
+
+        out.zigzag(noise.maxIndex)
+        out.zigzag(noise.maxIndexGarbage)
+        val names = noise.names.filterKeys { it > maxIndex }
+        out.varint(names.size)
+        for ((index, name) in names) {
+            out.zigzag(index)
+            out.string(name)
+        }
+
+        out.zigzag(conditions.btmIndex)
+        out.zigzag(conditions.topIndex)
+        val added = conditions.x.filterKeys { it > topIndex }
+        out.varint(added.size)
+        for ((index, condition) in added) {
+            out.zigzag(index)
+            condition(condition)
+        }
+        val indexes = conditions.indexes.filterValues { it > topIndex }
+        out.varint(indexes.size)
+        for ((name, index) in indexes) {
+            out.string(name)
+            out.zigzag(index)
+            val introducedBy = conditions.introducedDecVars[name]
+            val isDecVar = conditions.isDecVar[name]
+            out.byte((if (introducedBy != null) 1 else 0) or (if (isDecVar == true) 2 else 0) or (if (isDecVar != null) 4 else 0))
+            if (introducedBy != null) out.string(introducedBy)
+        }
+
+        for ((name, dd) in live) dds.write(dd, name)
+        dds.close()
+
+        segments++
+        topIndex = conditions.topIndex
+        maxIndex = noise.maxIndex
+        epoch = conditions.epoch
+        generation = noise.generation
+        return isFull
+    }
+
+    /** Conditions are created directly, not via the unique table, as by [io.github.tukcps.aadd.Conditions]. */
+    private fun condition(condition: DD<*>) = when (condition) {
+        is BDD.Leaf -> {
+            out.byte(0)
+            out.byte(condition.status.ordinal)
+            out.byte(condition.value.code())
+        }
+        is AADD.Leaf -> {
+            out.byte(1)
+            out.byte(condition.status.ordinal)
+            out.affineForm(condition.value)
+        }
+        is IDD.Leaf -> {
+            out.byte(2)
+            out.byte(condition.status.ordinal)
+            out.bound(condition.value.min)
+            out.bound(condition.value.max)
+        }
+        else -> throw DDException("Checkpoint: unsupported condition ${condition::class.simpleName}")
+    }
+
+    companion object {
+        val MAGIC = byteArrayOf('A'.code.toByte(), 'A'.code.toByte(), 'D'.code.toByte(), 'C'.code.toByte())
+        const val VERSION = 1
+    }
+}
+
+/**
+ * Restores a session saved by a [Checkpoint] into this builder, which must be new.
+ * The segments are read in one pass; the time is proportional to the size of the stream.
+ * @return the named DD of the last segment.
+ */
+fun DDBuilder.restore(source: ByteSource): Map<String, DD<*>> {
+    if (conditions.x.isNotEmpty() || noiseVariables.maxIndex != 0L)
+        throw DDException("Checkpoint: restore requires a new builder")
+    val input = BinaryInput(source)
+    input.header(Checkpoint.MAGIC, Checkpoint.VERSION)
+    val dds = DDBinaryReader(this, input)
+    var named: Map<String, DD<*>> = emptyMap()
+    while (true) {
+        val full = input.byteOrEnd()
+        if (full < 0) break
+        settings = json.decodeFromString<DDBuilderSettings>(input.string())
+        if (full == 1) dds.reset()
+
+        val maxIndex = input.zigzag()
+        val maxIndexGarbage = input.zigzag()
+        val names = HashMap<Long, String>()
+        repeat(input.int()) { names[input.zigzag()] = input.string() }
+        noiseVariables.restore(maxIndex, maxIndexGarbage, names, full == 1)
+
+        if (full == 1) {
+            conditions.x.clear()
+            conditions.indexes.clear()
+            conditions.introducedDecVars.clear()
+            conditions.decVarsIntroducedBy.clear()
+            conditions.isDecVar.clear()
+        }
+        conditions.btmIndex = input.zigzag().toInt()
+        conditions.topIndex = input.zigzag().toInt()
+        repeat(input.int()) {
+            val index = input.zigzag().toInt()
+            conditions.x[index] = when (input.byte()) {
+                0 -> { val status = input.status(); bddLeaf(status, input.byte()) }
+                1 -> { val status = input.status(); AADD.Leaf(this, input.affineForm(this), status) }
+                2 -> { val status = input.status(); IDD.Leaf(this, IntegerRange(input.bound(), input.bound()), status) }
+                else -> throw DDException("Checkpoint: unknown condition")
+            }
+        }
+        repeat(input.int()) {
+            val name = input.string()
+            conditions.indexes[name] = input.zigzag().toInt()
+            val flags = input.byte()
+            if (flags and 1 != 0) {
+                val introducedBy = input.string()
+                conditions.introducedDecVars[name] = introducedBy
+                conditions.decVarsIntroducedBy.getOrPut(introducedBy) { HashSet() }.add(name)
+            }
+            if (flags and 4 != 0) conditions.isDecVar[name] = flags and 2 != 0
+        }
+        named = dds.readSegment()
+    }
+    lpResultCache.clear()
+    operationCache.invalidate()
+    return named
+}
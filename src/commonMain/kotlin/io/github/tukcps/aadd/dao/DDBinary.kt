@@ -0,0 +1,284 @@
+package io.github.tukcps.aadd.dao
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.dd.*
+import io.github.tukcps.aadd.dd.DD.Status
+import io.github.tukcps.aadd.values.bool.XBool
+import io.github.tukcps.aadd.values.integer.IntegerRange
+import io.github.tukcps.aadd.values.integer.LongBound
+import io.github.tukcps.aadd.values.real.DoubleBound
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.NoiseTerms
+import io.github.tukcps.aadd.values.real.toDoubleBound
+
+/**
+ * ## Binary format of DD
+ *
+ * A compact alternative to the JSON DAOs for large DD. The stream starts with the magic bytes "AADB"
+ * and the version, followed by records that each start with a tag byte:
+ * - a node record defines the next node of the node table; internal nodes refer to their children
+ *   by the distance of their numbers, i.e. each node is written once and shared subgraphs are kept;
+ * - a root record names a node of the table as a DD that was written;
+ * - the end record ends the stream.
+ *
+ * Children are always written before their parents, so a reader builds the DD in one forward pass,
+ * without seeks; the format can also be decoded from a memory mapped file via [ByteArraySource].
+ * Noise symbols and indexes of conditions refer to the builder, as in the JSON DAOs.
+ */
+object DDBinary {
+    val MAGIC = byteArrayOf('A'.code.toByte(), 'A'.code.toByte(), 'D'.code.toByte(), 'B'.code.toByte())
+    const val VERSION = 1
+
+    internal const val END = 0
+    internal const val ROOT = 1
+    internal const val AADD_LEAF = 2
+    internal const val AADD_INTERNAL = 3
+    internal const val BDD_LEAF = 4
+    internal const val BDD_INTERNAL = 5
+    internal const val IDD_LEAF = 6
+    internal const val IDD_INTERNAL = 7
+    internal const val STRDD_LEAF = 8
+    internal const val STRDD_INTERNAL = 9
+}
+
+/**
+ * Writes DD to a sink in the binary format; nodes that are shared between the DD are written once.
+ * The stream is complete after [close].
+ */
+class DDBinaryWriter internal constructor(private val out: BinaryOutput) {
+
+    /** Number of each node that has been written. */
+    private val numbers = HashMap<NodeKey, Int>()
+
+    constructor(sink: ByteSink) : this(BinaryOutput(sink)) {
+        out.header(DDBinary.MAGIC, DDBinary.VERSION)
+    }
+
+    /**
+     * Writes the nodes of dd that have not been written yet, and a root record.
+     * @param name a name of the DD, or "".
+     */
+    fun write(dd: DD<*>, name: String = "") {
+        val number = dd.fold(::leaf) { node, t, f -> numbers[NodeKey(node)] ?: internal(node, t, f) }
+        out.byte(DDBinary.ROOT)
+        out.string(name)
+        out.varint(number)
+    }
+
+    /** Writes the end record and flushes the stream. */
+    fun close() {
+        out.byte(DDBinary.END)
+        out.flush()
+    }
+
+    /** Starts a new node table; the reader must be reset at the same point of the stream. */
+    internal fun reset() = numbers.clear()
+
+    private fun leaf(leaf: DD.Leaf<*>): Int {
+        numbers[NodeKey(leaf)]?.let { return it }
+        when (leaf) {
+            is AADD.Leaf -> {
+                out.byte(DDBinary.AADD_LEAF)
+                out.byte(leaf.status.ordinal)
+                out.affineForm(leaf.value)
+            }
+            is BDD.Leaf -> {
+                out.byte(DDBinary.BDD_LEAF)
+                out.byte(leaf.status.ordinal)
+                out.byte(leaf.value.code())
+            }
+            is IDD.Leaf -> {
+                out.byte(DDBinary.IDD_LEAF)
+                out.byte(leaf.status.ordinal)
+                out.bound(leaf.value.min)
+                out.bound(leaf.value.max)
+            }
+            is StrDD.Leaf -> {
+                out.byte(DDBinary.STRDD_LEAF)
+                out.byte(leaf.status.ordinal)
+                out.string(leaf.value.str)
+            }
+            else -> throw DDException("Binary format: unsupported leaf ${leaf::class.simpleName}")
+        }
+        return number(leaf)
+    }
+
+    private fun internal(node: DD.Internal<*>, t: Int, f: Int): Int {
+        out.byte(when (node) {
+            is AADD.Internal -> DDBinary.AADD_INTERNAL
+            is BDD.Internal -> DDBinary.BDD_INTERNAL
+            is IDD.Internal -> DDBinary.IDD_INTERNAL
+            is StrDD.Internal -> DDBinary.STRDD_INTERNAL
+        })
+        val number = numbers.size
+        out.varint(node.index)
+        out.varint(number - t)
+        out.varint(number - f)
+        return number(node)
+    }
+
+    private fun number(node: DD<*>): Int = numbers.size.also { numbers[NodeKey(node)] = it }
+}
+
+/**
+ * Reads DD in the binary format from a source; the nodes are created by the builder,
+ * so that they are shared with its other DD via the unique table.
+ */
+class DDBinaryReader internal constructor(private val builder: DDBuilder, private val input: BinaryInput) {
+    private val nodes = ArrayList<DD<*>>()
+    private var ended = false
+
+    constructor(builder: DDBuilder, source: ByteSource) : this(builder, BinaryInput(source)) {
+        input.header(DDBinary.MAGIC, DDBinary.VERSION)
+    }
+
+    /** Reads up to the next root record; @return the name and the DD, or null at the end of the stream. */
+    fun next(): Pair<String, DD<*>>? {
+        while (!ended) {
+            when (val tag = input.byte()) {
+                DDBinary.END -> ended = true
+                DDBinary.ROOT -> {
+                    val name = input.string()
+                    return Pair(name, node<DD<*>>(input.int()))
+                }
+                DDBinary.AADD_LEAF -> nodes.add(aaddLeaf(input.status()))
+                DDBinary.BDD_LEAF -> nodes.add(builder.bddLeaf(input.status(), input.byte()))
+                DDBinary.IDD_LEAF -> {
+                    val status = input.status()
+                    nodes.add(builder.leaf(IntegerRange(input.bound(), input.bound()), status))
+                }
+                DDBinary.STRDD_LEAF -> {
+                    val status = input.status()
+                    val value = input.string()
+                    nodes.add(if (status == Status.Infeasible) builder.Strings.Infeasible else builder.leaf(value))
+                }
+                DDBinary.AADD_INTERNAL -> nodes.add(builder.internal(input.int(), child<AADD>(), child<AADD>()))
+                DDBinary.BDD_INTERNAL -> nodes.add(builder.internal(input.int(), child<BDD>(), child<BDD>()))
+                DDBinary.IDD_INTERNAL -> nodes.add(builder.internal(input.int(), child<IDD>(), child<IDD>()))
+                DDBinary.STRDD_INTERNAL -> nodes.add(builder.internal(input.int(), child<StrDD>(), child<StrDD>()))
+                else -> throw DDException("Binary format: unknown record $tag")
+            }
+        }
+        return null
+    }
+
+    /** Reads all DD up to the end of the stream. */
+    fun readAll(): List<DD<*>> = generateSequence { next()?.second }.toList()
+
+    /** Reads all DD up to the end of the stream, by their names. */
+    fun readNamed(): Map<String, DD<*>> = generateSequence { next() }.toMap()
+
+    /** Reads the DD up to the next end record, for streams that continue after it. */
+    internal fun readSegment(): Map<String, DD<*>> {
+        ended = false
+        return readNamed()
+    }
+
+    /** Starts a new node table, see [DDBinaryWriter.reset]. */
+    internal fun reset() = nodes.clear()
+
+    private inline fun <reified N : DD<*>> node(number: Int): N =
+        nodes.getOrNull(number) as? N ?: throw DDException("Binary format: node $number is not a ${N::class.simpleName}")
+
+    /** The child of the node with the next number, by the distance of the numbers. */
+    private inline fun <reified N : DD<*>> child(): N = node(nodes.size - input.int())
+
+    private fun aaddLeaf(status: Status): AADD.Leaf = builder.aaddLeaf(input.affineForm(builder), status)
+}
+
+/**
+ * An affine form read from a DAO or a binary stream.
+ * The singletons Empty and All are mapped to the constants of the builder.
+ */
+internal fun DDBuilder.affineForm(min: Double, max: Double, central: Double, xi: NoiseTerms): AffineForm {
+    val af = AffineForm(this, min.toDoubleBound() ?: DoubleBound.NegativeInfinity,
+        max.toDoubleBound() ?: DoubleBound.PositiveInfinity, central, xi)
+    return when {
+        af.isEmpty() -> AF.Empty
+        af.isReals() -> AF.All
+        else -> af
+    }
+}
+
+/** The canonical AADD leaf for an affine form read from a DAO or a binary stream. */
+internal fun DDBuilder.aaddLeaf(af: AffineForm, status: Status): AADD.Leaf = when {
+    status == Status.Infeasible -> Reals.Infeasible
+    af.isEmpty() -> Reals.Empty
+    af.isReals() -> Reals.All
+    else -> leaf(af, status)
+}
+
+internal fun BinaryOutput.affineForm(af: AffineForm) {
+    double(af.min.toDouble())
+    double(af.max.toDouble())
+    double(af.central)
+    val xi = af.xi
+    varint(xi.size)
+    var previous = 0L
+    for (k in 0 until xi.size) {
+        // Ids are ascending; the first one is signed, the others are distances.
+        if (k == 0) zigzag(xi.idAt(k)) else varint(xi.idAt(k) - previous)
+        previous = xi.idAt(k)
+        double(xi.coefficientAt(k))
+    }
+}
+
+internal fun BinaryInput.affineForm(builder: DDBuilder): AffineForm {
+    val min = double()
+    val max = double()
+    val central = double()
+    val size = int()
+    val xi = NoiseTerms(size)
+    var id = 0L
+    for (k in 0 until size) {
+        id = if (k == 0) zigzag() else id + varint()
+        xi.append(id, double())
+    }
+    return builder.affineForm(min, max, central, xi)
+}
+
+internal fun BinaryInput.status(): Status = Status.entries.getOrNull(byte())
+    ?: throw DDException("Binary format: unknown status")
+
+/** Code of a value of a BDD leaf. */
+internal fun XBool.code(): Int = when (this) {
+    XBool.False -> 0
+    XBool.True -> 1
+    XBool.All -> 2
+    else -> 3
+}
+
+/** The BDD leaf of the builder for a status and the code of a value. */
+internal fun DDBuilder.bddLeaf(status: Status, code: Int): BDD.Leaf = when {
+    status == Status.Infeasible -> Bool.Infeasible
+    code == 0 -> Bool.False
+    code == 1 -> Bool.True
+    code == 2 -> Bool.All
+    else -> Bool.Empty
+}
+
+internal fun BinaryOutput.bound(bound: LongBound) = when (bound) {
+    LongBound.NegativeInfinity -> byte(0)
+    LongBound.PositiveInfinity -> byte(1)
+    is LongBound.Finite -> { byte(2); zigzag(bound.value) }
+}
+
+internal fun BinaryInput.bound(): LongBound = when (byte()) {
+    0 -> LongBound.NegativeInfinity
+    1 -> LongBound.PositiveInfinity
+    else -> LongBound.Finite(zigzag())
+}
+
+/** @return the DD in the binary format. */
+fun DD<*>.toBinary(): ByteArray {
+    val sink = ByteArraySink()
+    DDBinaryWriter(sink).apply { write(this@toBinary); close() }
+    return sink.toByteArray()
+}
+
+/** @return the first DD of a byte array in the binary format, created by this builder. */
+fun DDBuilder.fromBinary(bytes: ByteArray): DD<*> =
+    DDBinaryReader(this, ByteArraySource(bytes)).next()?.second
+        ?: throw DDException("Binary format: no DD in stream")
@@ -11,18 +11,21 @@ import io.github.tukcps.aadd.values.real.DoubleBoundMath.max
 import io.github.tukcps.aadd.values.real.DoubleBoundMath.min
 import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
 import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.NoiseTerms
 import io.github.tukcps.aadd.values.real.ia.RealRange
 import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
 import io.github.tukcps.aadd.values.real.rounding.Rounding
 import io.github.tukcps.aadd.values.real.toDoubleBound
 import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.async
+import kotlinx.coroutines.channels.Channel
+import kotlinx.coroutines.launch
 import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
 import kotlin.math.abs
 import kotlin.math.max
 import kotlin.math.min
-import kotlin.math.nextDown
+import kotlin.time.TimeSource
 
 /**
  * ## AADD - Affine Arithmetic Decision Diagram
@@ -35,8 +38,8 @@ import kotlin.math.nextDown
  * AADD is a sealed class with the two subclasses
  * - AADD.Leaf, a leaf with a value (an AffineForm).
  * - AADD.Internal, an internal node with two child T and F.
- * AADD objects are immutable; we however do some annotations to leaves to
- * annotate state of solving LP problems.
+ * AADD objects are immutable; we however keep the range and the results of the LP solver per path computed
+ * by getRange in the root, as they do not depend on the path by which other AADD reach it.
  */
 sealed class AADD: DD<AffineForm>, NumberRange<DoubleBound> {
 
@@ -52,31 +55,58 @@ sealed class AADD: DD<AffineForm>, NumberRange<DoubleBound> {
      * @param index The index must be registered in the builder.
      * @param T The true-child
      * @param F The false-child
-     * @param status Whether the LP problem is solvable from root to this node.
+     * @param status Not solved; the results of the LP solver depend on the path and are kept by the builder.
      */
     class Internal(
         override var builder: DDBuilder,
         override var index: Int,
-        override val T: AADD,
-        override val F: AADD,
-        override var status: DD.Status = DD.Status.NotSolved,
+        T: AADD,
+        F: AADD,
+        override val status: DD.Status = DD.Status.NotSolved,
     ) : AADD(), DD.Internal<AffineForm> {
-        override val min: DoubleBound get() = min(T.min, F.min)
-        override val max: DoubleBound get() = max(T.max, F.max)
+        override var T: AADD = T
+            private set
+        override var F: AADD = F
+            private set
+
+        /** Replaces the children; only for reordering, see [Reordering]. */
+        internal fun setChildren(T: AADD, F: AADD) {
+            this.T = T
+            this.F = F
+        }
+
+        /**
+         * The range computed by [getRange] with this node as root, i.e. without conditions on the path to it.
+         * Other AADD that share the node only add conditions, which narrow its range; hence, it remains a sound bound.
+         */
+        internal var rootRange: RealRange? = null
+
+        /**
+         * The results of the LP solver for the paths from this node as root, computed by [getRange]; read by the
+         * comparisons and by [countInfeasible] and [countFeasible]. Discarded when the indexes change.
+         */
+        internal var pathResults: HashMap<PathKey, LpResultCache.Result>? = null
+
+        override val min: DoubleBound get() = rootRange?.min ?: min(T.min, F.min)
+        override val max: DoubleBound get() = rootRange?.max ?: max(T.max, F.max)
     }
 
     /**
      * A leaf has a value and a status that is of class AffineForm.
+     * Leaves are shared by all AADD with the same value; hence, they are immutable, and the results of the
+     * LP solver for the paths to a leaf are kept by the [LpResultCache] of the builder, not in the leaf.
      * @param builder the factory used for building this object
      * @param value the value, an affine form
-     * @param status the status of solving the LP problem: not solved, feasible, or infeasible.
+     * @param status infeasible for the constant Reals.Infeasible of the builder, otherwise not solved.
+     * @param solverMin lower bound known at creation, in addition to the one of the affine form.
+     * @param solverMax upper bound known at creation, in addition to the one of the affine form.
      */
     class Leaf(
         override var builder: DDBuilder,
         override val value: AffineForm,
-        override var status: DD.Status = DD.Status.NotSolved,
-        var solverMin: Double = Double.NEGATIVE_INFINITY,
-        var solverMax: Double = Double.POSITIVE_INFINITY
+        override val status: DD.Status = DD.Status.NotSolved,
+        val solverMin: Double = Double.NEGATIVE_INFINITY,
+        val solverMax: Double = Double.POSITIVE_INFINITY
     ) : AADD(), DD.Leaf<AffineForm> {
         override val index: Int get() = LEAF_INDEX
         val central get() = value.central
@@ -201,199 +231,409 @@ sealed class AADD: DD<AffineForm>, NumberRange<DoubleBound> {
      *  *  the conditions as linear constraints.
      *  *  the noise symbol's limitations to -1 to 1.
      *  *  The affine forms at the leaves as objective functions to be min/max.
-     *  It is the main entry point for solving the LP problem and not only returns the overall range of
-     *  all leaves, but also keeps the min/max values in each leaf and sets the status of the leaf.
-     *  This is done recursively and in a concurrent way by calling the function computeBounds.
+     *  It is the main entry point for solving the LP problem and returns the overall range of all leaves.
+     *  The results of the LP problems of the paths are kept in the [LpResultCache] of the builder, and the
+     *  overall range in the root, so that min and max return it after.
+     *  This is done recursively by calling the function computeBounds; with the setting lpParallelWorkers
+     *  above 1, subgraphs are distributed to that many workers by computeBoundsParallel.
      */
     fun getRange(): RealRange {
-        val height = height()
-        val indexes = IntArray(height)
-        val signs = BooleanArray(height)
-        runBlocking { computeBounds(indexes, signs, 0) }
-        return RealRange(min, max)
+        val workers = builder.settings.lpParallelWorkers
+        val results = HashMap<PathKey, LpResultCache.Result>()
+        val range = runBlocking {
+            if (workers > 1) computeBoundsParallel(workers, results)
+            else {
+                val height = height()
+                computeBounds(newLpSolver(), IntArray(height), BooleanArray(height), 0, results)
+            }
+        }
+        if (this is Internal) {
+            rootRange = range
+            pathResults = results
+        }
+        return range
+    }
+
+    /** With the setting lpIncremental, a solver that is updated from path to path; otherwise null. */
+    private fun newLpSolver(): IncrementalLpSolver? =
+        if (builder.settings.lpIncremental) IncrementalLpSolver() else null
+
+    /** Adds the condition with the given index to the incremental solver, for its true- or false-edge. */
+    private fun pushCondition(solver: IncrementalLpSolver, index: Int, ge: Boolean) {
+        val condition = builder.conditions.getConstraint(index)!!.value
+        solver.push(condition.xi.ids, condition.xi.coefficients, condition.xi.size, ge, -condition.central)
     }
 
     /**
      * Collects bounds of all leaves.
      * When the AADD is an internal node, it collects condition Xp,v on path to leave v.
-     * For each leaf, it calls callLPSolver to compute bounds.
+     * For each leaf, it computes bounds for its path by solvePath, and adds the result to results.
+     * The incremental solver gets the condition of each internal node on the way down and loses it on the
+     * way back; leaves with a common prefix of the path hence share the work of the solver for the prefix.
      * The method is called by getRange.
      */
-    private suspend fun computeBounds(indexes: IntArray, ge: BooleanArray, len: Int): RealRange {
+    private suspend fun computeBounds(
+        solver: IncrementalLpSolver?, indexes: IntArray, ge: BooleanArray, len: Int,
+        results: HashMap<PathKey, LpResultCache.Result>
+    ): RealRange {
         when (this) {
             is Leaf -> {
-                if (value.isEmpty()) return RealRange.Empty
+                if (value.isEmpty() || isInfeasible()) return RealRange.Empty
                 if (value.isFinite()
                     && indexes.isNotEmpty()
                     && value.radius > builder.settings.lpCallThreshold
-                    && status == DD.Status.NotSolved
-                )
-                    callLPSolver(indexes, ge, len)
-                return if (value.isEmpty()) RealRange.Empty
-                else RealRange(solverMin.toDoubleBound() ?: DoubleBound.NegativeInfinity,
-                    solverMax.toDoubleBound() ?: DoubleBound.PositiveInfinity)
+                ) {
+                    val path = encodePath(indexes, ge, len)
+                    val result = solvePath(solver, path, indexes, ge, len)
+                    builder.lpResultLock.withLock { results[PathKey(path, this)] = result }
+                    return boundsOn(result)
+                }
+                return RealRange(min, max)
             }
             is Internal -> {
                 if (!isBoolCond()) {
-                    var result: RealRange = RealRange.Empty
                     indexes[len] = index
-                    withContext(Dispatchers.Default) {
-                        val resT = async {
-                            val ops = ge.copyOf()
-                            ops[len] = true
-                            T.computeBounds(indexes.copyOf(), ops, len + 1)
-                        }
-                        ge[len] = false
-                        val resF = F.computeBounds(indexes, ge, len + 1)
-                        result = resT.await().join(resF)
+                    ge[len] = true
+                    solver?.let { pushCondition(it, index, true) }
+                    val resT = T.computeBounds(solver, indexes, ge, len + 1, results)
+                    solver?.pop()
+                    ge[len] = false
+                    solver?.let { pushCondition(it, index, false) }
+                    val resF = F.computeBounds(solver, indexes, ge, len + 1, results)
+                    solver?.pop()
+                    return resT.join(resF)
+                }
+                val res = T.computeBounds(solver, indexes, ge, len, results)
+                return res.join(F.computeBounds(solver, indexes, ge, len, results))
+            }
+        }
+    }
+
+    /**
+     * Collects bounds of all leaves like computeBounds, with a bounded number of workers.
+     * The AADD is split into tasks: subgraphs with at most lpParallelCutoff paths, together with the path to them.
+     * The workers take the tasks from a shared queue, so that workers that finish early take over the remaining
+     * tasks; each task is traversed sequentially, with its own incremental solver that starts with the path to it.
+     * Results do not depend on the order of the tasks: the ranges are joined, and the results of the paths
+     * are added to results and to the [LpResultCache] of the builder under its lock.
+     */
+    private suspend fun computeBoundsParallel(workers: Int, results: HashMap<PathKey, LpResultCache.Result>): RealRange {
+        val height = height()
+        val tasks = ArrayList<BoundsTask>()
+        splitBounds(tasks, HashMap(), IntArray(height), BooleanArray(height), 0)
+        val ranges = arrayOfNulls<RealRange>(tasks.size)
+        val queue = Channel<Int>(Channel.UNLIMITED)
+        for (t in tasks.indices) queue.send(t)
+        queue.close()
+        withContext(Dispatchers.Default) {
+            repeat(min(workers, tasks.size)) {
+                launch {
+                    for (t in queue) {
+                        val task = tasks[t]
+                        val solver = newLpSolver()
+                        if (solver != null)
+                            for (i in task.indexes.indices) pushCondition(solver, task.indexes[i], task.ge[i])
+                        ranges[t] = task.node.computeBounds(
+                            solver, task.indexes.copyOf(height), task.ge.copyOf(height), task.indexes.size, results)
                     }
-                    return result
                 }
-                val res = T.computeBounds(indexes, ge, len)
-                return res.join(F.computeBounds(indexes, ge, len))
             }
         }
+        var result: RealRange = RealRange.Empty
+        for (r in ranges) result = result.join(r!!)
+        return result
     }
 
-    private fun callLPSolver(indexes: IntArray, ge: BooleanArray,len: Int){
-        require(len>=0){"len of arrays must be >=1"}
+    /** A subgraph and the path to it, traversed by one worker of computeBoundsParallel. */
+    private class BoundsTask(val node: AADD, val indexes: IntArray, val ge: BooleanArray)
+
+    /** Splits the AADD into subgraphs with at most lpParallelCutoff paths. */
+    private fun splitBounds(tasks: MutableList<BoundsTask>, paths: HashMap<AADD, Long>, indexes: IntArray, ge: BooleanArray, len: Int) {
+        if (this is Leaf || countPaths(paths) <= builder.settings.lpParallelCutoff) {
+            tasks.add(BoundsTask(this, indexes.copyOf(len), ge.copyOf(len)))
+            return
+        }
+        this as Internal
+        if (!isBoolCond()) {
+            indexes[len] = index
+            ge[len] = true
+            T.splitBounds(tasks, paths, indexes, ge, len + 1)
+            ge[len] = false
+            F.splitBounds(tasks, paths, indexes, ge, len + 1)
+        } else {
+            T.splitBounds(tasks, paths, indexes, ge, len)
+            F.splitBounds(tasks, paths, indexes, ge, len)
+        }
+    }
+
+    /** Number of paths from this node to a leaf, memoized per node and saturating at Long.MAX_VALUE. */
+    private fun countPaths(paths: HashMap<AADD, Long>): Long = when (this) {
+        is Leaf -> 1L
+        is Internal -> paths.getOrPut(this) {
+            val t = T.countPaths(paths)
+            val f = F.countPaths(paths)
+            if (t > Long.MAX_VALUE - f) Long.MAX_VALUE else t + f
+        }
+    }
+
+    /**
+     * Solves the LP problem of a leaf for a path: the result is taken from the [LpResultCache] of the builder,
+     * if it has one; otherwise, it is decided by bound propagation, or computed by the incremental solver,
+     * if given, or by callLPSolver. New results are stored in the cache.
+     * The path is given as encoded by encodePath, and as the indexes and edges of length len.
+     * @return the status of the path and, if feasible, the bounds of the noise part of the leaf.
+     */
+    private suspend fun solvePath(
+        solver: IncrementalLpSolver?, path: IntArray, indexes: IntArray, ge: BooleanArray, len: Int
+    ): LpResultCache.Result {
         require(this is Leaf)
-        builder.lpCalls+=1
-        val symbols = mutableListOf<Long>()
-        /* Gathering of all noise symbols used in the constraints as well as the leaf */
-        symbols.addAll(value.xi.keys)
+        builder.lpResultLock.withLock { builder.lpResultCache.get(path, value.xi) }?.let { return it }
+        val propagation = propagateBounds(indexes, ge, len)
+        val result = propagation?.let { decideByPropagation(it) }
+            ?: if (solver != null) solveIncremental(solver, indexes, ge, len)
+            else callLPSolver(indexes, ge, len, propagation)
+        builder.lpResultLock.withLock { builder.lpResultCache.put(path, value.xi, result) }
+        return result
+    }
 
-        for (i in 0 until len) {
-            for(symbol in builder.conditions.getConstraint(indexes[i])!!.value.xi.keys){
-                if(!symbols.contains(symbol))symbols.add(symbol)
+    /** @return the bounds of the leaf on a path with the given result of the LP problem; empty if it is infeasible. */
+    private fun boundsOn(result: LpResultCache.Result): RealRange {
+        require(this is Leaf)
+        if (result.status == DD.Status.Infeasible) return RealRange.Empty
+        return RealRange(
+            max(value.min.toDouble(), IEEE754RoundingMath.add(value.central, result.min, Rounding.DOWN)),
+            min(value.max.finiteValue, IEEE754RoundingMath.add(value.central, result.max, Rounding.UP))
+        )
+    }
+
+    /**
+     * Computes the bounds of a leaf with the incremental solver that holds the conditions of its path.
+     * If the solver does not converge, the leaf keeps the bounds of its affine form; solving from scratch
+     * would run the same bounded simplex and not converge either.
+     */
+    private fun solveIncremental(solver: IncrementalLpSolver, indexes: IntArray, ge: BooleanArray, len: Int): LpResultCache.Result {
+        require(this is Leaf)
+        val xi = value.xi
+        val start = TimeSource.Monotonic.markNow()
+        val pivots = solver.pivots
+        when (solver.verdict) {
+            IncrementalLpSolver.Verdict.INFEASIBLE -> {
+                builder.statistics.lpSolved(start, 0L)
+                return LpResultCache.Result.Infeasible
+            }
+            IncrementalLpSolver.Verdict.FEASIBLE -> {
+                val maxSolution = solver.maximize(xi.ids, xi.coefficients, xi.size)
+                val minSolution = if (maxSolution == null) null else solver.minimize(xi.ids, xi.coefficients, xi.size)
+                builder.statistics.lpSolved(start, solver.pivots - pivots)
+                if (maxSolution != null && minSolution != null)
+                    return LpResultCache.Result(DD.Status.Feasible, minSolution, maxSolution)
             }
+            IncrementalLpSolver.Verdict.FAILED -> builder.statistics.lpSolved(start, 0L)
         }
+        return LpResultCache.Result.Failed
+    }
 
-        /* Create the LP Variable objects used */
-        val constraints = mutableListOf<LpConstraint>() // List tracking all LPConstraints
-        /* Create an LP Variable for all the symbols found in the 'symbols' list */
-        val variables = mutableMapOf<Long, LpVariable>()
-        for(symbol in symbols) {
-            variables[symbol] = LpVariable("$symbol",canBeNegative = true)
+    /**
+     * Encodes a path as signed indexes: the index of a condition for the true-edge,
+     * its inverse (a negative number) for the false-edge.
+     */
+    private fun encodePath(indexes: IntArray, ge: BooleanArray, len: Int): IntArray =
+        IntArray(len) { if (ge[it]) indexes[it] else indexes[it].inv() }
+
+    /**
+     * Runs the bound propagation over the conditions of a path, if enabled by the setting lpBoundPropagation.
+     * @return the propagation, or null if disabled.
+     */
+    private fun propagateBounds(indexes: IntArray, ge: BooleanArray, len: Int): BoundPropagation? {
+        if (!builder.settings.lpBoundPropagation) return null
+        val propagation = BoundPropagation()
+        for (i in 0 until len) {
+            val condition = builder.conditions.getConstraint(indexes[i])!!.value
+            propagation.addRow(condition.xi.ids, condition.xi.coefficients, condition.xi.size, ge[i], -condition.central)
+        }
+        propagation.propagate()
+        return propagation
+    }
+
+    /**
+     * Decides the LP problem of a leaf if the bound propagation decided its path: infeasible, or bounded without
+     * any remaining condition.
+     * @return the result, or null if the LP solver is needed.
+     */
+    private fun decideByPropagation(propagation: BoundPropagation): LpResultCache.Result? {
+        require(this is Leaf)
+        val result = when (propagation.verdict) {
+            BoundPropagation.Verdict.INFEASIBLE -> LpResultCache.Result.Infeasible
+            BoundPropagation.Verdict.BOUNDED -> LpResultCache.Result(DD.Status.Feasible,
+                propagation.minimize(value.xi.ids, value.xi.coefficients, value.xi.size),
+                propagation.maximize(value.xi.ids, value.xi.coefficients, value.xi.size))
+            BoundPropagation.Verdict.UNDECIDED -> return null
         }
+        builder.statistics.lpAvoided()
+        return result
+    }
 
-        /* Create noise symbol constraints -1 <= epsilon <= 1*/
-        for((_, variable) in variables) {
-            val upperNoiseConstraint = LpConstraint(LpExpression(mapOf(variable to 1.0)), LpConstraintSign.LESS_OR_EQUAL ,1.0 ) // x <= 1.0
-            val lowerNoiseConstraint = LpConstraint(LpExpression(mapOf(variable to 1.0)), LpConstraintSign.GREATER_OR_EQUAL , -1.0 )// x >= -1.0
-            constraints.add(upperNoiseConstraint)
-            constraints.add(lowerNoiseConstraint)
+    /**
+     * Solves the LP problem of a leaf from scratch.
+     * Conditions that the bound propagation found redundant are not passed to the solver.
+     */
+    private fun callLPSolver(indexes: IntArray, ge: BooleanArray, len: Int, propagation: BoundPropagation? = null): LpResultCache.Result {
+        require(len>=0){"len of arrays must be >=1"}
+        require(this is Leaf)
+        val start = TimeSource.Monotonic.markNow()
+        val conditions = List(len) { builder.conditions.getConstraint(indexes[it])!!.value }
+        /* Gathering of all noise symbols used in the constraints as well as the leaf, by merging the sorted noise terms */
+        val symbols = NoiseTerms.unionOfIds((conditions + value).map { it.xi })
+
+        /* Create an LP Variable for all the symbols found in the 'symbols' list; their bounds -1 <= epsilon <= 1 are handled by the solver */
+        val variables = HashMap<Long, LpVariable>(symbols.size)
+        for(symbol in symbols) {
+            variables[symbol] = LpVariable("$symbol",canBeNegative = true)
         }
 
         /* Create constraints based on the path set */
+        val constraints = ArrayList<LpConstraint>(len)
         for(i in 0 until len) {
-            val condition = builder.conditions.getConstraint(indexes[i])!!
-            val coefficientVarMap = mutableMapOf<LpVariable,Double>()
-            for((symbolKey, value1) in condition.value.xi) {
-                coefficientVarMap[variables[symbolKey]!!] = value1
-            }
-            // Case none inverted
-            if(ge[i]) {
-                val pathConstraint = LpConstraint(LpExpression(coefficientVarMap),LpConstraintSign.GREATER_OR_EQUAL,-condition.value.central)
-                constraints.add(pathConstraint)
-            } // Case inverted
-            else {
-                val pathConstraint = LpConstraint(LpExpression(coefficientVarMap),LpConstraintSign.LESS_OR_EQUAL,-condition.value.central)
-                constraints.add(pathConstraint)
+            if (propagation?.isRedundant(i) == true) continue
+            val condition = conditions[i]
+            val coefficientVarMap = LinkedHashMap<LpVariable,Double>(condition.xi.size)
+            for(k in 0 until condition.xi.size) {
+                coefficientVarMap[variables[condition.xi.idAt(k)]!!] = condition.xi.coefficientAt(k)
             }
+            val sign = if (ge[i]) LpConstraintSign.GREATER_OR_EQUAL else LpConstraintSign.LESS_OR_EQUAL
+            constraints.add(LpConstraint(LpExpression(coefficientVarMap), sign, -condition.central))
         }
-        /* Create the actual LP Problem */
 
-        /* Create the optimization function which is the leaf on which this function is called */
-        val coefficientVarMap = mutableMapOf<LpVariable,Double>() // Map of the LpVariable object to its coefficient in the leaf affine form
-        for((symbolKey, value1) in value.xi) {
-            coefficientVarMap[variables[symbolKey]!!] = value1
+        /* The function to min/max is the noise part of the leaf on which this function is called; the central value is added with directed rounding */
+        val coefficientVarMap = LinkedHashMap<LpVariable,Double>(value.xi.size)
+        for(k in 0 until value.xi.size) {
+            coefficientVarMap[variables[value.xi.idAt(k)]!!] = value.xi.coefficientAt(k)
         }
 
-        val optfMaximize = LpFunction(LpExpression(coefficientVarMap,value.central),LpFunctionOptimization.MAXIMIZE)
-        val optfMinimize = LpFunction(LpExpression(coefficientVarMap,value.central),LpFunctionOptimization.MINIMIZE)
-
-        /* Create the Lp Problem object to solve. Consists out of the path constraints, variable constraitns and the optimization functions */
-        val maxProblem = LpProblem(variables.values.toList(),constraints,optfMaximize)
-        val minProblem = LpProblem(variables.values.toList(),constraints,optfMinimize)
-
-        try {
-            val maxSolution = solve(maxProblem)
-            if(maxSolution == NoSolution) throw NoSolutionException()
-            if(maxSolution == Unbounded) throw UnboundedException()
-
-            val minSolution = solve(minProblem)
-            if(minSolution == NoSolution) throw NoSolutionException()
-            if(minSolution == Unbounded) throw UnboundedException()
-
-            status = DD.Status.Feasible
-            solverMax = min(value.max.finiteValue, (maxSolution as Solved).functionValue)
-            // TODO: Fix LP solver for min!
-            var computedMinSolution = value.central.nextDown()
-            for((symbolValueKey, symbolValueValue) in (minSolution as Solved).variablesValues) {
-                if(value.xi.contains(symbolValueKey.name.toLong())) {
-                    computedMinSolution =
-                        IEEE754RoundingMath.add(
-                            IEEE754RoundingMath.mul(value.xi[symbolValueKey.name.toLong()]!!, symbolValueValue, Rounding.DOWN),
-                            computedMinSolution, Rounding.DOWN)
-                }
-            }
-            solverMin = max(value.min.toDouble(), computedMinSolution)
-
-        } catch(e:NoSolutionException) {
-            status = DD.Status.Infeasible
-            solverMax = builder.AF.Empty.max.toDouble()
-            solverMin = builder.AF.Empty.min.toDouble()
-        } catch(e:UnboundedException){
-            throw RuntimeException("AADD-Error: unbounded solution; maybe numerical issue in Simplex. Check Simplex cutoff & other params.")
+        var pivots = 0L
+        val solution = solveMinMax(constraints, LpExpression(coefficientVarMap), engine = builder.settings.lpSolverEngine) { pivots = it }
+        builder.statistics.lpSolved(start, pivots)
+        return when (solution) {
+            is SolvedMinMax -> LpResultCache.Result(DD.Status.Feasible, solution.min, solution.max)
+            NoSolution -> LpResultCache.Result.Infeasible
+            // Not converged: the bounds of the affine form remain sound.
+            else -> LpResultCache.Result.Failed
         }
     }
 
     /**
      * Creates a BDD, depending on the result of a comparison.
      * The result can either be True, False, or unknown, in which case we add a new level to the BDD.
+     * If getRange has solved the LP problems of the paths of this AADD, each leaf is compared with its bounds
+     * on the path, and a path found infeasible results in Bool.Infeasible. As these results depend on the
+     * path, they are not cached; otherwise, the results of the nodes are cached for this root.
      * @param op
      * @return A BDD, set up recursively.
      */
     private fun checkObjective(op: String): BDD {
-        when(this) {
-            is Leaf -> {
-                // Stop of recursion, comparison of Range/AF with 0.
-                if (isInfeasible() || value.isEmpty())
-                    return builder.Bool.Infeasible
-
-                when (op) {
-                    ">=" -> {
-                        if (value.min.toDouble() > 0.0 || abs(value.min.toDouble()) < 2 * Double.MIN_VALUE) return builder.Bool.True
-                        if (value.max.toDouble() < 0.0) return builder.Bool.False
-                    }
-                    ">" -> {
-                        if (value.min.toDouble() > 0.0) return builder.Bool.True
-                        if (value.max.toDouble() < 0.0 || abs(value.max.toDouble()) < 2 * Double.MIN_VALUE) return builder.Bool.False
-                    }
-                    "<=" -> {
-                        if (value.min.toDouble() > 0.0) return builder.Bool.False
-                        if (value.max.toDouble() < 0.0 || abs(value.max.toDouble()) < 2 * Double.MIN_VALUE) return builder.Bool.True
-                    }
-                    "<" -> {
-                        if (value.min.toDouble() > 0.0 || abs(value.min.toDouble()) < 2 * Double.MIN_VALUE) return builder.Bool.False
-                        if (value.max.toDouble() < 0.0) return builder.Bool.True
-                    }
-                }
-                return if (op == ">=" || op == ">")
-                    builder.internal(builder.conditions.newConstraint(value),
-                        builder.Bool.True, builder.Bool.False
-                )
-                else
-                    builder.internal(builder.conditions.newConstraint(value),
-                        builder.Bool.False, builder.Bool.True)
+        val results = (this as? Internal)?.pathResults ?: return checkObjective(op, this)
+        val height = height()
+        return checkObjectiveOnPath(op, results, IntArray(height), BooleanArray(height), 0)
+    }
+
+    private fun checkObjective(op: String, root: AADD): BDD =
+        // New conditions are ordered after all existing ones; hence, results are only reused for the same root.
+        builder.operationCache.getOrPut(op, this, root) {
+            when (this) {
+                is Leaf -> compareWithZero(op, null)
+                is Internal -> builder.internal(index, T.checkObjective(op, root), F.checkObjective(op, root))
             }
-            is Internal -> {
-                /* Recursion step. */
-                val tr: BDD = T.checkObjective(op)
-                val fr: BDD = F.checkObjective(op)
-                return builder.internal(index, tr, fr)
+        }
+
+    private fun checkObjectiveOnPath(
+        op: String, results: Map<PathKey, LpResultCache.Result>, indexes: IntArray, ge: BooleanArray, len: Int
+    ): BDD = when (this) {
+        is Leaf -> compareWithZero(op, results[PathKey(encodePath(indexes, ge, len), this)])
+        is Internal -> if (isBoolCond())
+            builder.internal(index,
+                T.checkObjectiveOnPath(op, results, indexes, ge, len),
+                F.checkObjectiveOnPath(op, results, indexes, ge, len))
+        else {
+            indexes[len] = index
+            ge[len] = true
+            val tr = T.checkObjectiveOnPath(op, results, indexes, ge, len + 1)
+            ge[len] = false
+            val fr = F.checkObjectiveOnPath(op, results, indexes, ge, len + 1)
+            builder.internal(index, tr, fr)
+        }
+    }
+
+    /**
+     * Stop of recursion, comparison of a leaf with 0.
+     * @param result the result of the LP solver for the path to the leaf, if known.
+     */
+    private fun compareWithZero(op: String, result: LpResultCache.Result?): BDD {
+        require(this is Leaf)
+        if (isInfeasible() || value.isEmpty() || result?.status == DD.Status.Infeasible)
+            return builder.Bool.Infeasible
+        val bounds = if (result == null) RealRange(value.min, value.max) else boundsOn(result)
+        val min = bounds.min.toDouble()
+        val max = bounds.max.toDouble()
+
+        when (op) {
+            ">=" -> {
+                if (min > 0.0 || abs(min) < 2 * Double.MIN_VALUE) return builder.Bool.True
+                if (max < 0.0) return builder.Bool.False
+            }
+            ">" -> {
+                if (min > 0.0) return builder.Bool.True
+                if (max < 0.0 || abs(max) < 2 * Double.MIN_VALUE) return builder.Bool.False
+            }
+            "<=" -> {
+                if (min > 0.0) return builder.Bool.False
+                if (max < 0.0 || abs(max) < 2 * Double.MIN_VALUE) return builder.Bool.True
             }
+            "<" -> {
+                if (min > 0.0 || abs(min) < 2 * Double.MIN_VALUE) return builder.Bool.False
+                if (max < 0.0) return builder.Bool.True
+            }
+        }
+        return if (op == ">=" || op == ">")
+            builder.internal(builder.conditions.newConstraint(value),
+                builder.Bool.True, builder.Bool.False
+        )
+        else
+            builder.internal(builder.conditions.newConstraint(value),
+                builder.Bool.False, builder.Bool.True)
+    }
+
+    /**
+     * @return the number of paths to an infeasible leaf; after getRange, including the paths that
+     * the LP solver found infeasible.
+     */
+    override fun countInfeasible(): Long = countSolvedPaths(true) ?: super.countInfeasible()
+
+    /** @return the number of paths to a feasible leaf; after getRange, without those found infeasible. */
+    override fun countFeasible(): Long = countSolvedPaths(false) ?: super.countFeasible()
+
+    /** Number of paths that are (not) infeasible by the results of getRange; null if there are none. */
+    private fun countSolvedPaths(infeasible: Boolean): Long? {
+        val results = (this as? Internal)?.pathResults ?: return null
+        val height = height()
+        return countSolvedPaths(infeasible, results, IntArray(height), BooleanArray(height), 0)
+    }
+
+    private fun countSolvedPaths(
+        infeasible: Boolean, results: Map<PathKey, LpResultCache.Result>, indexes: IntArray, ge: BooleanArray, len: Int
+    ): Long = when (this) {
+        is Leaf -> {
+            val found = isInfeasible() ||
+                results[PathKey(encodePath(indexes, ge, len), this)]?.status == DD.Status.Infeasible
+            if (found == infeasible) 1L else 0L
+        }
+        is Internal -> {
+            val next = if (isBoolCond()) len else len + 1
+            indexes[len] = index
+            ge[len] = true
+            val t = T.countSolvedPaths(infeasible, results, indexes, ge, next)
+            ge[len] = false
+            val f = F.countSolvedPaths(infeasible, results, indexes, ge, next)
+            if (t > Long.MAX_VALUE - f) Long.MAX_VALUE else t + f
         }
     }
 
@@ -413,8 +653,8 @@ sealed class AADD: DD<AffineForm>, NumberRange<DoubleBound> {
 
     /** Method that returns a brief String representation of the NumberRange interface */
     override fun toString(): String {
-        getRange()
-        return if (isInfeasible()) "Infeasible" else getRange().toString()
+        val range = getRange()
+        return if (isInfeasible() || this is Internal && countFeasible() == 0L) "Infeasible" else range.toString()
     }
 
     /**
@@ -423,4 +663,15 @@ sealed class AADD: DD<AffineForm>, NumberRange<DoubleBound> {
      * */
     @Suppress("RedundantOverride")
     override fun toIteString() : String { return super.toIteString() }
-}
\ No newline at end of file
+}
+
+/**
+ * A path from the root of an AADD to a leaf, encoded as signed indexes of the conditions by encodePath.
+ * Paths that differ only in Boolean variables are told apart by the leaf.
+ */
+internal class PathKey(val path: IntArray, val leaf: AADD.Leaf) {
+    private val hash = 31 * path.contentHashCode() + leaf.hashCode()
+    override fun equals(other: Any?): Boolean =
+        other is PathKey && hash == other.hash && leaf === other.leaf && path.contentEquals(other.path)
+    override fun hashCode(): Int = hash
+}
@@ -11,16 +11,20 @@ import io.github.tukcps.aadd.values.real.aa.AffineForm
  */
 fun AADD.applySplit(function: (AffineForm) -> AADD): AADD = when(this) {
     is Leaf -> if (isInfeasible()) infeasible else function(this.value)
-    is Internal -> builder.internal(index, T.applySplit(function), F.applySplit(function))
+    is Internal -> builder.operationCache.getOrPut(function, this) {
+        builder.internal(index, T.applySplit(function), F.applySplit(function))
+    }
 }
 
 fun AADD.apply(function: (AffineForm) -> AffineForm): AADD = when(this) {
     is Leaf -> if (isInfeasible()) infeasible else builder.leaf(function(this.value))
-    is Internal -> builder.internal(index, T.apply(function), F.apply(function))
+    is Internal -> builder.operationCache.getOrPut(function, this) {
+        builder.internal(index, T.apply(function), F.apply(function))
+    }
 }
 
 fun AADD.apply(other: AADD, op: (AffineForm, AffineForm) -> AffineForm): AADD =
-    applyGeneric(other) { a: AffineForm, b: AffineForm -> op(a, b) }
+    applyGeneric<AffineForm, AADD>(other, op)
 
 fun AADD.applySplit(other: AADD, op: (AffineForm, AffineForm) -> AADD): AADD =
     applySplitGeneric(other, op)
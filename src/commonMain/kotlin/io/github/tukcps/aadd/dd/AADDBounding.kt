@@ -0,0 +1,130 @@
+package io.github.tukcps.aadd.dd
+
+import io.github.tukcps.aadd.dd.AADD.Internal
+import io.github.tukcps.aadd.dd.AADD.Leaf
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.aa.AffineForm
+import kotlin.math.max
+
+/**
+ * Bounds the number of leaves (paths) of an AADD by merging leaves.
+ * While there are more than maxLeaves leaves, the internal node with two leaves whose join increases
+ * the width of the range least is replaced by a leaf with the join of both.
+ * The join encloses both affine forms; hence, the result encloses this AADD.
+ * Leaves that are infeasible or empty when created are dropped without loss.
+ *
+ * The merges are done in one pass: the nodes with two leaves are kept in a priority queue by their loss,
+ * which is computed from the joined affine form; only the leaves of the chosen merges are created.
+ * A merge makes its parents candidates once their other child is a leaf as well.
+ * The number of merges and the increase of the widths are added to [io.github.tukcps.aadd.DDBuilder.leafMerges]
+ * and [io.github.tukcps.aadd.DDBuilder.leafMergeLoss].
+ * @param maxLeaves the maximum number of leaves; 0 leaves this AADD unchanged.
+ * @return an AADD with at most maxLeaves leaves that encloses this.
+ */
+fun AADD.bounded(maxLeaves: Int = builder.settings.ddMaxLeaves): AADD {
+    if (maxLeaves <= 0 || this !is Internal) return this
+    var leaves = countLeaves()
+    if (leaves <= maxLeaves) return this
+
+    // The internal nodes with parents before children, their parents, and the number of paths reaching them.
+    val order = ArrayList<Internal>()
+    fold({ }) { node, _, _ -> order.add(node as Internal); Unit }
+    order.reverse()
+    val parents = HashMap<NodeKey, ArrayList<Internal>>()
+    val reaching = HashMap<NodeKey, Long>()
+    reaching[NodeKey(this)] = 1L
+    for (node in order) {
+        val paths = reaching.getValue(NodeKey(node))
+        for (child in listOf(node.T, node.F)) if (child is Internal) {
+            val key = NodeKey(child)
+            val sum = reaching[key] ?: 0L
+            reaching[key] = if (sum > Long.MAX_VALUE - paths) Long.MAX_VALUE else sum + paths
+            parents.getOrPut(key) { ArrayList() }.add(node)
+        }
+    }
+
+    val merged = HashMap<NodeKey, Leaf>()
+    val queued = HashSet<NodeKey>()
+    val queue = MergeQueue()
+    fun current(child: AADD): Leaf? = if (child is Leaf) child else merged[NodeKey(child)]
+    fun enqueue(node: Internal) {
+        val t = current(node.T) ?: return
+        val f = current(node.F) ?: return
+        if (queued.add(NodeKey(node))) queue.add(merge(node, t, f))
+    }
+    for (node in order) enqueue(node)
+
+    while (leaves > maxLeaves && queue.isNotEmpty()) {
+        val next = queue.poll()
+        merged[NodeKey(next.node)] = next.kept ?: builder.leaf(next.joined!!)
+        builder.statistics.leafMerged(next.loss)
+        leaves -= reaching.getValue(NodeKey(next.node))
+        parents[NodeKey(next.node)]?.forEach { enqueue(it) }
+    }
+    return fold({ it as AADD }) { node, t, f ->
+        merged[NodeKey(node)] ?: when {
+            t === node.T && f === node.F -> node as AADD
+            else -> builder.internal(node.index, t, f)
+        }
+    }
+}
+
+/**
+ * A merge of the two leaves of a node: either one leaf is kept, as the other one is infeasible or empty,
+ * or the leaves are joined; loss is the increase of the width of the range.
+ */
+private class Merge(val node: Internal, val kept: Leaf?, val joined: AffineForm?, val loss: Double)
+
+/** The merge of the leaves t and f of node; the status of a leaf is the one given at its creation. */
+private fun merge(node: Internal, t: Leaf, f: Leaf): Merge = when {
+    t.isInfeasible() || t.value.isEmpty() -> Merge(node, f, null, 0.0)
+    f.isInfeasible() || f.value.isEmpty() -> Merge(node, t, null, 0.0)
+    else -> {
+        val joined = t.value.join(f.value)
+        val loss = width(joined) - max(width(t.value), width(f.value))
+        Merge(node, null, joined, if (loss.isNaN()) 0.0 else max(loss, 0.0))
+    }
+}
+
+private fun width(af: AffineForm): Double = af.max.toDouble() - af.min.toDouble()
+
+/** Binary min-heap of merges by their loss. */
+private class MergeQueue {
+    private val heap = ArrayList<Merge>()
+
+    fun isNotEmpty() = heap.isNotEmpty()
+
+    fun add(merge: Merge) {
+        heap.add(merge)
+        var i = heap.size - 1
+        while (i > 0) {
+            val parent = (i - 1) / 2
+            if (heap[parent].loss <= heap[i].loss) break
+            swap(i, parent)
+            i = parent
+        }
+    }
+
+    fun poll(): Merge {
+        val first = heap[0]
+        val last = heap.removeAt(heap.size - 1)
+        if (heap.isEmpty()) return first
+        heap[0] = last
+        var i = 0
+        while (true) {
+            val left = 2 * i + 1
+            if (left >= heap.size) break
+            val child = if (left + 1 < heap.size && heap[left + 1].loss < heap[left].loss) left + 1 else left
+            if (heap[i].loss <= heap[child].loss) break
+            swap(i, child)
+            i = child
+        }
+        return first
+    }
+
+    private fun swap(i: Int, j: Int) {
+        val h = heap[i]
+        heap[i] = heap[j]
+        heap[j] = h
+    }
+}
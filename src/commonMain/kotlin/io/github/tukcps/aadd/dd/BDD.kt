@@ -49,14 +49,37 @@ sealed class BDD: DD<XBool>, XBool {
      */
     class Internal(
         override var builder: DDBuilder,
-        override val index: Int = LEAF_INDEX,
-        override val T: BDD,
-        override val F: BDD,
+        override var index: Int = LEAF_INDEX,
+        T: BDD,
+        F: BDD,
         override val status: DD.Status = DD.Status.NotSolved
     ) : BDD(), DD.Internal<XBool>
     {
         override val value: XBool = XBool.All
 
+        override var T: BDD = T
+            private set
+        override var F: BDD = F
+            private set
+
+        /** Cached, as the children are shared by many nodes. */
+        private var hash: Int = T.hashCode() + F.hashCode()
+        override fun hashCode(): Int = hash
+
+        /**
+         * Replaces the children; only for reordering, see [Reordering].
+         * The hash is kept until [updateHash], so that the keys of the parents remain valid during the reordering.
+         */
+        internal fun setChildren(T: BDD, F: BDD) {
+            this.T = T
+            this.F = F
+        }
+
+        /** Recomputes the cached hash after the children or their hashes have changed. */
+        internal fun updateHash() {
+            hash = T.hashCode() + F.hashCode()
+        }
+
         /** Clone provides a deep copy of a BDD;
          * reduces, and leaves remain references of ONE and ZERO. */
         override fun clone(): BDD = builder.internal(index, T, F)
@@ -124,7 +147,9 @@ sealed class BDD: DD<XBool>, XBool {
      */
     fun apply(function: Leaf.() -> Leaf): BDD = when(this) {
         is Leaf     -> function(this)
-        is Internal -> builder.internal(index, T.apply(function), F.apply(function))
+        is Internal -> builder.operationCache.getOrPut(function, this) {
+            builder.internal(index, T.apply(function), F.apply(function))
+        }
     }
 
     /** Binary Operations BDD x BDD -> BDD */
@@ -169,7 +194,7 @@ sealed class BDD: DD<XBool>, XBool {
         this === builder.Bool.Empty -> builder.Bool.Empty
         this === builder.Bool.True -> t
         this === builder.Bool.False -> e
-        else -> (this and t) or (this.not() and e)
+        else -> builder.operationCache.getOrPut(Ite, this, t, e) { (this and t) or (this.not() and e) }
     }
 
     /**
@@ -181,7 +206,7 @@ sealed class BDD: DD<XBool>, XBool {
         this === empty -> builder.Reals.Infeasible
         this === one   -> t.clone()
         this === zero  -> e.clone()
-        else -> t.timesBDD(this) + e.timesBDD(this.not())
+        else -> builder.operationCache.getOrPut(Ite, this, t, e) { t.timesBDD(this) + e.timesBDD(this.not()) }
     }
 
     /**
@@ -193,7 +218,7 @@ sealed class BDD: DD<XBool>, XBool {
         this === builder.Bool.Empty -> builder.Integers.Infeasible
         this === builder.Bool.True -> t.clone()
         this === builder.Bool.False -> e.clone()
-        else -> t.timesBDD(this) + e.timesBDD(this.not())
+        else -> builder.operationCache.getOrPut(Ite, this, t, e) { t.timesBDD(this) + e.timesBDD(this.not()) }
     }
 
     /**
@@ -203,23 +228,23 @@ sealed class BDD: DD<XBool>, XBool {
         this === builder.Bool.Empty -> builder.Strings.Infeasible
         this === builder.Bool.True -> t.clone()
         this === builder.Bool.False -> e.clone()
-        else -> (t * this) + (e * this.not())
+        else -> builder.operationCache.getOrPut(Ite, this, t, e) { (t * this) + (e * this.not()) }
     }
 
-    /** Returns the number of leaves that hold the value true (SAT). */
-    fun numTrue(): Int = when(this) {
-        is Leaf -> if (this === builder.Bool.True) 1 else 0
-        is Internal -> T.numTrue() + F.numTrue()
-    }
+    /** Returns the number of leaves that hold the value true (SAT); saturates at Int.MAX_VALUE. */
+    fun numTrue(): Int = countTrue().toSaturatedInt()
 
-    /** Returns true if BDD satisfiable (numTrue >= 1). */
-    fun satisfiable(): Boolean = numTrue() >= 1
+    /** Returns true if BDD satisfiable (numTrue >= 1); stops at the first leaf True. */
+    fun satisfiable(): Boolean = anyNode { it === builder.Bool.True }
 
-    /** Returns the number of leaves that hold the value false (UnSAT). */
-    fun numFalse(): Int = when(this) {
-        is Leaf -> if (this === builder.Bool.False) 1 else 0
-        is Internal -> T.numFalse() + F.numFalse()
-    }
+    /** Returns the number of leaves that hold the value false (UnSAT); saturates at Int.MAX_VALUE. */
+    fun numFalse(): Int = countFalse().toSaturatedInt()
+
+    /** Returns the number of paths to the leaf True, in time linear in the number of nodes; saturates at Long.MAX_VALUE. */
+    fun countTrue(): Long = countPaths { it === builder.Bool.True }
+
+    /** Returns the number of paths to the leaf False; saturates at Long.MAX_VALUE. */
+    fun countFalse(): Long = countPaths { it === builder.Bool.False }
 
 
     /**
@@ -245,3 +270,6 @@ sealed class BDD: DD<XBool>, XBool {
         }
     }
 }
+
+/** Operation id of the ITE functions in the operation cache. */
+private object Ite
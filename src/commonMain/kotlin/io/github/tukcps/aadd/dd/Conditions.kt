@@ -28,12 +28,25 @@ class Conditions(
 ) {
 
     val conditions: HashMap<Int, DD<*>> get() = x
+
+    /** Number of conditions created since the last [collect]. */
+    private var createdSinceCollect: Int = 0
+
+    /**
+     * Number of changes of existing conditions by [move], [setVariable] or [constrainVariable];
+     * an incremental [io.github.tukcps.aadd.dao.Checkpoint] only writes new conditions if it is unchanged.
+     */
+    internal var epoch: Int = 0
+        private set
+
     /**
      * Adds a constraint in form of an affine form.
      * @return index of the new condition.
      */
     fun newConstraint(c: AffineForm, id: String = ""): Int {
         ++topIndex
+        createdSinceCollect++
+        builder.statistics.conditionCreated()
         x[topIndex] = AADD.Leaf(builder, c)
         indexes[if (id == "") "var$topIndex" else id] = topIndex
         return topIndex
@@ -47,6 +60,8 @@ class Conditions(
      */
     fun newConstraint(c: IntegerRange, id: String = ""): Int {
         ++topIndex
+        createdSinceCollect++
+        builder.statistics.conditionCreated()
         x[topIndex] = IDD.Leaf(builder, c)
         indexes[if (id == "") "var$topIndex" else id] = topIndex
         return topIndex
@@ -62,6 +77,8 @@ class Conditions(
         if (x[indexes[name]] is AADD)
             throw DDInternalError("Index belongs to constraint, not variable")
         ++topIndex
+        createdSinceCollect++
+        builder.statistics.conditionCreated()
         indexes[if (name == "") "var$topIndex" else name] = topIndex
         val tmpName = if (name == "") "var$topIndex" else name
         x[topIndex] = builder.Bool.All
@@ -82,6 +99,8 @@ class Conditions(
         if (index == null) throw DDInternalError("Variable not found: $name")
         else {
             x[index] = dd
+            epoch++
+            builder.operationCache.invalidate()
         }
     }
 
@@ -147,6 +166,90 @@ class Conditions(
         assert(x[i] != null)
         assert(x[i] is BDD.Leaf)
         x[i] = v
+        epoch++
+        builder.operationCache.invalidate()
+    }
+
+    /**
+     * Removes the conditions that are not referenced by an internal node of a DD that is reachable by the builder,
+     * and renumbers the remaining ones into the dense range btmIndex+1..topIndex, preserving their order;
+     * hence, the DD remain ordered. Conditions with a name given by the user are kept.
+     * Generated names "var<index>" are renamed to the new index.
+     *
+     * The indexes of the internal nodes are changed in place, and the unique table is rehashed.
+     * Liveness is taken from the nodes in the unique table that have not been collected; the operation cache is
+     * dropped before, as its entries would keep nodes alive. The results of the LP solver per path, which depend
+     * on the indexes, are discarded; the range that getRange keeps in the root does not depend on them and remains valid.
+     * Indexes held outside of the DD of the builder are not valid afterwards.
+     * Must not be called during an operation or getRange(); requires [DDBuilderSettings.ddUniqueTable].
+     * @return the number of removed conditions.
+     */
+    fun collect(): Int {
+        createdSinceCollect = 0
+        if (!builder.settings.ddUniqueTable) return 0
+
+        // The entries of the operation cache would keep nodes alive that are not used elsewhere.
+        builder.operationCache.invalidate()
+        val live = HashSet<Int>()
+        builder.uniqueTable.forEachNode { if (it is DD.Internal<*>) live.add(it.index) }
+        for ((name, index) in indexes)
+            if (name != "var$index") live.add(index)
+        val kept = live.sorted()
+        val newIndex = HashMap<Int, Int>(kept.size * 2)
+        kept.forEachIndexed { k, index -> newIndex[index] = btmIndex + 1 + k }
+
+        builder.uniqueTable.forEachNode { if (it is DD.Internal<*>) it.index = newIndex.getValue(it.index) }
+
+        val size = x.size
+        move(newIndex)
+        val removed = size - x.size
+        topIndex = btmIndex + kept.size
+        builder.statistics.conditionsCollected(removed)
+
+        builder.uniqueTable.rehash()
+        builder.discardPathResults()
+        return removed
+    }
+
+    /**
+     * Moves the conditions to new indexes; conditions without a new index are removed.
+     * Generated names "var<index>" are renamed to the new index. The DD are not changed.
+     */
+    internal fun move(newIndex: Map<Int, Int>) {
+        epoch++
+        val oldX = x
+        x = HashMap(newIndex.size * 2)
+        for ((index, condition) in oldX)
+            newIndex[index]?.let { x[it] = condition }
+
+        val newName = HashMap<String, String>()
+        val oldIndexes = indexes
+        indexes = HashMap(newIndex.size * 2)
+        for ((name, index) in oldIndexes) {
+            val renumbered = newIndex[index] ?: continue
+            val renamed = if (name == "var$index") "var$renumbered" else name
+            newName[name] = renamed
+            indexes[renamed] = renumbered
+        }
+        introducedDecVars = HashMap(introducedDecVars.entries
+            .filter { it.key in newName }.associate { newName.getValue(it.key) to it.value })
+        isDecVar = HashMap(isDecVar.entries
+            .filter { it.key in newName }.associate { newName.getValue(it.key) to it.value })
+        val oldDecVarsIntroducedBy = decVarsIntroducedBy
+        decVarsIntroducedBy = HashMap()
+        for ((expression, names) in oldDecVarsIntroducedBy) {
+            val renamed = names.mapNotNullTo(HashSet()) { newName[it] }
+            if (renamed.isNotEmpty()) decVarsIntroducedBy[expression] = renamed
+        }
+    }
+
+    /**
+     * Calls [collect] if more than [DDBuilderSettings.conditionsCollectInterval] conditions
+     * have been created since the last one; called by the builder between operations.
+     */
+    internal fun collectIfDue() {
+        val interval = builder.settings.conditionsCollectInterval
+        if (interval > 0 && createdSinceCollect > interval) collect()
     }
 
     fun <K, V> HashMap<K, V>.getKey(value: V) =
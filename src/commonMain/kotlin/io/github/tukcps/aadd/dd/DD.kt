@@ -46,6 +46,8 @@ sealed interface DD<ValueType: ScalarValue> {
      * The condition is accessed via index.
      */
     sealed interface Internal<ValueType : ScalarValue>: DD<ValueType> {
+        /** Mutable, as the indexes of the conditions are compacted by Conditions.collect(). */
+        override var index: Int
         val T: DD<ValueType>
         val F: DD<ValueType>
     }
@@ -77,29 +79,29 @@ sealed interface DD<ValueType: ScalarValue> {
     val one: Leaf<ValueType>
     val all: Leaf<ValueType>
 
-    /** @return the number of leaves.  */
-    fun numLeaves(): Int = when(this) {
-        is Leaf<ValueType> -> 1
-        is Internal<ValueType> ->  T.numLeaves() + F.numLeaves()
-    }
+    /** @return the number of leaves, i.e. of paths to a leaf; saturates at Int.MAX_VALUE, see [countLeaves]. */
+    fun numLeaves(): Int = countLeaves().toSaturatedInt()
 
     /** @return the number of leaves that are feasible; non-feasible numbers can be reduced */
-    fun numInfeasible(): Int = when(this) {
-        is Leaf<ValueType> -> if (isInfeasible()) 1 else 0
-        is Internal<ValueType> ->  T.numInfeasible() + F.numInfeasible()
-    }
+    fun numInfeasible(): Int = countInfeasible().toSaturatedInt()
 
     /** @return the number of feasible leaves */
-    fun numFeasible(): Int = when(this) {
-        is Leaf<ValueType> -> if (!isFeasible()) 0 else 1
-        is Internal<ValueType> -> T.numFeasible() + F.numFeasible()
-    }
+    fun numFeasible(): Int = countFeasible().toSaturatedInt()
+
+    /**
+     * @return the number of leaves, i.e. of paths to a leaf, in time linear in the number of nodes;
+     * saturates at Long.MAX_VALUE.
+     */
+    fun countLeaves(): Long = countPaths { true }
+
+    /** @return the number of paths to an infeasible leaf; saturates at Long.MAX_VALUE. */
+    fun countInfeasible(): Long = countPaths { it.isInfeasible() }
+
+    /** @return the number of paths to a feasible leaf; saturates at Long.MAX_VALUE. */
+    fun countFeasible(): Long = countPaths { it.isFeasible() }
 
     /** @return the height of the DD tree. */
-    fun height(): Int = when(this) {
-        is Leaf<*> -> 0
-        is Internal<*> -> 1 + max(T.height(), F.height())
-    }
+    fun height(): Int = fold({ 0 }) { _, t, f -> 1 + max(t, f) }
 
     /** @return True if the condition refers to a boolean variable (not to a predicate!). */
     fun isBoolCond(): Boolean =
@@ -14,10 +14,12 @@ internal fun <ValueType: ScalarValue, DDType: DD<ValueType>>
         DDType.applyUnaryGeneric(function: (ValueType) -> DDType): DDType =
     when(this) {
         is DD.Leaf<*> -> if (isInfeasible()) infeasible else function(this.value as ValueType)
-        is DD.Internal<*> -> builder.internal(index,
-            (T as DDType).applyUnaryGeneric(function),
-            (F as DDType).applyUnaryGeneric(function)
-        )
+        is DD.Internal<*> -> builder.operationCache.getOrPut(function, this) {
+            builder.internal(index,
+                (T as DDType).applyUnaryGeneric(function),
+                (F as DDType).applyUnaryGeneric(function)
+            )
+        }
     } as DDType
 
 /**
@@ -28,10 +30,12 @@ internal fun <ValueType: ScalarValue, DDType: DD<ValueType>>
     DDType.applyUnarySplitGeneric(function: (ValueType) -> DDType): DDType =
     when(this) {
         is DD.Leaf<*> -> if (isInfeasible()) infeasible else function(this.value as ValueType)
-        is DD.Internal<*> -> builder.internal(index,
-            (T as DDType).applyUnarySplitGeneric(function),
-            (F as DDType).applyUnarySplitGeneric(function)
-        )
+        is DD.Internal<*> -> builder.operationCache.getOrPut(function, this) {
+            builder.internal(index,
+                (T as DDType).applyUnarySplitGeneric(function),
+                (F as DDType).applyUnarySplitGeneric(function)
+            )
+        }
     } as DDType
 
 
@@ -52,10 +56,12 @@ internal fun <ValueType: ScalarValue, OtherValueType: Any, ResultType: ScalarVal
             creator: (ResultType) -> DDType
 ): DDType = when(this) {
     is DD.Leaf<*> -> if (isInfeasible()) infeasible else creator(op(this.value as ValueType, other))
-    is DD.Internal<*> -> builder.internal(index,
-        (T as DDType).applyDDOtherGeneric(other, op, creator),
-        (F as DDType).applyDDOtherGeneric(other, op, creator)
-    )
+    is DD.Internal<*> -> builder.operationCache.getOrPut(op, this, other, creator) {
+        builder.internal(index,
+            (T as DDType).applyDDOtherGeneric(other, op, creator),
+            (F as DDType).applyDDOtherGeneric(other, op, creator)
+        )
+    }
 } as DDType
 
 
@@ -72,17 +78,23 @@ internal fun <ValueType: ScalarValue, DDType: DD<ValueType>> DDType.applySplitGe
     op: (ValueType, ValueType) -> DDType): DDType
 {
     require(other.builder === this.builder)
-    val thisT: DDType
-    val thisF: DDType
-    val otherT: DDType
-    val otherF: DDType
 
     // Check for the terminals. It ends iteration and applies operation.
     if (isInfeasible() || other.isInfeasible()) return infeasible as DDType
     if (this === empty || other === empty) return empty as DDType
     if (this is DD.Leaf<*> && other is DD.Leaf<*>) return op(this.value as ValueType, other.value as ValueType)
+    return builder.operationCache.getOrPut(op, this, other) { applySplitRecursion(other, op) }
+}
 
-    // Otherwise, recursion following the T/F children with the largest index.
+/** Recursion step of [applySplitGeneric], following the T/F children with the largest index. */
+private fun <ValueType: ScalarValue, DDType: DD<ValueType>> DDType.applySplitRecursion(
+    other: DDType,
+    op: (ValueType, ValueType) -> DDType): DDType
+{
+    val thisT: DDType
+    val thisF: DDType
+    val otherT: DDType
+    val otherF: DDType
     val idx = min(index, other.index)
     if (index <= other.index && this is DD.Internal<*>) {
         thisT = T as DDType
@@ -116,17 +128,23 @@ internal fun <ValueType: ScalarValue, DDType: DD<ValueType>> DDType.applyGeneric
     op: (ValueType, ValueType) -> ValueType
 ): DDType {
     check(other.builder === this.builder)
-    val thisT: DDType
-    val thisF: DDType
-    val otherT: DDType
-    val otherF: DDType
 
     // Check for the terminals. It ends iteration and applies operation.
     if (isInfeasible() || other.isInfeasible()) return infeasible as DDType
     if (this === empty || other === empty) return empty as DDType
     if (this is DD.Leaf<*> && other is DD.Leaf<*>) return builder.leaf(op(this.value as ValueType, other.value as ValueType))
+    return builder.operationCache.getOrPut(op, this, other) { applyRecursion(other, op) }
+}
 
-    // Otherwise, recursion following the T/F children with the largest index.
+/** Recursion step of [applyGeneric], following the T/F children with the largest index. */
+private fun <ValueType: ScalarValue, DDType: DD<ValueType>> DDType.applyRecursion(
+    other: DDType,
+    op: (ValueType, ValueType) -> ValueType
+): DDType {
+    val thisT: DDType
+    val thisF: DDType
+    val otherT: DDType
+    val otherF: DDType
     val newIndex = min(index, other.index)
     if (index <= other.index && this is DD.Internal<*>) {
         thisT = T as DDType
@@ -160,17 +178,23 @@ internal fun <ValueType: ScalarValue, DDType: DD<ValueType>, LeafType: DDType> D
     op: (LeafType, LeafType) -> DDType
 ): DDType {
     check(other.builder === this.builder)
-    val thisT: DDType
-    val thisF: DDType
-    val otherT: DDType
-    val otherF: DDType
 
     // Check for the terminals. It ends iteration and applies operation.
     if (isInfeasible() || other.isInfeasible()) return infeasible as DDType
     if (this === empty || other === empty) return empty as DDType
     if (this is DD.Leaf<*> && other is DD.Leaf<*>) return op(this as LeafType, other as LeafType)
+    return builder.operationCache.getOrPut(op, this, other) { applyLeafRecursion(other, op) }
+}
 
-    // Otherwise, recursion following the T/F children with the largest index.
+/** Recursion step of [applyGeneric] with an operation on leaves, following the T/F children with the largest index. */
+private fun <ValueType: ScalarValue, DDType: DD<ValueType>, LeafType: DDType> DDType.applyLeafRecursion(
+    other: DDType,
+    op: (LeafType, LeafType) -> DDType
+): DDType {
+    val thisT: DDType
+    val thisF: DDType
+    val otherT: DDType
+    val otherF: DDType
     val newIndex = min(index, other.index)
     if (index <= other.index && this is DD.Internal<*>) {
         thisT = T as DDType
@@ -211,7 +235,7 @@ fun <DDType: DD<*>> DDType.genericTimesBDD(other: BDD): DDType {
         builder.Bool.True  -> clone()
         builder.Bool.Empty   -> empty
         builder.Bool.All  -> all
-        else -> {
+        else -> builder.operationCache.getOrPut(TimesBDD, this, other) {
             val fT: DDType
             val fF: DDType
             val gT: BDD
@@ -251,7 +275,12 @@ fun <DDType: DD<*>> DDType.genericTimesBDD(other: BDD): DDType {
 fun <ValueType: ScalarValue, DDType: DD<ValueType>> DDType.applyGeneric(function: (ValueType) -> ValueType): DDType =
     when(this) {
         is DD.Leaf<*> -> if (isInfeasible()) infeasible else builder.leaf(function(this.value as ValueType))
-        is DD.Internal<*> -> builder.internal(index, (T as DDType).applyGeneric(function), (F as DDType).applyGeneric(function))
+        is DD.Internal<*> -> builder.operationCache.getOrPut(function, this) {
+            builder.internal(index, (T as DDType).applyGeneric(function), (F as DDType).applyGeneric(function))
+        }
     } as DDType
 
+/** Operation id of [genericTimesBDD] in the operation cache. */
+private object TimesBDD
+
 
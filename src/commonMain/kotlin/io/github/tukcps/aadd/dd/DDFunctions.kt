@@ -131,21 +131,20 @@ operator fun DD<*>.contains(x : Long) = when(this) {
 }
 
 /**
- * Returns number of internal nodes in a BDD.
+ * Returns number of internal nodes in a BDD; nodes that are shared by several paths are counted once.
  */
-fun DD<*>.numInternalNodes(node: DD<*> = this): Int = when(node) {
-    is DD.Leaf<*> -> 0
-    is DD.Internal<*> -> 1 + numInternalNodes(node.T) + numInternalNodes(node.F)
+fun DD<*>.numInternalNodes(node: DD<*> = this): Int {
+    var count = 0
+    node.anyNode { if (it is DD.Internal<*>) count++; false }
+    return count
 }
 
 /**
  * Returns number of unknown variables;
  * is wrong I believe as max does not consider that T and F can have disjoint conditions.
  */
-fun DD<*>.numUnknownVars(node: DD<*> = this): Int = when(node) {
-    is DD.Leaf<*> ->  0
-    is DD.Internal<*> -> max(node.index, max(numUnknownVars(node.T), numUnknownVars(node.F)))
-}
+fun DD<*>.numUnknownVars(node: DD<*> = this): Int =
+    node.fold({ 0 }) { internal, t, f -> max(internal.index, max(t, f)) }
 
 
 
@@ -0,0 +1,78 @@
+package io.github.tukcps.aadd.dd
+
+/*
+ * Traversal of DD.
+ * DD are DAGs: a shared subgraph is reached via many paths, and the number of paths can grow
+ * exponentially with the number of nodes. The functions here visit each node once, with an explicit
+ * stack instead of recursion, so that deep DD do not overflow the call stack.
+ */
+
+/**
+ * Compares nodes by reference; BDD compare structurally, which identifies nodes with different indexes.
+ * The hash is computed once; the node must not be changed while the key is in use.
+ */
+internal class NodeKey(val node: DD<*>) {
+    private val hash = if (node is DD.Internal<*>)
+        31 * (31 * node.index + node.T.hashCode()) + node.F.hashCode() else node.hashCode()
+    override fun equals(other: Any?): Boolean = other is NodeKey && node === other.node
+    override fun hashCode(): Int = hash
+}
+
+/**
+ * Computes a value bottom-up: for each leaf by [leaf], and for each internal node by [internal] from the
+ * values of its children. Each node is evaluated once, also if it is reached via several paths.
+ */
+internal fun <R> DD<*>.fold(leaf: (DD.Leaf<*>) -> R, internal: (DD.Internal<*>, R, R) -> R): R {
+    if (this is DD.Leaf<*>) return leaf(this)
+    val values = HashMap<NodeKey, R>()
+    val stack = ArrayList<DD.Internal<*>>()
+    stack.add(this as DD.Internal<*>)
+    while (stack.isNotEmpty()) {
+        val node = stack[stack.size - 1]
+        val key = NodeKey(node)
+        if (key in values) {
+            stack.removeAt(stack.size - 1)
+            continue
+        }
+        val t = node.T
+        val f = node.F
+        val tKey = if (t is DD.Internal<*>) NodeKey(t) else null
+        val fKey = if (f is DD.Internal<*>) NodeKey(f) else null
+        var ready = true
+        if (tKey != null && tKey !in values) { stack.add(t as DD.Internal<*>); ready = false }
+        if (fKey != null && fKey !in values) { stack.add(f as DD.Internal<*>); ready = false }
+        if (!ready) continue
+        val tValue = if (tKey == null) leaf(t as DD.Leaf<*>) else values.getValue(tKey)
+        val fValue = if (fKey == null) leaf(f as DD.Leaf<*>) else values.getValue(fKey)
+        values[key] = internal(node, tValue, fValue)
+        stack.removeAt(stack.size - 1)
+    }
+    return values.getValue(NodeKey(this))
+}
+
+/**
+ * Visits each node once, depth first, until [predicate] holds for a node.
+ * @return true if the predicate holds for a node.
+ */
+internal fun DD<*>.anyNode(predicate: (DD<*>) -> Boolean): Boolean {
+    val visited = HashSet<NodeKey>()
+    val stack = ArrayList<DD<*>>()
+    stack.add(this)
+    while (stack.isNotEmpty()) {
+        val node = stack.removeAt(stack.size - 1)
+        if (!visited.add(NodeKey(node))) continue
+        if (predicate(node)) return true
+        if (node is DD.Internal<*>) {
+            stack.add(node.F)
+            stack.add(node.T)
+        }
+    }
+    return false
+}
+
+/** Number of paths to the leaves for which [counts] holds; saturates at Long.MAX_VALUE. */
+internal fun DD<*>.countPaths(counts: (DD.Leaf<*>) -> Boolean): Long =
+    fold({ if (counts(it)) 1L else 0L }) { _, t, f -> if (t > Long.MAX_VALUE - f) Long.MAX_VALUE else t + f }
+
+/** The count as Int; saturates at Int.MAX_VALUE. */
+internal fun Long.toSaturatedInt(): Int = if (this > Int.MAX_VALUE) Int.MAX_VALUE else toInt()
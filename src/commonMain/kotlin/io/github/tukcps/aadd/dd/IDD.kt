@@ -46,11 +46,22 @@ sealed class IDD: DD<IntegerRange>, NumberRange<LongBound> {
 
     class Internal internal constructor(
         override var builder: DDBuilder,
-        override val index: Int,
-        override val T: IDD,
-        override val F: IDD,
+        override var index: Int,
+        T: IDD,
+        F: IDD,
         override var status: Status = Status.NotSolved
     ) : IDD(), DD.Internal<IntegerRange> { // end Internal class
+        override var T: IDD = T
+            private set
+        override var F: IDD = F
+            private set
+
+        /** Replaces the children; only for reordering, see [Reordering]. */
+        internal fun setChildren(T: IDD, F: IDD) {
+            this.T = T
+            this.F = F
+        }
+
         /** Clone method. Makes a deep copy of the tree structure. */
         override fun clone(): IDD = builder.internal(index, T.clone(), F.clone())
         /** Returns a short string with just the range; to get also the ITE operations, use toIteString() */
@@ -132,7 +143,11 @@ sealed class IDD: DD<IntegerRange>, NumberRange<LongBound> {
      * @param op
      * @return A BDD, set up recursively.
      */
-    private fun checkObjective(op: String): BDD {
+    private fun checkObjective(op: String, root: IDD = this): BDD =
+        // New variables are ordered after all existing ones; hence, results are only reused for the same root.
+        builder.operationCache.getOrPut(op, this, root) { checkObjectiveUncached(op, root) }
+
+    private fun checkObjectiveUncached(op: String, root: IDD): BDD {
         when (this) {
             is Leaf -> {
                 // Stop of recursion, comparison of IntegerRange with 0.
@@ -167,8 +182,8 @@ sealed class IDD: DD<IntegerRange>, NumberRange<LongBound> {
             }
             is Internal -> {
                 /* Recursion step. */
-                val Tr: BDD = T.checkObjective(op)
-                val Fr: BDD = F.checkObjective(op)
+                val Tr: BDD = T.checkObjective(op, root)
+                val Fr: BDD = F.checkObjective(op, root)
                 return builder.internal(index, Tr, Fr)
             }
         }
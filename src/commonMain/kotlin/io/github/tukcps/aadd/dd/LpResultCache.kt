@@ -0,0 +1,116 @@
+package io.github.tukcps.aadd.dd
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.values.real.aa.NoiseTerms
+
+/**
+ * ## LP Result Cache
+ *
+ * Keeps the results of the LP solver for a builder, independent of the leaves for which they were computed.
+ * Leaves are shared by different AADD and paths, so the results of a path are not kept in the leaf; and new AADD,
+ * e.g. the results of plus, times, or constrainTo, have paths with the same conditions and leaves with the same
+ * noise symbols as existing ones.
+ *
+ * A result is identified by the path, encoded as sorted signed condition indexes, and by the noise terms
+ * of the affine form of the leaf. The central value is not part of the key; the bounds are stored
+ * without it, so that results are reused for affine forms that differ by a constant offset.
+ * Infeasibility is stored for the path only and is reused for all affine forms.
+ *
+ * The cache holds at most [DDBuilderSettings.lpResultCacheSize] results; the oldest are removed first.
+ * Conditions are never changed after their creation; when their indexes are renumbered, the cache is cleared.
+ *
+ * @param builder the builder whose LP results are cached.
+ */
+class LpResultCache internal constructor(private val builder: DDBuilder) {
+
+    private class Key(val path: IntArray, val ids: LongArray?, val coefficients: DoubleArray?) {
+        private val hash = 31 * (31 * path.contentHashCode() + (ids?.contentHashCode() ?: 0)) +
+                (coefficients?.contentHashCode() ?: 0)
+
+        override fun hashCode(): Int = hash
+
+        override fun equals(other: Any?): Boolean =
+            other is Key && hash == other.hash && path.contentEquals(other.path) &&
+                    ids.contentEquals(other.ids) && coefficients.contentEquals(other.coefficients)
+    }
+
+    /** Result of the LP solver: the status of a path and the bounds of the noise terms if feasible. */
+    internal class Result(val status: DD.Status, val min: Double, val max: Double) {
+        companion object {
+            val Infeasible = Result(DD.Status.Infeasible, 0.0, 0.0)
+            /** The simplex did not converge; the bounds of the affine form itself remain. */
+            val Failed = Result(DD.Status.NotSolved, Double.NEGATIVE_INFINITY, Double.POSITIVE_INFINITY)
+        }
+    }
+
+    private val entries = LinkedHashMap<Key, Result>()
+
+    /** Number of lookups that found a result. */
+    var hits: Long = 0L
+        private set
+
+    /** Number of lookups that did not find a result. */
+    var misses: Long = 0L
+        private set
+
+    /** Ratio of hits to all lookups; 0.0 if there was no lookup. */
+    val hitRate: Double
+        get() = if (hits + misses == 0L) 0.0 else hits.toDouble() / (hits + misses).toDouble()
+
+    /** Number of results stored. */
+    val size: Int get() = entries.size
+
+    /** Removes all results and resets the statistics. */
+    fun clear() {
+        entries.clear()
+        hits = 0L
+        misses = 0L
+    }
+
+    private fun canonical(path: IntArray): IntArray = path.copyOf().also { it.sort() }
+
+    private fun objective(path: IntArray, xi: NoiseTerms) =
+        Key(path, xi.ids.copyOf(xi.size), xi.coefficients.copyOf(xi.size))
+
+    /**
+     * @return the result for the noise terms xi of a leaf on the path, or the infeasibility of the path,
+     * or null if not known.
+     */
+    internal fun get(path: IntArray, xi: NoiseTerms): Result? {
+        if (builder.settings.lpResultCacheSize <= 0) return null
+        val sorted = canonical(path)
+        val result = entries[Key(sorted, null, null)]?.takeIf { it.status == DD.Status.Infeasible }
+            ?: entries[objective(sorted, xi)]
+        if (result != null) hits++ else misses++
+        return result
+    }
+
+    /** Stores the bounds of the noise terms xi of a leaf on a feasible path. */
+    internal fun putFeasible(path: IntArray, xi: NoiseTerms, min: Double, max: Double) =
+        put(objective(canonical(path), xi), Result(DD.Status.Feasible, min, max))
+
+    /** Stores the infeasibility of a path. */
+    internal fun putInfeasible(path: IntArray) =
+        put(Key(canonical(path), null, null), Result.Infeasible)
+
+    /** Stores a result for the noise terms xi of a leaf on the path; the infeasibility for the path only. */
+    internal fun put(path: IntArray, xi: NoiseTerms, result: Result) =
+        if (result.status == DD.Status.Infeasible) putInfeasible(path)
+        else putFeasible(path, xi, result.min, result.max)
+
+    private fun put(key: Key, result: Result) {
+        val capacity = builder.settings.lpResultCacheSize
+        if (capacity <= 0) return
+        entries.remove(key)
+        while (entries.size >= capacity) {
+            val oldest = entries.keys.iterator()
+            oldest.next()
+            oldest.remove()
+        }
+        entries[key] = result
+    }
+
+    override fun toString(): String =
+        "LP result cache: $size of ${builder.settings.lpResultCacheSize} results, $hits hits, $misses misses"
+}
@@ -0,0 +1,154 @@
+package io.github.tukcps.aadd.dd
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.values.real.rounding.RoundingBackend
+
+/**
+ * ## Operation Cache
+ *
+ * The computed table of a builder: it memoizes the results of operations on decision diagrams,
+ * keyed by an operation id and the identities of the operand nodes.
+ * With shared subgraphs, the apply-based operations otherwise compute the same sub-problems
+ * again for each path by which they are reached.
+ *
+ * The cache is bounded: it is a direct-mapped table with [DDBuilderSettings.ddOperationCacheSize]
+ * entries, where a new entry replaces an older one with the same hash.
+ * It is invalidated when
+ * - the settings of the builder that results depend on change,
+ * - the assignment of conditions changes, or conditions and noise symbols are renumbered.
+ * Appending new conditions and solving LP problems do not invalidate the cache, as nodes are not changed by them.
+ *
+ * @param builder the builder whose operations are cached.
+ */
+class OperationCache internal constructor(private val builder: DDBuilder) {
+
+    private class Entry(
+        val op: Any,
+        val a: Any,
+        val b: Any?,
+        val c: Any?,
+        val epoch: Int,
+        val result: Any
+    )
+
+    private var entries: Array<Entry?> = arrayOfNulls(0)
+    private var epoch: Int = 0
+
+    /* The settings that the table and the results depend on, as of the last lookup. */
+    private var cacheSize = -1
+    private var uniqueTable = false
+    private var joinLeavesThreshold = 0.0
+    private var maxNoiseSymbols = 0
+    private var roundingBackend: RoundingBackend? = null
+    private var linearizationScheme: Any? = null
+
+    /** Number of lookups that found a valid entry. */
+    var hits: Long = 0L
+        private set
+
+    /** Number of lookups that did not find a valid entry. */
+    var misses: Long = 0L
+        private set
+
+    /** Ratio of hits to all lookups; 0.0 if there was no lookup. */
+    val hitRate: Double
+        get() = if (hits + misses == 0L) 0.0 else hits.toDouble() / (hits + misses).toDouble()
+
+    /**
+     * Invalidates all entries and drops them, so that the cache keeps no reference to their operands and results;
+     * otherwise, nodes that are no longer used elsewhere would remain reachable.
+     */
+    fun invalidate() {
+        entries.fill(null)
+        epoch++
+    }
+
+    /** Removes all entries and resets the statistics. */
+    fun clear() {
+        entries.fill(null)
+        epoch++
+        hits = 0L
+        misses = 0L
+    }
+
+    /**
+     * Adapts the table to the current settings; a change of a setting that results depend on invalidates all entries.
+     * The settings are mutable; they are compared field by field, without copying them.
+     */
+    @Suppress("DEPRECATION")
+    private fun checkSettings() {
+        val current = builder.settings
+        if (current.ddOperationCacheSize == cacheSize
+            && current.ddUniqueTable == uniqueTable
+            && current.ddJoinLeavesThreshold == joinLeavesThreshold
+            && current.affineFormMaxNumberOfNoiseSymbols == maxNoiseSymbols
+            && current.roundingBackend === roundingBackend
+            && current.affineFormLinearizationScheme === linearizationScheme
+        ) return
+        cacheSize = current.ddOperationCacheSize
+        uniqueTable = current.ddUniqueTable
+        joinLeavesThreshold = current.ddJoinLeavesThreshold
+        maxNoiseSymbols = current.affineFormMaxNumberOfNoiseSymbols
+        roundingBackend = current.roundingBackend
+        linearizationScheme = current.affineFormLinearizationScheme
+        var size = 0
+        if (cacheSize > 0) {
+            size = 1
+            while (size < cacheSize && size < (1 shl 30)) size = size shl 1
+        }
+        if (size != entries.size) entries = arrayOfNulls(size) else invalidate()
+    }
+
+    private fun slot(op: Any, a: Any, b: Any?, c: Any?): Int {
+        var hash = op.hashCode()
+        hash = 31 * hash + a.hashCode()
+        hash = 31 * hash + (b?.hashCode() ?: 0)
+        hash = 31 * hash + (c?.hashCode() ?: 0)
+        hash = hash xor (hash ushr 16)
+        return hash and (entries.size - 1)
+    }
+
+    /** DD operands are compared by identity, other operands (e.g. scalars) by equality. */
+    private fun same(x: Any?, y: Any?): Boolean =
+        x === y || (x !is DD<*> && x == y)
+
+    /** Looks up a result; each lookup is counted as an operation in the statistics of the builder. */
+    internal fun get(op: Any, a: Any, b: Any?, c: Any?): Any? {
+        checkSettings()
+        if (entries.isEmpty()) {
+            builder.statistics.applied(computed = true)
+            return null
+        }
+        val entry = entries[slot(op, a, b, c)]
+        if (entry != null && entry.epoch == epoch && entry.a === a && entry.op == op && same(entry.b, b) && same(entry.c, c)) {
+            hits++
+            builder.statistics.applied(computed = false)
+            return entry.result
+        }
+        misses++
+        builder.statistics.applied(computed = true)
+        return null
+    }
+
+    internal fun put(op: Any, a: Any, b: Any?, c: Any?, result: Any) {
+        if (entries.isEmpty()) return
+        entries[slot(op, a, b, c)] = Entry(op, a, b, c, epoch, result)
+    }
+
+    /**
+     * Returns the cached result of op applied to the operands a, b, c, or computes and caches it.
+     * @param op identifies the operation, e.g. a function reference or a constant.
+     */
+    @Suppress("UNCHECKED_CAST")
+    internal inline fun <R: Any> getOrPut(op: Any, a: Any, b: Any? = null, c: Any? = null, compute: () -> R): R {
+        val cached = get(op, a, b, c)
+        if (cached != null) return cached as R
+        val result = compute()
+        put(op, a, b, c, result)
+        return result
+    }
+
+    override fun toString(): String =
+        "Operation cache: ${entries.size} entries, $hits hits, $misses misses"
+}
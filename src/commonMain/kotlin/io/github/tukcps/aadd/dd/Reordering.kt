@@ -0,0 +1,290 @@
+package io.github.tukcps.aadd.dd
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.util.WeakRef
+
+/**
+ * Methods for reordering the conditions of the decision diagrams of a builder, see [Reordering].
+ */
+enum class ReorderingMethod {
+    /** Rudell's sifting: each condition is moved through all positions, and is left at the best one. */
+    SIFTING,
+
+    /** Tries both orders of each pair of adjacent conditions. */
+    WINDOW2,
+
+    /** Tries all six orders of each window of three adjacent conditions. */
+    WINDOW3
+}
+
+/**
+ * Result of a reordering.
+ * @param nodesBefore number of internal nodes reachable from the DD of the builder before the reordering.
+ * @param nodesAfter number of internal nodes reachable from the DD of the builder after the reordering.
+ */
+data class ReorderingResult(val nodesBefore: Int, val nodesAfter: Int)
+
+/**
+ * ## Reordering
+ *
+ * Dynamic reordering of the conditions of all DD of a builder.
+ * The order of a DD is the order of the indexes of the conditions; a bad order of creation can
+ * make the number of nodes grow exponentially. The reordering permutes the positions (indexes)
+ * of the conditions by swapping adjacent ones.
+ *
+ * A swap of the conditions at index i and j = i + 1 changes the nodes at i and j in place (Rudell):
+ * - a node at i without a child at j now tests its condition at j;
+ * - a node at j now tests its condition at i;
+ * - a node at i with a child at j keeps its identity, but now tests the condition of j, and
+ *   its children are the new nodes at j, shared via the unique table.
+ *
+ * Hence, all DD that are referenced by the user or by the builder remain valid and represent the same function.
+ * Each condition keeps its predicate, only its index changes. The range that getRange() keeps in the root
+ * of a DD remains valid, as the function of the DD remains the same. The results of the LP solver per path,
+ * in the builder and in the roots, and the operation cache are keyed by indexes and are discarded.
+ *
+ * The size is the number of internal nodes reachable from the DD that are not a child of another DD.
+ * Requires [io.github.tukcps.aadd.DDBuilderSettings.ddUniqueTable]; must not be called during an operation or getRange().
+ */
+internal class Reordering(private val builder: DDBuilder) {
+
+    private val table = builder.uniqueTable
+
+    /** The nodes of each index; nodes that are no longer referenced may be collected meanwhile. */
+    private val levels = HashMap<Int, ArrayList<WeakRef<DD.Internal<*>>>>()
+
+    /** DD that are not a child of another DD; they are kept during the reordering to measure the size. */
+    private val roots = ArrayList<DD.Internal<*>>()
+
+    /** Original index of the condition at each index, and index of each condition by its original index. */
+    private val conditionAt = HashMap<Int, Int>()
+    private val positionOf = HashMap<Int, Int>()
+
+    private var lo = 0
+    private var hi = 0
+
+    fun run(method: ReorderingMethod): ReorderingResult {
+        if (!builder.settings.ddUniqueTable) return ReorderingResult(0, 0)
+        builder.conditions.collect()
+        table.sweep()
+        lo = builder.conditions.btmIndex + 1
+        hi = builder.conditions.topIndex
+        for (index in lo..hi) {
+            conditionAt[index] = index
+            positionOf[index] = index
+        }
+
+        val nodes = ArrayList<DD.Internal<*>>()
+        table.forEachNode { if (it is DD.Internal<*>) nodes.add(it) }
+        val children = HashSet<NodeKey>()
+        for (node in nodes) {
+            levels.getOrPut(node.index) { ArrayList() }.add(WeakRef(node))
+            children.add(NodeKey(node.T))
+            children.add(NodeKey(node.F))
+        }
+        for (node in nodes)
+            if (NodeKey(node) !in children) roots.add(node)
+
+        val before = size()
+        when (method) {
+            ReorderingMethod.SIFTING -> sift()
+            ReorderingMethod.WINDOW2 -> window2()
+            ReorderingMethod.WINDOW3 -> window3()
+        }
+        finish()
+        return ReorderingResult(before, size())
+    }
+
+    /** Number of internal nodes reachable from the roots. */
+    private fun size(): Int {
+        val visited = HashSet<NodeKey>()
+        val stack = ArrayList<DD<*>>(roots)
+        while (stack.isNotEmpty()) {
+            val node = stack.removeAt(stack.size - 1)
+            if (node !is DD.Internal<*> || !visited.add(NodeKey(node))) continue
+            stack.add(node.T)
+            stack.add(node.F)
+        }
+        return visited.size
+    }
+
+    private fun alive(index: Int): ArrayList<DD.Internal<*>> {
+        val result = ArrayList<DD.Internal<*>>()
+        levels[index]?.forEach { reference -> reference.get()?.let { result.add(it) } }
+        return result
+    }
+
+    private fun number(index: Int) = levels[index]?.count { it.get() != null } ?: 0
+
+    /**
+     * Swaps the conditions at index i and i + 1.
+     * @return false if there are no nodes at either index, i.e. the size did not change.
+     */
+    private fun swap(i: Int): Boolean {
+        val j = i + 1
+        val a = conditionAt.getValue(i)
+        val b = conditionAt.getValue(j)
+        conditionAt[i] = b
+        conditionAt[j] = a
+        positionOf[a] = j
+        positionOf[b] = i
+
+        val upper = alive(i)
+        val lower = alive(j)
+        if (upper.isEmpty() && lower.isEmpty()) return false
+
+        // The children of the nodes at i, before the index of the nodes at j is changed.
+        val grandchildren = upper.map { node ->
+            val t = node.T
+            val f = node.F
+            if (t.index != j && f.index != j) null
+            else arrayOf<DD<*>>(
+                if (t is DD.Internal<*> && t.index == j) t.T else t,
+                if (t is DD.Internal<*> && t.index == j) t.F else t,
+                if (f is DD.Internal<*> && f.index == j) f.T else f,
+                if (f is DD.Internal<*> && f.index == j) f.F else f
+            )
+        }
+        val upperEntries = upper.map { table.remove(it) }
+        val lowerEntries = lower.map { table.remove(it) }
+
+        val newUpper = ArrayList<DD.Internal<*>>()
+        val newLower = ArrayList<DD.Internal<*>>()
+        for ((k, node) in lower.withIndex()) {
+            node.index = i
+            if (lowerEntries[k]) table.reinsert(node)
+            newUpper.add(node)
+        }
+        for ((k, node) in upper.withIndex()) {
+            if (grandchildren[k] != null) continue
+            node.index = j
+            if (upperEntries[k]) table.reinsert(node)
+            newLower.add(node)
+        }
+        for ((k, node) in upper.withIndex()) {
+            val (tt, tf, ft, ff) = grandchildren[k] ?: continue
+            val t = node(node, j, tt, ft, newLower)
+            val f = node(node, j, tf, ff, newLower)
+            setChildren(node, t, f)
+            node.index = i
+            if (upperEntries[k]) table.reinsert(node)
+            newUpper.add(node)
+        }
+        levels[i] = newUpper.mapTo(ArrayList()) { WeakRef(it) }
+        levels[j] = newLower.mapTo(ArrayList()) { WeakRef(it) }
+        return true
+    }
+
+    /** The canonical node of the same type as [like] for (index, T, F); new nodes are added to created. */
+    private fun node(like: DD.Internal<*>, index: Int, T: DD<*>, F: DD<*>, created: ArrayList<DD.Internal<*>>): DD<*> =
+        if (T === F) T
+        else table.internal(index, T, F) {
+            when (like) {
+                is AADD.Internal -> AADD.Internal(builder, index, T as AADD, F as AADD)
+                is BDD.Internal -> BDD.Internal(builder, index, T as BDD, F as BDD)
+                is IDD.Internal -> IDD.Internal(builder, index, T as IDD, F as IDD)
+                is StrDD.Internal -> StrDD.Internal(builder, index, T as StrDD, F as StrDD)
+            }.also { created.add(it) }
+        }
+
+    private fun setChildren(node: DD.Internal<*>, T: DD<*>, F: DD<*>) = when (node) {
+        is AADD.Internal -> node.setChildren(T as AADD, F as AADD)
+        is BDD.Internal -> node.setChildren(T as BDD, F as BDD)
+        is IDD.Internal -> node.setChildren(T as IDD, F as IDD)
+        is StrDD.Internal -> node.setChildren(T as StrDD, F as StrDD)
+    }
+
+    /** Moves the condition at index from to index to by swaps; returns the size afterwards. */
+    private fun move(from: Int, to: Int, size: Int): Int {
+        var changed = false
+        if (from < to) for (i in from until to) changed = swap(i) or changed
+        else for (i in from - 1 downTo to) changed = swap(i) or changed
+        return if (changed) size() else size
+    }
+
+    /**
+     * Sifting: the conditions are taken by decreasing number of nodes. Each one is moved to the nearer end,
+     * then to the other end, and finally back to the index with the smallest size. A direction is given up
+     * once the size exceeds the best one by [MAX_GROWTH].
+     */
+    private fun sift() {
+        var size = size()
+        val conditions = (lo..hi).sortedByDescending { number(it) }.map { conditionAt.getValue(it) }
+        for (condition in conditions) {
+            var position = positionOf.getValue(condition)
+            if (number(position) == 0) continue
+            var best = size
+            var bestPosition = position
+            val downFirst = hi - position < position - lo
+            for (down in listOf(downFirst, !downFirst)) {
+                while (if (down) position < hi else position > lo) {
+                    val next = if (down) position + 1 else position - 1
+                    size = move(position, next, size)
+                    position = next
+                    if (size < best) {
+                        best = size
+                        bestPosition = position
+                    }
+                    if (size > MAX_GROWTH * best) break
+                }
+            }
+            size = move(position, bestPosition, size)
+        }
+    }
+
+    /** Swaps each pair of adjacent conditions, and swaps it back if that does not reduce the size. */
+    private fun window2() {
+        var size = size()
+        for (i in lo until hi) {
+            if (!swap(i)) continue
+            val swapped = size()
+            if (swapped < size) size = swapped
+            else swap(i)
+        }
+    }
+
+    /**
+     * Tries all orders of each window of three adjacent conditions, by alternately swapping its
+     * first and second pair; after six swaps, the window is in its original order again.
+     */
+    private fun window3() {
+        if (hi - lo < 2) return window2()
+        var size = size()
+        for (i in lo..hi - 2) {
+            var best = size
+            var bestStep = 0
+            for (step in 1..5) {
+                if (swap(i + (step + 1) % 2)) size = size()
+                if (size < best) {
+                    best = size
+                    bestStep = step
+                }
+            }
+            swap(i + 1)
+            for (step in 1..bestStep) swap(i + (step + 1) % 2)
+            size = best
+        }
+    }
+
+    /**
+     * Updates the hashes of the BDD bottom-up, moves the conditions to their new indexes,
+     * and discards the results that depend on the indexes: the LP results per path and the operation cache.
+     */
+    private fun finish() {
+        for (index in hi downTo lo)
+            for (node in alive(index))
+                if (node is BDD.Internal) node.updateHash()
+        val newIndex = HashMap<Int, Int>()
+        for ((index, condition) in conditionAt) newIndex[condition] = index
+        for (index in builder.conditions.x.keys) if (index !in newIndex) newIndex[index] = index
+        builder.conditions.move(newIndex)
+        table.rehash()
+        builder.discardPathResults()
+        builder.operationCache.invalidate()
+    }
+
+    companion object {
+        /** Factor by which the size may grow while a condition is moved in one direction by sifting. */
+        private const val MAX_GROWTH = 1.2
+    }
+}
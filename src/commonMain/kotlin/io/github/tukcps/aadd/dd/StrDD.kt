@@ -65,11 +65,22 @@ sealed class StrDD: DD<Str> {
      */
     class Internal(
         override var builder: DDBuilder,
-        override val index: Int,
-        override val T: StrDD,
-        override val F: StrDD,
+        override var index: Int,
+        T: StrDD,
+        F: StrDD,
         override val status: DD.Status = DD.Status.NotSolved
     ) : StrDD(), DD.Internal<Str> {
+        override var T: StrDD = T
+            private set
+        override var F: StrDD = F
+            private set
+
+        /** Replaces the children; only for reordering, see [Reordering]. */
+        internal fun setChildren(T: StrDD, F: StrDD) {
+            this.T = T
+            this.F = F
+        }
+
         override fun toIteString(): String = TODO("Not yet implemented")
         override fun clone(): StrDD = builder.internal(index, T.clone(), F.clone())
     }
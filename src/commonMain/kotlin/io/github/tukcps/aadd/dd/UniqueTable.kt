@@ -0,0 +1,143 @@
+package io.github.tukcps.aadd.dd
+
+import io.github.tukcps.aadd.util.WeakRef
+import kotlin.math.max
+
+/**
+ * ## Unique Table
+ *
+ * Hash-consing of the nodes of decision diagrams created by a builder:
+ * - for each (index, T, F) there is at most one internal node,
+ * - for each (value, status) there is at most one leaf.
+ *
+ * As the children of a canonical internal node are canonical as well, the key of an internal node
+ * compares children by reference. This makes decision diagrams DAGs in which isomorphic
+ * subgraphs are shared, and allows checking equality by reference.
+ *
+ * The table only holds weak references to the nodes; entries of collected nodes are removed
+ * when the table has grown.
+ * Shared nodes are never annotated with results that depend on the path by which they are reached.
+ * Nodes that are replaced in the table, e.g. by [clear], are still visited by [forEachNode].
+ */
+internal class UniqueTable {
+
+    private class InternalKey(val index: Int, val T: DD<*>, val F: DD<*>) {
+        private val hash = 31 * (31 * index + T.hashCode()) + F.hashCode()
+        override fun equals(other: Any?): Boolean =
+            other is InternalKey && index == other.index && T === other.T && F === other.F
+        override fun hashCode(): Int = hash
+    }
+
+    private class LeafKey(val value: Any, val status: DD.Status) {
+        private val hash = 31 * value.hashCode() + status.hashCode()
+        override fun equals(other: Any?): Boolean =
+            other is LeafKey && status == other.status && value::class == other.value::class && value == other.value
+        override fun hashCode(): Int = hash
+    }
+
+    private val nodes = HashMap<Any, WeakRef<DD<*>>>()
+    private val displaced = ArrayList<WeakRef<DD<*>>>()
+    private var sweepThreshold = MIN_SWEEP_THRESHOLD
+
+    /** Number of requests that returned an existing node. */
+    var hits: Long = 0L
+        private set
+
+    /** Number of requests that created a new node. */
+    var misses: Long = 0L
+        private set
+
+    /** Number of entries, including entries of nodes that might already be collected. */
+    val size: Int get() = nodes.size
+
+    /**
+     * @return the canonical internal node for (index, T, F); it is created by [create] if there is none.
+     */
+    fun <N: DD<*>> internal(index: Int, T: DD<*>, F: DD<*>, create: () -> N): N =
+        lookup(InternalKey(index, T, F), create)
+
+    /**
+     * @return the canonical leaf for (value, status); it is created by [create] if there is none.
+     */
+    fun <N: DD<*>> leaf(value: Any, status: DD.Status, create: () -> N): N =
+        lookup(LeafKey(value, status), create)
+
+    @Suppress("UNCHECKED_CAST")
+    private fun <N: DD<*>> lookup(key: Any, create: () -> N): N {
+        val existing = nodes[key]?.get()
+        if (existing != null) {
+            hits++
+            return existing as N
+        }
+        misses++
+        val node = create()
+        nodes[key] = WeakRef(node)
+        if (nodes.size > sweepThreshold) sweep()
+        return node
+    }
+
+    /**
+     * Removes the entry of an internal node before its index or children are changed in place.
+     * @return true if the node was the entry for its key; only then it should be [reinsert]ed.
+     */
+    fun remove(node: DD.Internal<*>): Boolean {
+        val key = InternalKey(node.index, node.T, node.F)
+        if (nodes[key]?.get() !== node) return false
+        nodes.remove(key)
+        return true
+    }
+
+    /**
+     * Adds the entry of an internal node after its index or children have been changed in place.
+     * If there already is another node for the new key, the node is kept as a displaced one.
+     */
+    fun reinsert(node: DD.Internal<*>) {
+        val key = InternalKey(node.index, node.T, node.F)
+        if (nodes[key]?.get() != null) displaced.add(WeakRef(node))
+        else nodes[key] = WeakRef(node)
+    }
+
+    /** Removes the entries of nodes that have been collected. */
+    fun sweep() {
+        val iterator = nodes.values.iterator()
+        while (iterator.hasNext())
+            if (iterator.next().get() == null) iterator.remove()
+        displaced.removeAll { it.get() == null }
+        sweepThreshold = max(MIN_SWEEP_THRESHOLD, 2 * (nodes.size + displaced.size))
+    }
+
+    /** Removes all entries; existing nodes remain valid, but are no longer shared with new nodes. */
+    fun clear() {
+        displaced.addAll(nodes.values)
+        nodes.clear()
+        sweepThreshold = MIN_SWEEP_THRESHOLD
+    }
+
+    /** Calls [action] for each node created via the table that has not been collected yet. */
+    fun forEachNode(action: (DD<*>) -> Unit) {
+        for (reference in nodes.values) reference.get()?.let(action)
+        for (reference in displaced) reference.get()?.let(action)
+    }
+
+    /**
+     * Recomputes the keys of all entries from the current values of the leaves and indexes of the internal nodes.
+     * Required after these have been changed in place, e.g. by renumbering noise symbols or conditions.
+     */
+    fun rehash() {
+        val entries = ArrayList(nodes.entries)
+        nodes.clear()
+        for ((key, reference) in entries) {
+            val node = reference.get() ?: continue
+            val newKey = when {
+                key is LeafKey && node is DD.Leaf<*> -> LeafKey(node.value as Any, key.status)
+                node is DD.Internal<*> -> InternalKey(node.index, node.T, node.F)
+                else -> key
+            }
+            nodes.put(newKey, reference)?.let { displaced.add(it) }
+        }
+    }
+
+    companion object {
+        private const val MIN_SWEEP_THRESHOLD = 4096
+    }
+}
@@ -0,0 +1,151 @@
+package io.github.tukcps.aadd.lpsolver
+
+import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import kotlin.math.abs
+import kotlin.math.max
+import kotlin.math.min
+
+/**
+ * ## Bound propagation
+ *
+ * A cheap pre-filter for the LP problems of leaves: feasibility-based bound tightening of the noise symbols
+ * by interval evaluation of the path constraints over the box [lowerBound, upperBound] of the symbols.
+ * For each constraint Σ a_j·ε_j >= rhs, the largest value of the sum over the box
+ * - proves infeasibility if it is below rhs,
+ * - bounds each symbol by the remaining terms, which tightens the box;
+ * and a constraint whose smallest value is not below rhs (up to the tolerance) is redundant and is dropped.
+ * This is repeated until no bound changes considerably or after [maxRounds] rounds.
+ *
+ * If no constraint remains, the bounds of an affine form are its interval evaluation over the tightened box,
+ * and no LP solver is needed. Tightened bounds are widened by a relative tolerance, so they contain
+ * all feasible points in spite of rounding; infeasibility is only reported beyond this tolerance.
+ *
+ * @param lowerBound lower bound of all noise symbols.
+ * @param upperBound upper bound of all noise symbols.
+ * @param maxRounds maximum number of passes over the constraints.
+ */
+internal class BoundPropagation(
+    val lowerBound: Double = -1.0,
+    val upperBound: Double = 1.0,
+    val maxRounds: Int = 8
+) {
+    /** Result of the propagation. */
+    enum class Verdict {
+        /** The constraints have no solution. */
+        INFEASIBLE,
+        /** All constraints are redundant for the tightened box. */
+        BOUNDED,
+        /** Some constraints remain; an LP solver is needed. */
+        UNDECIDED
+    }
+
+    private val index = HashMap<Long, Int>()
+    private val rowColumns = ArrayList<IntArray>()
+    private val rowValues = ArrayList<DoubleArray>()
+    private val rowRhs = ArrayList<Double>()
+    private var lo = DoubleArray(0)
+    private var hi = DoubleArray(0)
+    private var redundant = BooleanArray(0)
+
+    var verdict: Verdict = Verdict.UNDECIDED
+        private set
+
+    /** Adds the constraint Σ coefficients[k]·ε(ids[k]) >= rhs, or <= rhs if not greaterOrEqual. */
+    fun addRow(ids: LongArray, coefficients: DoubleArray, count: Int, greaterOrEqual: Boolean, rhs: Double) {
+        val sign = if (greaterOrEqual) 1.0 else -1.0
+        rowColumns.add(IntArray(count) { k -> index.getOrPut(ids[k]) { index.size } })
+        rowValues.add(DoubleArray(count) { k -> sign * coefficients[k] })
+        rowRhs.add(sign * rhs)
+    }
+
+    /** @return true if the constraint added as i-th row was found to be redundant. */
+    fun isRedundant(i: Int): Boolean = redundant[i]
+
+    /** Tightens the bounds of the symbols and drops redundant constraints. */
+    fun propagate(): Verdict {
+        val m = rowColumns.size
+        lo = DoubleArray(index.size) { lowerBound }
+        hi = DoubleArray(index.size) { upperBound }
+        redundant = BooleanArray(m)
+        var remaining = m
+        for (round in 0 until maxRounds) {
+            var changed = false
+            for (i in 0 until m) {
+                if (redundant[i]) continue
+                val columns = rowColumns[i]
+                val values = rowValues[i]
+                val rhs = rowRhs[i]
+                var maxActivity = 0.0
+                var minActivity = 0.0
+                for (k in columns.indices) {
+                    val a = values[k]
+                    val j = columns[k]
+                    maxActivity += if (a > 0.0) a * hi[j] else a * lo[j]
+                    minActivity += if (a > 0.0) a * lo[j] else a * hi[j]
+                }
+                val tolerance = TOLERANCE * (1.0 + abs(rhs) + abs(maxActivity) + abs(minActivity))
+                if (maxActivity < rhs - tolerance) {
+                    verdict = Verdict.INFEASIBLE
+                    return verdict
+                }
+                if (minActivity >= rhs - tolerance) {
+                    redundant[i] = true
+                    remaining--
+                    continue
+                }
+                // a_j·ε_j >= rhs - (maxActivity - a_j·bound_j)
+                for (k in columns.indices) {
+                    val a = values[k]
+                    val j = columns[k]
+                    if (abs(a) < EPS || lo[j] >= hi[j]) continue
+                    val rest = maxActivity - if (a > 0.0) a * hi[j] else a * lo[j]
+                    val bound = (rhs - rest) / a
+                    val slack = tolerance / abs(a)
+                    if (a > 0.0 && bound - slack > lo[j] + MIN_CHANGE * (hi[j] - lo[j])) {
+                        lo[j] = min(hi[j], bound - slack)
+                        changed = true
+                    } else if (a < 0.0 && bound + slack < hi[j] - MIN_CHANGE * (hi[j] - lo[j])) {
+                        hi[j] = max(lo[j], bound + slack)
+                        changed = true
+                    }
+                }
+            }
+            if (!changed) break
+        }
+        verdict = if (remaining == 0) Verdict.BOUNDED else Verdict.UNDECIDED
+        return verdict
+    }
+
+    /** Lower bound of Σ coefficients[k]·ε(ids[k]) over the tightened box, rounded down. */
+    fun minimize(ids: LongArray, coefficients: DoubleArray, count: Int): Double {
+        var sum = 0.0
+        for (k in 0 until count) {
+            val c = coefficients[k]
+            val j = index[ids[k]]
+            val bound = if (c > 0.0) j?.let { lo[it] } ?: lowerBound else j?.let { hi[it] } ?: upperBound
+            sum = IEEE754RoundingMath.add(sum, IEEE754RoundingMath.mul(c, bound, Rounding.DOWN), Rounding.DOWN)
+        }
+        return sum
+    }
+
+    /** Upper bound of Σ coefficients[k]·ε(ids[k]) over the tightened box, rounded up. */
+    fun maximize(ids: LongArray, coefficients: DoubleArray, count: Int): Double {
+        var sum = 0.0
+        for (k in 0 until count) {
+            val c = coefficients[k]
+            val j = index[ids[k]]
+            val bound = if (c > 0.0) j?.let { hi[it] } ?: upperBound else j?.let { lo[it] } ?: lowerBound
+            sum = IEEE754RoundingMath.add(sum, IEEE754RoundingMath.mul(c, bound, Rounding.UP), Rounding.UP)
+        }
+        return sum
+    }
+
+    private companion object {
+        const val EPS = 1e-12
+        /** Relative tolerance for rounding errors of the interval evaluation. */
+        const val TOLERANCE = 1e-9
+        /** Minimum relative change of a bound that counts as progress. */
+        const val MIN_CHANGE = 1e-3
+    }
+}
@@ -0,0 +1,375 @@
+package io.github.tukcps.aadd.lpsolver
+
+import kotlin.math.abs
+import kotlin.math.max
+
+/**
+ * ## Incremental LP solver
+ *
+ * An LP solver for the path conditions of an AADD that keeps its state from one path to the next.
+ * The variables are noise symbols, identified by their id, each bounded by [lowerBound] and [upperBound];
+ * the constraints are the conditions on a path, which are added by [push] and removed by [pop] in
+ * last-in first-out order, as during a depth-first traversal of the AADD.
+ *
+ * The solver is a bounded-variable simplex on a dense tableau.
+ * Bounds of noise symbols are not rows, but bounds of the columns.
+ * Each condition adds one row with a slack variable that is bounded on one side by the constant term.
+ * A new row is made feasible by the dual simplex, starting from the optimal basis of the last objective;
+ * hence, leaves that share the prefix of a path only need the pivots for the constraints that differ.
+ * [maximize] and [minimize] then start the primal simplex from this basis.
+ *
+ * [pop] restores the state before the matching [push]. Instead of a copy of the tableau per [push], the solver keeps
+ * an undo trail: the content of each row before its first change after the push, and the values and basis of the
+ * variables at the push, which are linear in the size of the problem. Rows and columns added are simply dropped.
+ *
+ * @param lowerBound lower bound of all noise symbols.
+ * @param upperBound upper bound of all noise symbols.
+ * @param maxIterations maximum number of pivots per call of [push], [maximize], or [minimize].
+ */
+class IncrementalLpSolver(
+    val lowerBound: Double = -1.0,
+    val upperBound: Double = 1.0,
+    val maxIterations: Int = 10_000
+) {
+    /** Result of adding a constraint. */
+    enum class Verdict { FEASIBLE, INFEASIBLE, FAILED }
+
+    /** State of the tableau. */
+    private class State(
+        var columns: Int,
+        var lo: DoubleArray,
+        var hi: DoubleArray,
+        var x: DoubleArray,
+        var rowOf: IntArray,
+        var symbol: LongArray,
+        val basis: ArrayList<Int>,
+        val rows: ArrayList<DoubleArray>,
+        var verdict: Verdict
+    )
+
+    /**
+     * What [pop] restores of a [push]: the number of columns and rows, the verdict, the values and the basis,
+     * and the size of the trail of changed rows at the push.
+     */
+    private class Level(
+        val id: Int,
+        val columns: Int,
+        val rows: Int,
+        val verdict: Verdict,
+        val x: DoubleArray,
+        val rowOf: IntArray,
+        val basis: IntArray,
+        val trail: Int
+    )
+
+    private val state = State(
+        0, DoubleArray(INITIAL), DoubleArray(INITIAL), DoubleArray(INITIAL),
+        IntArray(INITIAL), LongArray(INITIAL), ArrayList(), ArrayList(), Verdict.FEASIBLE
+    )
+    private val levels = ArrayList<Level>()
+    private var pushes = 0
+
+    /* The undo trail: rows changed since the push of the current level, and their content before the change. */
+    private val changedRows = ArrayList<Int>()
+    private val savedRows = ArrayList<DoubleArray>()
+    /* For each row, the id of the level in which it was last saved; a row is saved once per level. */
+    private var savedIn = IntArray(INITIAL)
+
+    private val index = HashMap<Long, Int>()
+    private var cost = DoubleArray(INITIAL)
+
+    /** Number of pivots since creation of the solver. */
+    var pivots: Long = 0L
+        private set
+
+    /** Number of constraints currently added. */
+    val depth: Int get() = levels.size
+
+    /** Verdict after the last [push] or [pop]. */
+    val verdict: Verdict get() = state.verdict
+
+    /**
+     * Adds the constraint Σ coefficients[k]·ε(ids[k]) >= rhs, or <= rhs if not [greaterOrEqual].
+     * Once a constraint is infeasible, all following pushes are infeasible, too, until it is popped.
+     * @return the verdict on the conjunction of all constraints added.
+     */
+    fun push(ids: LongArray, coefficients: DoubleArray, count: Int, greaterOrEqual: Boolean, rhs: Double): Verdict {
+        val rows = state.rows.size
+        levels.add(Level(++pushes, state.columns, rows, state.verdict,
+            state.x.copyOf(state.columns), state.rowOf.copyOf(state.columns), IntArray(rows) { state.basis[it] },
+            changedRows.size))
+        if (state.verdict != Verdict.FEASIBLE) return state.verdict
+        addRow(ids, coefficients, count, greaterOrEqual, rhs)
+        state.verdict = dualSimplex()
+        return state.verdict
+    }
+
+    /**
+     * Adds a constraint like [push], but without a state for [pop] and without making it feasible.
+     * After adding all constraints of a problem, [restoreFeasibility] computes a feasible basis once.
+     */
+    internal fun addRow(ids: LongArray, coefficients: DoubleArray, count: Int, greaterOrEqual: Boolean, rhs: Double) {
+        for (k in 0 until count)
+            if (ids[k] !in index) index[ids[k]] = addColumn(ids[k], lowerBound, upperBound, lowerBound)
+
+        val slack = if (greaterOrEqual) addColumn(NO_SYMBOL, rhs, Double.POSITIVE_INFINITY, 0.0)
+                    else addColumn(NO_SYMBOL, Double.NEGATIVE_INFINITY, rhs, 0.0)
+        val row = DoubleArray(state.lo.size)
+        for (k in 0 until count) {
+            val j = index[ids[k]]!!
+            val a = coefficients[k]
+            val r = state.rowOf[j]
+            if (r == NONBASIC) row[j] += a
+            else {
+                val source = state.rows[r]
+                for (l in 0 until state.columns) row[l] += a * source[l]
+            }
+        }
+        state.rows.add(row)
+        state.basis.add(slack)
+        if (state.rows.size > savedIn.size) savedIn = savedIn.copyOf(2 * state.rows.size)
+        state.rowOf[slack] = state.rows.size - 1
+        state.x[slack] = rowValue(row)
+    }
+
+    /** Computes a feasible basis for all constraints added by [addRow]. */
+    internal fun restoreFeasibility(): Verdict {
+        if (state.verdict == Verdict.FEASIBLE) state.verdict = dualSimplex()
+        return state.verdict
+    }
+
+    /** Removes the constraint added last. */
+    fun pop() {
+        if (levels.isEmpty()) throw IllegalStateException("IncrementalLpSolver: pop without push")
+        val level = levels.removeAt(levels.size - 1)
+        while (changedRows.size > level.trail) {
+            val r = changedRows.removeAt(changedRows.size - 1)
+            val saved = savedRows.removeAt(savedRows.size - 1)
+            state.rows[r] = if (saved.size < state.lo.size) saved.copyOf(state.lo.size) else saved
+        }
+        for (j in level.columns until state.columns)
+            if (state.symbol[j] != NO_SYMBOL) index.remove(state.symbol[j])
+        state.columns = level.columns
+        while (state.rows.size > level.rows) {
+            state.rows.removeAt(state.rows.size - 1)
+            state.basis.removeAt(state.basis.size - 1)
+        }
+        for (r in 0 until level.rows) state.basis[r] = level.basis[r]
+        level.x.copyInto(state.x)
+        level.rowOf.copyInto(state.rowOf)
+        state.verdict = level.verdict
+    }
+
+    /** Saves row r on the undo trail before its first change in the current level; rows of the level are dropped by [pop]. */
+    private fun save(r: Int) {
+        val level = levels.lastOrNull() ?: return
+        if (r >= level.rows || savedIn[r] == level.id) return
+        savedIn[r] = level.id
+        changedRows.add(r)
+        savedRows.add(state.rows[r].copyOf())
+    }
+
+    /**
+     * Maximizes Σ coefficients[k]·ε(ids[k]) subject to the constraints added.
+     * Symbols that are not in any constraint contribute their bound.
+     * @return the maximum, or null if the constraints are not feasible or the solver did not converge.
+     */
+    fun maximize(ids: LongArray, coefficients: DoubleArray, count: Int): Double? {
+        if (state.verdict != Verdict.FEASIBLE) return null
+        cost.fill(0.0)
+        var free = 0.0
+        for (k in 0 until count) {
+            val c = coefficients[k]
+            val j = index[ids[k]]
+            if (j == null) free += c * (if (c > 0.0) upperBound else lowerBound)
+            else cost[j] += c
+        }
+        return primalSimplex()?.plus(free)
+    }
+
+    /** @see maximize */
+    fun minimize(ids: LongArray, coefficients: DoubleArray, count: Int): Double? {
+        val negated = DoubleArray(count) { -coefficients[it] }
+        return maximize(ids, negated, count)?.let { -it }
+    }
+
+    private fun addColumn(symbol: Long, lo: Double, hi: Double, x: Double): Int {
+        if (state.columns == state.lo.size) grow()
+        val j = state.columns++
+        state.lo[j] = lo
+        state.hi[j] = hi
+        state.x[j] = x
+        state.rowOf[j] = NONBASIC
+        state.symbol[j] = symbol
+        cost[j] = 0.0
+        return j
+    }
+
+    private fun grow() {
+        val size = state.lo.size * 2
+        state.lo = state.lo.copyOf(size)
+        state.hi = state.hi.copyOf(size)
+        state.x = state.x.copyOf(size)
+        state.rowOf = state.rowOf.copyOf(size)
+        state.symbol = state.symbol.copyOf(size)
+        for (r in state.rows.indices) state.rows[r] = state.rows[r].copyOf(size)
+        cost = cost.copyOf(size)
+    }
+
+    /** Value of a basic variable from the nonbasic ones. */
+    private fun rowValue(row: DoubleArray): Double {
+        var sum = 0.0
+        for (l in 0 until state.columns)
+            if (state.rowOf[l] == NONBASIC && row[l] != 0.0) sum += row[l] * state.x[l]
+        return sum
+    }
+
+    private fun updateBasicValues() {
+        for (r in state.rows.indices) state.x[state.basis[r]] = rowValue(state.rows[r])
+    }
+
+    /** Reduced costs of all columns; zero for basic ones. */
+    private fun reducedCosts(): DoubleArray {
+        val d = cost.copyOf()
+        for (r in state.rows.indices) {
+            val cb = cost[state.basis[r]]
+            if (cb == 0.0) continue
+            val row = state.rows[r]
+            for (l in 0 until state.columns) d[l] += cb * row[l]
+        }
+        for (r in state.rows.indices) d[state.basis[r]] = 0.0
+        return d
+    }
+
+    /** Exchanges the basic variable of row k with the nonbasic variable l. */
+    private fun pivot(k: Int, l: Int) {
+        pivots++
+        save(k)
+        val row = state.rows[k]
+        val a = row[l]
+        val leaving = state.basis[k]
+        for (j in 0 until state.columns) row[j] = -row[j] / a
+        row[leaving] = 1.0 / a
+        row[l] = 0.0
+        for (r in state.rows.indices) {
+            if (r == k) continue
+            if (state.rows[r][l] == 0.0) continue
+            save(r)
+            val other = state.rows[r]
+            val f = other[l]
+            for (j in 0 until state.columns) other[j] += f * row[j]
+            other[l] = 0.0
+        }
+        state.basis[k] = l
+        state.rowOf[l] = k
+        state.rowOf[leaving] = NONBASIC
+    }
+
+    private fun canIncrease(j: Int) = state.x[j] < state.hi[j]
+    private fun canDecrease(j: Int) = state.x[j] > state.lo[j]
+
+    /**
+     * Dual simplex: restores primal feasibility while the basis stays dual feasible for the last objective.
+     */
+    private fun dualSimplex(): Verdict {
+        repeat(maxIterations) {
+            // Leaving variable: the basic variable with the largest bound violation.
+            var k = -1
+            var worst = EPS
+            for (r in state.rows.indices) {
+                val b = state.basis[r]
+                val v = state.x[b]
+                val violation = if (v < state.lo[b]) state.lo[b] - v else if (v > state.hi[b]) v - state.hi[b] else 0.0
+                if (violation > worst) { worst = violation; k = r }
+            }
+            if (k == -1) return Verdict.FEASIBLE
+
+            val b = state.basis[k]
+            val increase = state.x[b] < state.lo[b]
+            val d = reducedCosts()
+            val row = state.rows[k]
+            // Entering variable: smallest ratio of reduced cost to coefficient, ties by the larger coefficient.
+            var l = -1
+            var best = Double.POSITIVE_INFINITY
+            var bestA = 0.0
+            for (j in 0 until state.columns) {
+                if (state.rowOf[j] != NONBASIC) continue
+                val a = row[j]
+                if (abs(a) < EPS) continue
+                val up = (a > 0.0) == increase
+                if (up && !canIncrease(j) || !up && !canDecrease(j)) continue
+                val ratio = abs(d[j]) / abs(a)
+                if (ratio < best - EPS || (ratio < best + EPS && abs(a) > bestA)) {
+                    best = ratio; l = j; bestA = abs(a)
+                }
+            }
+            if (l == -1) return Verdict.INFEASIBLE
+
+            val target = if (increase) state.lo[b] else state.hi[b]
+            state.x[l] += (target - state.x[b]) / row[l]
+            pivot(k, l)
+            state.x[b] = target
+            updateBasicValues()
+        }
+        return Verdict.FAILED
+    }
+
+    /**
+     * Primal bounded-variable simplex for the objective in [cost] with Bland's rule: the entering variable is
+     * the eligible one with the smallest index, and ties of the ratio test are broken by the smallest index
+     * of the leaving basic variable.
+     * @return the maximum without the free term, or null if not converged or unbounded.
+     */
+    private fun primalSimplex(): Double? {
+        repeat(maxIterations) {
+            val d = reducedCosts()
+            var e = -1
+            for (j in 0 until state.columns) {
+                if (state.rowOf[j] != NONBASIC) continue
+                if (d[j] > EPS && canIncrease(j) || d[j] < -EPS && canDecrease(j)) { e = j; break }
+            }
+            if (e == -1) {
+                var value = 0.0
+                for (j in 0 until state.columns) if (cost[j] != 0.0) value += cost[j] * state.x[j]
+                return value
+            }
+
+            // Ratio test over the bound of the entering variable and the bounds of the basic variables.
+            val direction = if (d[e] > 0.0) 1.0 else -1.0
+            var theta = state.hi[e] - state.lo[e]
+            var k = -1
+            for (r in state.rows.indices) {
+                val a = state.rows[r][e]
+                if (abs(a) < EPS) continue
+                val b = state.basis[r]
+                val rate = a * direction
+                val limit = if (rate > 0.0) (state.hi[b] - state.x[b]) / rate else (state.lo[b] - state.x[b]) / rate
+                if (limit < theta || (limit == theta && k != -1 && b < state.basis[k])) { theta = limit; k = r }
+            }
+            if (theta == Double.POSITIVE_INFINITY) return null
+            theta = max(theta, 0.0)
+
+            if (k == -1) {
+                state.x[e] = if (direction > 0.0) state.hi[e] else state.lo[e]
+            } else {
+                val b = state.basis[k]
+                val rate = state.rows[k][e] * direction
+                state.x[e] += direction * theta
+                pivot(k, e)
+                state.x[b] = if (rate > 0.0) state.hi[b] else state.lo[b]
+            }
+            updateBasicValues()
+        }
+        return null
+    }
+
+    override fun toString(): String =
+        "IncrementalLpSolver: ${state.columns} columns, ${state.rows.size} rows, $verdict, $pivots pivots"
+
+    private companion object {
+        const val EPS = 1e-9
+        const val INITIAL = 16
+        const val NONBASIC = -1
+        const val NO_SYMBOL = Long.MIN_VALUE
+    }
+}
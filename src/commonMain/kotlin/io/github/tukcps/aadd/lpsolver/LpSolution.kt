@@ -15,6 +15,12 @@ object NoSolution : LpSolution()
  */
 object Unbounded : LpSolution()
 
+/**
+ * Returned by [solveMinMax] when the simplex did not converge within its iteration limit.
+ * Nothing is known about the problem then; in particular, it is not unbounded.
+ */
+object Failed : LpSolution()
+
 /**
  * Returned by solver when linear programming problem is solvable.
  * @param functionValue value or function
@@ -25,6 +31,16 @@ data class Solved(
     val variablesValues: Map<LpVariable, Double>
 ) : LpSolution()
 
+/**
+ * Returned by [solveMinMax] when linear programming problem is solvable.
+ * @param min minimum of function
+ * @param max maximum of function
+ */
+data class SolvedMinMax(
+    val min: Double,
+    val max: Double
+) : LpSolution()
+
 /** Lp Solution Exception */
 open class LpSolutionException(s:String):Exception(s)
 
@@ -77,6 +77,99 @@ fun solve(problem: LpProblem): LpSolution {
     }
 }
 
+/**
+ * Implementation of the bounded-variable simplex used by [solveMinMax].
+ */
+enum class LpSolverEngine {
+    /**
+     * Dense tableau of [IncrementalLpSolver].
+     */
+    DENSE,
+    /**
+     * Revised simplex on a sparse column-wise matrix of [SparseLpSolver].
+     */
+    SPARSE
+}
+
+/**
+ * Computes minimum and maximum of a function over the same feasible region.
+ *
+ * All variables are bounded by [lowerBound] and [upperBound]; these bounds are handled by the
+ * bounded-variable simplex and are not constraint rows.
+ * A feasible basis is computed once; the maximum is computed from it, and the minimum from the
+ * optimal basis of the maximum.
+ * The sign [LpVariable.canBeNegative] is ignored, as the bounds apply.
+ *
+ * @param constraints constraints on the variables.
+ * @param function the function to minimize and maximize, including its free term.
+ * @param engine the implementation of the simplex.
+ * @param maxIterations maximum number of pivots per phase of the simplex.
+ * @param pivots called with the number of pivots of the simplex.
+ * @return [SolvedMinMax], [NoSolution], or [Failed] if the simplex did not converge.
+ */
+fun solveMinMax(
+    constraints: List<LpConstraint>,
+    function: LpExpressionLike,
+    lowerBound: Double = -1.0,
+    upperBound: Double = 1.0,
+    engine: LpSolverEngine = LpSolverEngine.DENSE,
+    maxIterations: Int = 10_000,
+    pivots: (Long) -> Unit = {}
+): LpSolution = when (engine) {
+    LpSolverEngine.DENSE -> IncrementalLpSolver(lowerBound, upperBound, maxIterations).let {
+        solveMinMax(constraints, function, it::addRow, it::restoreFeasibility, it::maximize, it::minimize)
+            .also { _ -> pivots(it.pivots) }
+    }
+    LpSolverEngine.SPARSE -> SparseLpSolver(lowerBound, upperBound, maxIterations).let {
+        solveMinMax(constraints, function, it::addRow, it::restoreFeasibility, it::maximize, it::minimize)
+            .also { _ -> pivots(it.pivots) }
+    }
+}
+
+private inline fun solveMinMax(
+    constraints: List<LpConstraint>,
+    function: LpExpressionLike,
+    addRow: (LongArray, DoubleArray, Int, Boolean, Double) -> Unit,
+    restoreFeasibility: () -> IncrementalLpSolver.Verdict,
+    maximize: (LongArray, DoubleArray, Int) -> Double?,
+    minimize: (LongArray, DoubleArray, Int) -> Double?
+): LpSolution {
+    val ids = HashMap<LpVariable, Long>()
+    fun encode(expression: LpExpressionLike): Pair<LongArray, DoubleArray> {
+        val variables = LongArray(expression.terms.size)
+        val coefficients = DoubleArray(expression.terms.size)
+        var k = 0
+        expression.terms.forEach { (v, c) ->
+            variables[k] = ids.getOrPut(v) { ids.size.toLong() }
+            coefficients[k++] = c
+        }
+        return variables to coefficients
+    }
+
+    for (constraint in constraints) {
+        val (variables, coefficients) = encode(constraint.expression)
+        val rhs = constraint.constantValue - constraint.expression.free
+        when (constraint.sign) {
+            EQUAL -> {
+                addRow(variables, coefficients, variables.size, true, rhs)
+                addRow(variables, coefficients, variables.size, false, rhs)
+            }
+            LESS_OR_EQUAL -> addRow(variables, coefficients, variables.size, false, rhs)
+            GREATER_OR_EQUAL -> addRow(variables, coefficients, variables.size, true, rhs)
+        }
+    }
+    when (restoreFeasibility()) {
+        IncrementalLpSolver.Verdict.INFEASIBLE -> return NoSolution
+        IncrementalLpSolver.Verdict.FAILED -> return Failed
+        IncrementalLpSolver.Verdict.FEASIBLE -> {}
+    }
+    // All variables are bounded; hence, no maximum or minimum means that the simplex did not converge.
+    val (variables, coefficients) = encode(function)
+    val max = maximize(variables, coefficients, variables.size) ?: return Failed
+    val min = minimize(variables, coefficients, variables.size) ?: return Failed
+    return SolvedMinMax(min + function.free, max + function.free)
+}
+
 /**
  * Actually solve linear programming problem.
  * @param initial initial state, containing the encoded problem. Left intact.
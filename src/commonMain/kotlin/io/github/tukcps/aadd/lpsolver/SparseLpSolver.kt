@@ -0,0 +1,367 @@
+package io.github.tukcps.aadd.lpsolver
+
+import io.github.tukcps.aadd.lpsolver.IncrementalLpSolver.Verdict
+import kotlin.math.abs
+import kotlin.math.max
+
+/**
+ * ## Sparse LP solver
+ *
+ * A revised bounded-variable simplex for the same problems as [IncrementalLpSolver]: variables are noise symbols
+ * bounded by [lowerBound] and [upperBound], and each constraint is a row with a slack variable bounded by its constant.
+ *
+ * Path conditions are very sparse compared to the number of noise symbols; hence, the constraint matrix is stored
+ * column-wise with its nonzero entries only, and no tableau is kept.
+ * The inverse of the basis is kept in product form, as a sequence of eta vectors, one per pivot, applied to the initial
+ * basis of the slack variables. After [refactorInterval] pivots, the product form is computed again from the slack
+ * basis to limit the length of the sequence and the accumulated rounding errors.
+ * Work vectors have one entry per constraint.
+ *
+ * Usage: add all constraints by [addRow], then compute a feasible basis by [restoreFeasibility] once,
+ * then [maximize] and [minimize] as often as needed.
+ *
+ * @param lowerBound lower bound of all noise symbols.
+ * @param upperBound upper bound of all noise symbols.
+ * @param maxIterations maximum number of pivots per call of [restoreFeasibility], [maximize], or [minimize].
+ * @param refactorInterval number of eta vectors after which the basis is factorized again.
+ */
+internal class SparseLpSolver(
+    val lowerBound: Double = -1.0,
+    val upperBound: Double = 1.0,
+    val maxIterations: Int = 10_000,
+    val refactorInterval: Int = 32
+) {
+    private val index = HashMap<Long, Int>()
+    private val rowColumns = ArrayList<IntArray>()
+    private val rowValues = ArrayList<DoubleArray>()
+    private val rowGreaterOrEqual = ArrayList<Boolean>()
+    private val rowRhs = ArrayList<Double>()
+
+    /** Number of structural variables n and of constraints m; columns n until n+m are the slack variables. */
+    private var n = 0
+    private var m = 0
+
+    /** Constraint matrix in compressed sparse column format. */
+    private var columnStart = IntArray(0)
+    private var entryRow = IntArray(0)
+    private var entryValue = DoubleArray(0)
+
+    private var lo = DoubleArray(0)
+    private var hi = DoubleArray(0)
+    private var x = DoubleArray(0)
+    private var cost = DoubleArray(0)
+    /** Basic variable per position, and position per variable or NONBASIC. */
+    private var basis = IntArray(0)
+    private var position = IntArray(0)
+
+    /** Eta file: the pivot position and the nonzero entries of each eta vector. */
+    private val etaPosition = ArrayList<Int>()
+    private val etaIndexes = ArrayList<IntArray>()
+    private val etaValues = ArrayList<DoubleArray>()
+
+    var verdict: Verdict = Verdict.FEASIBLE
+        private set
+
+    /** Number of pivots since creation of the solver. */
+    var pivots: Long = 0L
+        private set
+
+    /** Adds the constraint Σ coefficients[k]·ε(ids[k]) >= rhs, or <= rhs if not greaterOrEqual. */
+    fun addRow(ids: LongArray, coefficients: DoubleArray, count: Int, greaterOrEqual: Boolean, rhs: Double) {
+        val columns = IntArray(count) { k -> index.getOrPut(ids[k]) { index.size } }
+        rowColumns.add(columns)
+        rowValues.add(coefficients.copyOf(count))
+        rowGreaterOrEqual.add(greaterOrEqual)
+        rowRhs.add(rhs)
+    }
+
+    /** Computes a feasible basis for all constraints added by [addRow]. */
+    fun restoreFeasibility(): Verdict {
+        build()
+        verdict = dualSimplex()
+        return verdict
+    }
+
+    /**
+     * Maximizes Σ coefficients[k]·ε(ids[k]) subject to the constraints.
+     * @return the maximum, or null if the constraints are not feasible or the solver did not converge.
+     */
+    fun maximize(ids: LongArray, coefficients: DoubleArray, count: Int): Double? {
+        if (verdict != Verdict.FEASIBLE) return null
+        cost.fill(0.0)
+        var free = 0.0
+        for (k in 0 until count) {
+            val c = coefficients[k]
+            val j = index[ids[k]]
+            if (j == null || j >= n) free += c * (if (c > 0.0) upperBound else lowerBound)
+            else cost[j] += c
+        }
+        return primalSimplex()?.plus(free)
+    }
+
+    /** @see maximize */
+    fun minimize(ids: LongArray, coefficients: DoubleArray, count: Int): Double? {
+        val negated = DoubleArray(count) { -coefficients[it] }
+        return maximize(ids, negated, count)?.let { -it }
+    }
+
+    /** Sets up the column-wise matrix and the slack basis, with all structural variables at their lower bound. */
+    private fun build() {
+        n = index.size
+        m = rowColumns.size
+        val total = n + m
+        columnStart = IntArray(total + 1)
+        for (columns in rowColumns) for (j in columns) columnStart[j + 1]++
+        for (i in 0 until m) columnStart[n + i + 1] = 1
+        for (j in 0 until total) columnStart[j + 1] += columnStart[j]
+        entryRow = IntArray(columnStart[total])
+        entryValue = DoubleArray(columnStart[total])
+        val fill = columnStart.copyOf(total)
+        for (i in 0 until m) {
+            val columns = rowColumns[i]
+            val values = rowValues[i]
+            for (k in columns.indices) {
+                val e = fill[columns[k]]++
+                entryRow[e] = i
+                entryValue[e] = values[k]
+            }
+            val e = fill[n + i]++
+            entryRow[e] = i
+            entryValue[e] = -1.0
+        }
+
+        lo = DoubleArray(total) { j -> if (j < n) lowerBound else if (rowGreaterOrEqual[j - n]) rowRhs[j - n] else Double.NEGATIVE_INFINITY }
+        hi = DoubleArray(total) { j -> if (j < n) upperBound else if (rowGreaterOrEqual[j - n]) Double.POSITIVE_INFINITY else rowRhs[j - n] }
+        x = DoubleArray(total) { j -> if (j < n) lowerBound else 0.0 }
+        cost = DoubleArray(total)
+        basis = IntArray(m) { n + it }
+        position = IntArray(total) { j -> if (j < n) NONBASIC else j - n }
+        etaPosition.clear()
+        etaIndexes.clear()
+        etaValues.clear()
+        updateBasicValues()
+    }
+
+    /** Applies the eta file to y, i.e. computes y := E_k ... E_1 y. */
+    private fun applyEtas(y: DoubleArray) {
+        for (k in etaPosition.indices) {
+            val p = etaPosition[k]
+            val yp = y[p]
+            if (yp == 0.0) continue
+            y[p] = 0.0
+            val indexes = etaIndexes[k]
+            val values = etaValues[k]
+            for (e in indexes.indices) y[indexes[e]] += values[e] * yp
+        }
+    }
+
+    /** Solves B y = a_j for column j. */
+    private fun ftran(j: Int): DoubleArray {
+        val y = DoubleArray(m)
+        for (e in columnStart[j] until columnStart[j + 1]) y[entryRow[e]] = -entryValue[e]
+        applyEtas(y)
+        return y
+    }
+
+    /** Solves B^T y = v; v is overwritten. */
+    private fun btran(v: DoubleArray): DoubleArray {
+        for (k in etaPosition.indices.reversed()) {
+            val indexes = etaIndexes[k]
+            val values = etaValues[k]
+            var w = 0.0
+            for (e in indexes.indices) w += values[e] * v[indexes[e]]
+            v[etaPosition[k]] = w
+        }
+        for (i in v.indices) v[i] = -v[i]
+        return v
+    }
+
+    private fun dot(v: DoubleArray, j: Int): Double {
+        var sum = 0.0
+        for (e in columnStart[j] until columnStart[j + 1]) sum += v[entryRow[e]] * entryValue[e]
+        return sum
+    }
+
+    /** Computes the basic variables from the nonbasic ones: x_B = B^-1 (-N x_N). */
+    private fun updateBasicValues() {
+        val y = DoubleArray(m)
+        for (j in 0 until n + m) {
+            if (position[j] != NONBASIC || x[j] == 0.0) continue
+            for (e in columnStart[j] until columnStart[j + 1]) y[entryRow[e]] += entryValue[e] * x[j]
+        }
+        applyEtas(y)
+        for (p in 0 until m) x[basis[p]] = y[p]
+    }
+
+    private fun addEta(p: Int, y: DoubleArray) {
+        val yp = y[p]
+        var count = 0
+        for (i in 0 until m) if (i == p || y[i] != 0.0) count++
+        val indexes = IntArray(count)
+        val values = DoubleArray(count)
+        var k = 0
+        for (i in 0 until m) {
+            if (i == p) { indexes[k] = i; values[k++] = 1.0 / yp }
+            else if (y[i] != 0.0) { indexes[k] = i; values[k++] = -y[i] / yp }
+        }
+        etaPosition.add(p)
+        etaIndexes.add(indexes)
+        etaValues.add(values)
+    }
+
+    /** Replaces the basic variable at position p by variable l with the column y = B^-1 a_l. */
+    private fun pivot(p: Int, l: Int, y: DoubleArray) {
+        pivots++
+        val leaving = basis[p]
+        addEta(p, y)
+        basis[p] = l
+        position[l] = p
+        position[leaving] = NONBASIC
+        if (etaPosition.size >= refactorInterval) refactor()
+    }
+
+    /**
+     * Computes the product form of the current basis from the slack basis.
+     * Basic slack variables keep their position; each basic structural variable takes the free position with
+     * the largest pivot.
+     */
+    private fun refactor() {
+        val target = basis.copyOf()
+        etaPosition.clear()
+        etaIndexes.clear()
+        etaValues.clear()
+        val free = BooleanArray(m) { true }
+        for (b in target) if (b >= n) free[b - n] = false
+        val newBasis = IntArray(m) { n + it }
+        for (b in target) {
+            if (b >= n) continue
+            val y = ftran(b)
+            var p = -1
+            for (i in 0 until m) if (free[i] && (p == -1 || abs(y[i]) > abs(y[p]))) p = i
+            if (p == -1 || abs(y[p]) < EPS) throw IllegalStateException("SparseLpSolver: singular basis")
+            addEta(p, y)
+            free[p] = false
+            newBasis[p] = b
+        }
+        basis = newBasis
+        position.fill(NONBASIC)
+        for (p in 0 until m) position[basis[p]] = p
+    }
+
+    /** Reduced costs d_j = c_j - c_B^T B^-1 a_j of the nonbasic variables. */
+    private fun reducedCosts(): DoubleArray {
+        val pi = btran(DoubleArray(m) { cost[basis[it]] })
+        return DoubleArray(n + m) { j -> if (position[j] == NONBASIC) cost[j] - dot(pi, j) else 0.0 }
+    }
+
+    private fun canIncrease(j: Int) = x[j] < hi[j]
+    private fun canDecrease(j: Int) = x[j] > lo[j]
+
+    /** Dual simplex with the same pivoting rules as [IncrementalLpSolver]. */
+    private fun dualSimplex(): Verdict {
+        try {
+            repeat(maxIterations) {
+                var k = -1
+                var worst = EPS
+                for (p in 0 until m) {
+                    val b = basis[p]
+                    val v = x[b]
+                    val violation = if (v < lo[b]) lo[b] - v else if (v > hi[b]) v - hi[b] else 0.0
+                    if (violation > worst) { worst = violation; k = p }
+                }
+                if (k == -1) return Verdict.FEASIBLE
+
+                val b = basis[k]
+                val increase = x[b] < lo[b]
+                val d = reducedCosts()
+                // Row k of the tableau: -(B^-1 a_j)_k for the nonbasic columns j.
+                val unit = DoubleArray(m)
+                unit[k] = 1.0
+                val rho = btran(unit)
+                var l = -1
+                var best = Double.POSITIVE_INFINITY
+                var bestA = 0.0
+                for (j in 0 until n + m) {
+                    if (position[j] != NONBASIC) continue
+                    val a = -dot(rho, j)
+                    if (abs(a) < EPS) continue
+                    val up = (a > 0.0) == increase
+                    if (up && !canIncrease(j) || !up && !canDecrease(j)) continue
+                    val ratio = abs(d[j]) / abs(a)
+                    if (ratio < best - EPS || (ratio < best + EPS && abs(a) > bestA)) {
+                        best = ratio; l = j; bestA = abs(a)
+                    }
+                }
+                if (l == -1) return Verdict.INFEASIBLE
+
+                val y = ftran(l)
+                val target = if (increase) lo[b] else hi[b]
+                x[l] += (target - x[b]) / -y[k]
+                pivot(k, l, y)
+                x[b] = target
+                updateBasicValues()
+            }
+        } catch (e: IllegalStateException) {
+            return Verdict.FAILED
+        }
+        return Verdict.FAILED
+    }
+
+    /**
+     * Primal simplex with Bland's rule, breaking ties of the ratio test by the smallest index of the leaving
+     * basic variable; returns the maximum without the free term or null.
+     */
+    private fun primalSimplex(): Double? {
+        try {
+            repeat(maxIterations) {
+                val d = reducedCosts()
+                var e = -1
+                for (j in 0 until n + m) {
+                    if (position[j] != NONBASIC) continue
+                    if (d[j] > EPS && canIncrease(j) || d[j] < -EPS && canDecrease(j)) { e = j; break }
+                }
+                if (e == -1) {
+                    var value = 0.0
+                    for (j in 0 until n) if (cost[j] != 0.0) value += cost[j] * x[j]
+                    return value
+                }
+
+                val direction = if (d[e] > 0.0) 1.0 else -1.0
+                val y = ftran(e)
+                var theta = hi[e] - lo[e]
+                var k = -1
+                for (p in 0 until m) {
+                    val a = -y[p]
+                    if (abs(a) < EPS) continue
+                    val b = basis[p]
+                    val rate = a * direction
+                    val limit = if (rate > 0.0) (hi[b] - x[b]) / rate else (lo[b] - x[b]) / rate
+                    if (limit < theta || (limit == theta && k != -1 && b < basis[k])) { theta = limit; k = p }
+                }
+                if (theta == Double.POSITIVE_INFINITY) return null
+
+                if (k == -1) {
+                    x[e] = if (direction > 0.0) hi[e] else lo[e]
+                } else {
+                    val b = basis[k]
+                    val rate = -y[k] * direction
+                    x[e] += direction * max(theta, 0.0)
+                    pivot(k, e, y)
+                    x[b] = if (rate > 0.0) hi[b] else lo[b]
+                }
+                updateBasicValues()
+            }
+        } catch (e: IllegalStateException) {
+            return null
+        }
+        return null
+    }
+
+    override fun toString(): String =
+        "SparseLpSolver: $n columns, $m rows, ${entryRow.size} nonzeros, $verdict, $pivots pivots"
+
+    private companion object {
+        const val EPS = 1e-9
+        const val NONBASIC = -1
+    }
+}
@@ -22,7 +22,7 @@ import io.github.tukcps.aadd.values.real.minus
  * */
 fun relu(af: AffineForm, builder: DDBuilder, split_threshold : Double = 0.1) : AADD {
     with(builder) {
-        var res: AADD = AADD.Leaf(this, af)
+        var res: AADD = real(af)
         if (af.min <= DoubleBound.Finite(0.0)) {
             val pct = ((0.0 - af.min)!! / (af.max - af.min)!!)?: DoubleBound.PositiveInfinity
             if(pct < DoubleBound.Finite(split_threshold)) {
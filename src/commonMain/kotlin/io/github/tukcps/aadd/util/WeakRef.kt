@@ -0,0 +1,10 @@
+package io.github.tukcps.aadd.util
+
+/**
+ * A weak reference that does not prevent the referred object from being collected.
+ * Used by caches of the builder that shall not keep unused decision diagrams alive.
+ */
+internal expect class WeakRef<T: Any>(referred: T) {
+    /** @return the referred object, or null if it has been collected. */
+    fun get(): T?
+}
@@ -26,7 +26,8 @@ import kotlin.math.*
  * @param min The minimum value of an interval interpretation
  * @param max The maximum value of an interval interpretation
  * @param central The central value of the affine form
- * @param xi The noise variables of the affine form; if it is an empty set, we only use min/max.
+ * @param xi The noise variables of the affine form, as sparse vector sorted by index;
+ * if it is an empty set, we only use min/max.
  * Note that the Affine Form also inherits RealRange that holds min/max values of interval arithmetic
  * computations. That are used to reduce over-approximation in particular for non-linear operations.
  */
@@ -35,14 +36,14 @@ class AffineForm internal constructor(
     min: DoubleBound,
     max: DoubleBound,
     var central: Double,
-    val xi: HashMap<Long, Double> = HashMap(300, 0.75F),
+    val xi: NoiseTerms = NoiseTerms(),
 ) : RealRange(min, max), NumberRange<DoubleBound>, RealValue {
 
     /**
      * Creates an affine form as a clone of an existing affine form.
      */
     constructor(builder: DDBuilder, af: AffineForm):
-            this(builder, af.min, af.max, af.central, HashMap(af.xi))
+            this(builder, af.min, af.max, af.central, NoiseTerms(af.xi))
 
     /**
      * Creates an affine form as a clone of an existing affine form,
@@ -53,7 +54,7 @@ class AffineForm internal constructor(
         builder = af.builder,
         min = af.min, max = af.max,
         central = af.central,
-        xi =HashMap(af.xi)
+        xi = NoiseTerms(af.xi)
     )
 
     /**
@@ -64,12 +65,7 @@ class AffineForm internal constructor(
     val radius: Double
         get() = when {
             (isEmpty()) -> 0.0
-            else -> {
-                var result = 0.0
-                for (v in xi.values)
-                    result = math.add(result, abs(v), Rounding.UP)
-                result
-            }
+            else -> xi.absSum(Rounding.UP, builder.math)
         }
 
     /**
@@ -123,9 +119,7 @@ class AffineForm internal constructor(
         if (other === this) return true
         var uncorrelated = abs(central - other.central)
         uncorrelated = (uncorrelated + uncorrelated.ulp) / 2.0
-        for (i in xi.keys+other.xi.keys) {
-            val xi = xi.getOrElse(i){0.0}
-            val yi = other.xi.getOrElse(i){0.0}
+        NoiseTerms.forEachPair(xi, other.xi) { _, xi, yi ->
             uncorrelated += if (xi * yi > 0) abs(xi - yi) else xi + yi
         }
         return uncorrelated < tol
@@ -170,17 +164,16 @@ class AffineForm internal constructor(
      * @return the joined range as affine form.
      */
     fun join(other: AffineForm): AffineForm {
+        val math = builder.math
         var (newCentral, centralErr) = math.addRounded(central, other.central)
         newCentral /= 2
         var newNoise = abs(math.sub(central, other.central, Rounding.UP))
         newNoise = math.div(newNoise, 2.0, Rounding.UP)
         newNoise = math.add(newNoise, centralErr, Rounding.UP)
-        val newXi = HashMap<Long, Double>()
-        for (i in xi.keys+other.xi.keys) {
-            val xi = xi.getOrElse(i){0.0}
-            val yi = other.xi.getOrElse(i){0.0}
+        val newXi = NoiseTerms(max(xi.size, other.xi.size))
+        NoiseTerms.forEachPair(xi, other.xi) { i, xi, yi ->
             if (xi * yi > 0) {
-                newXi[i] = min(abs(xi), abs(yi)) * sign(xi)
+                newXi.append(i, min(abs(xi), abs(yi)) * sign(xi))
                 val dif = abs(math.sub(xi, yi, Rounding.UP))
                 newNoise = math.add(newNoise, dif, Rounding.UP)
             } else {
@@ -213,6 +206,7 @@ class AffineForm internal constructor(
     companion object {
         /**
          * Platform-dependent rounding methods ...
+         * Affine forms use the rounding of their builder, see [DDBuilder.math]; this one is the default.
          */
         val math: RoundingMath = IEEE754RoundingMath
 
@@ -231,12 +225,12 @@ class AffineForm internal constructor(
             scalar.isNaN() -> builder.AF.Empty
             else -> {
                 val bound = scalar.toDoubleBound()!!
-                AffineForm(builder, bound, bound, scalar, hashMapOf())
+                AffineForm(builder, bound, bound, scalar, NoiseTerms(0))
             }
         }
 
         fun scalar(builder: DDBuilder, scalar: DoubleBound): AffineForm =
-            AffineForm(builder, scalar, scalar, scalar.toDouble(), hashMapOf())
+            AffineForm(builder, scalar, scalar, scalar.toDouble(), NoiseTerms(0))
 
         /**
          * Creates an affine form from an interval representation.
@@ -259,12 +253,12 @@ class AffineForm internal constructor(
             if (min == max) return scalar(builder, min.toDouble())
             if (min is DoubleBound.Finite && max is DoubleBound.Finite) {
                 val central = math.midpoint(min, max, Rounding.NEAREST).toDouble()
-                val xi = hashMapOf<Long, Double>()
-                xi [builder.noiseVariables.newNoiseVar(id)] = (max.finiteValue - min.finiteValue) / 2.0
+                val xi = NoiseTerms(1)
+                xi.append(builder.noiseVariables.newNoiseVar(id), (max.finiteValue - min.finiteValue) / 2.0)
                 return AffineForm(builder, min, max, central, xi)
             }
             return if (min is DoubleBound.Finite || max is DoubleBound.Finite) {
-                AffineForm(builder, min, max, Double.NaN, hashMapOf())
+                AffineForm(builder, min, max, Double.NaN, NoiseTerms(0))
             } else
                 builder.AF.All
         }
@@ -282,23 +276,23 @@ class AffineForm internal constructor(
          * - if radius is infinite, drop xi completely & set r to +Infinity (hence, use Range only)
          * - if central, radios or any of Xi is NaN, drop xi, drop xi completely & set r to Infinity (hence, use Range only)
          * - check
+         * - xi is copied and not modified.
          */
-        fun create(builder: DDBuilder, min: DoubleBound, max: DoubleBound, central: Double, newNoise: Double, xi: HashMap<Long, Double> = hashMapOf()): AffineForm {
+        fun create(builder: DDBuilder, min: DoubleBound, max: DoubleBound, central: Double, newNoise: Double, xi: Map<Long, Double> = NoiseTerms(0)): AffineForm {
 
-            builder.noiseVariables.compressGarbageVariables(xi)
+            val math = builder.math
+            val newXi = NoiseTerms(xi)
+            builder.noiseVariables.compressGarbageVariables(newXi)
 
             if (newNoise != 0.0) {
-                val i = builder.noiseVariables.newGarbageVar()
-                xi[i] = newNoise
+                // Garbage variables count down; the new one has the smallest index.
+                newXi.put(builder.noiseVariables.newGarbageVar(), newNoise)
             }
 
             val newCentral: Double = central
-            val newXi = HashMap(xi)
 
             // Compute total radius including noise symbols
-            val radius = xi.values.fold(0.0) { acc, value ->
-                math.add(acc, abs(value), Rounding.UP)
-            }
+            val radius = newXi.absSum(Rounding.UP, math)
 
             // Ensure some invariants and canonical representation for special cases
             when {
@@ -315,7 +309,7 @@ class AffineForm internal constructor(
             val newMax: DoubleBound?
             val newMin: DoubleBound?
             // Update min and max to the best approximation of IA and AA, iff there is valid xi.
-            if (xi.isNotEmpty()) {
+            if (newXi.isNotEmpty()) {
                 newMin = max(min.toDouble(), math.sub(newCentral, radius, Rounding.DOWN)).toDoubleBound()
                 newMax = min(max.toDouble(), math.add(newCentral, radius, Rounding.UP)).toDoubleBound()
             } else {
@@ -335,7 +329,7 @@ class AffineForm internal constructor(
                 // All Reals, mapped to singleton.
                 newMin.isNegativeInfinity && newMax.isPositiveInfinity -> builder.AF.All
                 // Scalar. Represented by canonical form without xi.
-                (newMin == newMax) && newMin.isFinite -> AffineForm(builder, newMin, newMax, newMax.toDouble(), xi)
+                (newMin == newMax) && newMin.isFinite -> AffineForm(builder, newMin, newMax, newMax.toDouble(), newXi)
                 // Regular case, all new values in use.
                 else -> AffineForm(builder, newMin, newMax, newCentral, newXi)
             }
@@ -348,14 +342,14 @@ class AffineForm internal constructor(
          * @param range closed range for the IA part
          * @param central central value of the AA part
          * @param newNoise IA noise term of the Affine Form
-         * @param xi Hashmap with the noise variables (index to Double)
+         * @param xi the noise variables (index to Double)
          */
         fun create(
             builder: DDBuilder,
             range: RealRange,
             central: Double,
             newNoise: Double,
-            xi: HashMap<Long, Double> = HashMap(300, 0.75F)
+            xi: Map<Long, Double> = NoiseTerms(0)
         ): AffineForm = create(builder, range.min, range.max, central, newNoise, xi)
 
     }
@@ -3,7 +3,6 @@ package io.github.tukcps.aadd.values.real.aa
 import io.github.tukcps.aadd.values.real.DoubleBound
 import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
 import io.github.tukcps.aadd.values.real.aa.AffineForm.Companion.create
-import io.github.tukcps.aadd.values.real.aa.AffineForm.Companion.math
 import io.github.tukcps.aadd.values.real.aa.AffineForm.Companion.range
 import io.github.tukcps.aadd.values.real.ia.RealRange
 import io.github.tukcps.aadd.values.real.ia.affine
@@ -24,9 +23,8 @@ fun add(a: AffineForm, b: Double): AffineForm {
         b == Double.POSITIVE_INFINITY -> return AffineForm.scalar(a.builder, Double.POSITIVE_INFINITY)
         b == Double.NEGATIVE_INFINITY -> return AffineForm.scalar(a.builder, Double.NEGATIVE_INFINITY)
     }
-    val newNoiseTerms = HashMap(a.xi)
-    val (newCentral, err) = math.addRounded(a.central, b)
-    return create(a.builder, a as RealRange + RealRange(b), newCentral, err, newNoiseTerms)
+    val (newCentral, err) = a.builder.math.addRounded(a.central, b)
+    return create(a.builder, a as RealRange + RealRange(b), newCentral, err, a.xi)
 }
 
 /**
@@ -46,15 +44,9 @@ fun add(a: AffineForm, b: AffineForm): AffineForm {
         b.isZero()                  -> return a
     }
 
-    val newXi = HashMap<Long, Double>(2 * a.builder.settings.affineFormHashMapSize)
+    val math = a.builder.math
     val (newCentral, errNewCentral) = math.addRounded(a.central, b.central)
-
-    for (i in a.xi.keys + b.xi.keys) {
-        val v1 = a.xi[i] ?: 0.0
-        val v2 = b.xi[i] ?: 0.0
-        val sum = math.add(v1, v2, Rounding.AWAY)
-        if (sum != 0.0) newXi[i] = sum
-    }
+    val newXi = NoiseTerms.add(a.xi, b.xi, Rounding.AWAY, math)
 
     return create(a.builder, a as RealRange + b as RealRange, newCentral, errNewCentral, newXi)
 }
@@ -67,8 +59,7 @@ fun negate(value: AffineForm): AffineForm {
         value.isZero() -> return value.builder.AF.Zero
     }
     val nc = -value.central
-    val nts = HashMap<Long, Double>(value.builder.settings.affineFormHashMapSize)
-    value.xi.keys.forEach { nts[it] = -value.xi[it]!! }
+    val nts = NoiseTerms.negate(value.xi)
     return create(value.builder, negateRange(value as RealRange), nc, 0.0, nts)
 }
 
@@ -80,7 +71,22 @@ fun negate(value: AffineForm): AffineForm {
  * @param b right affine form
  * @return affine enclosure of the difference
  */
-fun subtract(a: AffineForm, b: AffineForm): AffineForm = add(a, negate(b))
+fun subtract(a: AffineForm, b: AffineForm): AffineForm {
+    check(a.builder == b.builder)
+    when {
+        a.isEmpty() || b.isEmpty()  -> return a.builder.AF.Empty
+        a.isReals() || b.isReals()  -> return a.builder.AF.All
+        a.isZero()                  -> return negate(b)
+        b.isZero()                  -> return a
+    }
+
+    val math = a.builder.math
+    val (newCentral, errNewCentral) = math.addRounded(a.central, -b.central)
+    val newXi = NoiseTerms.subtract(a.xi, b.xi, Rounding.AWAY, math)
+
+    return create(a.builder, a as RealRange + negateRange(b as RealRange), newCentral, errNewCentral, newXi)
+}
+
 fun subtract(a: AffineForm, b: Double): AffineForm = add(a, -b)
 
 /** Scalar addition, multiplication and noise increment on a single form */
@@ -91,9 +97,8 @@ fun affine(value: AffineForm, alpha: Double, delta: Double, noise: Double): Affi
     }
     val newCenter = FMA.compute(value.central, alpha, delta)
     val newR = noise
-    val newXi = HashMap<Long, Double>(value.xi.size + 1)
-    for ((id, coeff) in value.xi)
-        newXi[id] = math.mul(coeff, alpha, Rounding.AWAY)
+    val math = value.builder.math
+    val newXi = NoiseTerms.scale(value.xi, alpha, Rounding.AWAY, dropZeros = false, math = math)
     val nMin = math.add(math.mul(value.min.toDouble(), alpha, Rounding.DOWN), delta, Rounding.DOWN)
     val nMax = math.add(math.mul(value.max.toDouble(), alpha, Rounding.UP), delta, Rounding.UP)
     return create(value.builder,
@@ -122,9 +127,8 @@ fun affine(
     val newCenter = FMA.compute(value.central, alpha, delta)
     val newNoise = noise
 
-    val newXi = HashMap<Long, Double>(value.xi.size + 1)
-    for ((id, coeff) in value.xi)
-        newXi[id] = math.mul(coeff, alpha, Rounding.AWAY)
+    val math = value.builder.math
+    val newXi = NoiseTerms.scale(value.xi, alpha, Rounding.AWAY, dropZeros = false, math = math)
 
     val nMin = math.add(math.mul(value.min.toDouble(), alpha, Rounding.DOWN), delta, Rounding.DOWN)
     val nMax = math.add(math.mul(value.max.toDouble(), alpha, Rounding.UP), delta, Rounding.UP)
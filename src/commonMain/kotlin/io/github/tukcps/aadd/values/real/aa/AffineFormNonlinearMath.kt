@@ -59,8 +59,8 @@ fun multiply(a: AffineForm, b: Double): AffineForm {
         b == 0.0         -> return scalar(a.builder, 0.0)
         b == 1.0         -> return a
     }
-    val newXi = HashMap<Long, Double>(a.builder.settings.affineFormHashMapSize)
-    a.xi.keys.forEach { newXi[it] = math.mul(a.xi[it]!!, b, Rounding.AWAY) }
+    val math = a.builder.math
+    val newXi = NoiseTerms.scale(a.xi, b, Rounding.AWAY, dropZeros = false, math = math)
     val newCentralRounded = math.mulRounded(a.central, b)
     return create(a.builder,
         multiply(a as RealRange, RealRange(b)) ,
@@ -89,16 +89,13 @@ fun multiply(a: AffineForm, b: AffineForm): AffineForm {
     if (!a.isFinite() || !b.isFinite())  // Open range? --> IA
         return range(a.builder, multiply(a as RealRange, b as RealRange))
 
+    val math = a.builder.math
     val newCentral = math.mulRounded(a.central, b.central)
     var noise = math.mul(a.radius, b.radius, Rounding.AWAY)
-    val nts = HashMap<Long, Double>()
-    val idx: MutableSet<Long> = HashSet(a.xi.keys)
-    idx.addAll(b.xi.keys)
-    idx.forEach {
-        val xi = if (a.xi.containsKey(it)) a.xi[it]!! else 0.0
-        val yi = if (b.xi.containsKey(it)) b.xi[it]!! else 0.0
-        nts[it] = xi * b.central + yi * a.central
-        noise += nts[it]!!.ulp
+    val nts = NoiseTerms.merge(a.xi, b.xi, dropZeros = false) { xi, yi ->
+        val v = xi * b.central + yi * a.central
+        noise += v.ulp
+        v
     }
     return create(a.builder, multiply(a as RealRange, b as RealRange), newCentral.value, noise, nts)
 }
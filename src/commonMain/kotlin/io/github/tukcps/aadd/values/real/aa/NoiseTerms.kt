@@ -0,0 +1,396 @@
+package io.github.tukcps.aadd.values.real.aa
+
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
+import kotlin.math.max
+
+/**
+ * ## Noise Terms
+ *
+ * The partial deviations x_i of an affine form, stored as a sparse vector:
+ * two parallel arrays with the noise symbol indexes in ascending order and their coefficients.
+ *
+ * Affine forms usually have only a few noise symbols, but are created in large numbers (one per leaf
+ * and intermediate result). Compared to a pre-sized hash map, the arrays need far less memory, and
+ * the binary operations of affine arithmetic become a single linear merge of two sorted arrays.
+ *
+ * For compatibility, the noise terms can still be used as a `MutableMap<Long, Double>`.
+ * Performance-critical code should iterate via [size], [idAt] and [coefficientAt], or use the
+ * merge operations in the companion object.
+ */
+class NoiseTerms private constructor(
+    ids: LongArray,
+    coefficients: DoubleArray,
+    count: Int
+) : AbstractMutableMap<Long, Double>() {
+
+    /** Noise symbol indexes, ascending; only the first [size] entries are valid. */
+    internal var ids: LongArray = ids
+        private set
+
+    /** Coefficients, in the order of [ids]; only the first [size] entries are valid. */
+    internal var coefficients: DoubleArray = coefficients
+        private set
+
+    private var count: Int = count
+
+    /** The last renumbering of the noise symbols that was applied, see [renumber]. */
+    private var generation: Int = 0
+
+    /**
+     * Creates empty noise terms.
+     * @param capacity initial capacity; the arrays grow if needed.
+     */
+    constructor(capacity: Int = 4) : this(LongArray(capacity), DoubleArray(capacity), 0)
+
+    /**
+     * Creates noise terms as a copy of a map from noise symbol index to coefficient.
+     */
+    constructor(other: Map<Long, Double>) : this(LongArray(other.size), DoubleArray(other.size), 0) {
+        if (other is NoiseTerms) {
+            other.ids.copyInto(ids, 0, 0, other.count)
+            other.coefficients.copyInto(coefficients, 0, 0, other.count)
+            count = other.count
+        } else
+            for (id in other.keys.sorted())
+                append(id, other[id]!!)
+    }
+
+    override val size: Int
+        get() = count
+
+    /** @return the index of the k-th noise symbol, in ascending order. */
+    fun idAt(k: Int): Long = ids[k]
+
+    /** @return the coefficient of the k-th noise symbol, in ascending order. */
+    fun coefficientAt(k: Int): Double = coefficients[k]
+
+    /**
+     * Binary search for a noise symbol.
+     * @return the position of [id], or (-(insertion point) - 1) if it is not contained.
+     */
+    private fun indexOf(id: Long): Int {
+        var low = 0
+        var high = count - 1
+        while (low <= high) {
+            val mid = (low + high) ushr 1
+            val midId = ids[mid]
+            when {
+                midId < id -> low = mid + 1
+                midId > id -> high = mid - 1
+                else -> return mid
+            }
+        }
+        return -(low + 1)
+    }
+
+    private fun ensureCapacity(capacity: Int) {
+        if (capacity <= ids.size) return
+        val newCapacity = max(capacity, max(4, 2 * ids.size))
+        ids = ids.copyOf(newCapacity)
+        coefficients = coefficients.copyOf(newCapacity)
+    }
+
+    /**
+     * Appends a noise term with an index larger than all contained indexes.
+     * Used by the merge operations that produce the terms in ascending order.
+     */
+    internal fun append(id: Long, coefficient: Double) {
+        require(count == 0 || ids[count - 1] < id) { "noise terms must be appended in ascending order" }
+        ensureCapacity(count + 1)
+        ids[count] = id
+        coefficients[count] = coefficient
+        count++
+    }
+
+    override fun get(key: Long): Double? {
+        val k = indexOf(key)
+        return if (k >= 0) coefficients[k] else null
+    }
+
+    override fun containsKey(key: Long): Boolean = indexOf(key) >= 0
+
+    override fun put(key: Long, value: Double): Double? {
+        val k = indexOf(key)
+        if (k >= 0) {
+            val old = coefficients[k]
+            coefficients[k] = value
+            return old
+        }
+        val insert = -(k + 1)
+        ensureCapacity(count + 1)
+        ids.copyInto(ids, insert + 1, insert, count)
+        coefficients.copyInto(coefficients, insert + 1, insert, count)
+        ids[insert] = key
+        coefficients[insert] = value
+        count++
+        return null
+    }
+
+    override fun remove(key: Long): Double? {
+        val k = indexOf(key)
+        if (k < 0) return null
+        val old = coefficients[k]
+        removeAt(k)
+        return old
+    }
+
+    internal fun removeAt(k: Int) {
+        ids.copyInto(ids, k, k + 1, count)
+        coefficients.copyInto(coefficients, k, k + 1, count)
+        count--
+    }
+
+    /**
+     * Removes all terms for which [predicate] of their position is true, in a single pass.
+     * @param predicate called with the position of each term before the removal.
+     */
+    internal fun removeIf(predicate: (position: Int) -> Boolean) {
+        var n = 0
+        for (k in 0 until count) {
+            if (predicate(k)) continue
+            ids[n] = ids[k]
+            coefficients[n] = coefficients[k]
+            n++
+        }
+        count = n
+    }
+
+    override fun clear() {
+        count = 0
+    }
+
+    /**
+     * Replaces each noise symbol index by its new index, once per renumbering of the noise symbols;
+     * noise terms that are shared by several affine forms are renumbered only once.
+     * @param generation a number that identifies the renumbering.
+     * @param newIndex the new index of an index; it must preserve the order of the indexes.
+     */
+    internal fun renumber(generation: Int, newIndex: (Long) -> Long) {
+        if (this.generation == generation) return
+        this.generation = generation
+        for (k in 0 until count)
+            ids[k] = newIndex(ids[k])
+    }
+
+    /**
+     * Sum of the absolute values of the coefficients, rounded as given.
+     * With [Rounding.UP] this is the radius of the affine form.
+     * @param math the implementation of the rounding, usually the one of the builder.
+     */
+    fun absSum(rounding: Rounding = Rounding.UP, math: RoundingMath = AffineForm.math): Double =
+        math.absSum(coefficients, count, rounding)
+
+    /** Equality as for maps; with fast path for noise terms. */
+    override fun equals(other: Any?): Boolean {
+        if (other !is NoiseTerms) return super.equals(other)
+        if (count != other.count) return false
+        for (k in 0 until count)
+            if (ids[k] != other.ids[k] || coefficients[k].toBits() != other.coefficients[k].toBits())
+                return false
+        return true
+    }
+
+    /** Hash code as for maps, without creating entries. */
+    override fun hashCode(): Int {
+        var result = 0
+        for (k in 0 until count)
+            result += ids[k].hashCode() xor coefficients[k].hashCode()
+        return result
+    }
+
+    override val entries: MutableSet<MutableMap.MutableEntry<Long, Double>>
+        get() = EntrySet()
+
+    private inner class TermEntry(val position: Int) : MutableMap.MutableEntry<Long, Double> {
+        override val key: Long get() = ids[position]
+        override val value: Double get() = coefficients[position]
+        override fun setValue(newValue: Double): Double {
+            val old = coefficients[position]
+            coefficients[position] = newValue
+            return old
+        }
+        override fun equals(other: Any?): Boolean =
+            other is Map.Entry<*, *> && other.key == key && other.value == value
+        override fun hashCode(): Int = key.hashCode() xor value.hashCode()
+        override fun toString(): String = "$key=$value"
+    }
+
+    private inner class EntrySet : AbstractMutableSet<MutableMap.MutableEntry<Long, Double>>() {
+        override val size: Int get() = count
+        override fun add(element: MutableMap.MutableEntry<Long, Double>): Boolean =
+            throw UnsupportedOperationException("use put to add noise terms")
+        override fun iterator(): MutableIterator<MutableMap.MutableEntry<Long, Double>> =
+            object : MutableIterator<MutableMap.MutableEntry<Long, Double>> {
+                private var next = 0
+                private var last = -1
+                override fun hasNext(): Boolean = next < count
+                override fun next(): MutableMap.MutableEntry<Long, Double> {
+                    if (next >= count) throw NoSuchElementException()
+                    last = next++
+                    return TermEntry(last)
+                }
+                override fun remove() {
+                    check(last >= 0) { "next() has not been called" }
+                    removeAt(last)
+                    next = last
+                    last = -1
+                }
+            }
+    }
+
+    companion object {
+
+        /**
+         * Walks through the union of the noise symbols of [a] and [b] in ascending order,
+         * calling [action] with the index and both coefficients (0.0 if not present).
+         */
+        internal inline fun forEachPair(a: NoiseTerms, b: NoiseTerms, action: (id: Long, x: Double, y: Double) -> Unit) {
+            var i = 0
+            var j = 0
+            val m = a.size
+            val n = b.size
+            while (i < m || j < n) {
+                val ai = if (i < m) a.idAt(i) else Long.MAX_VALUE
+                val bj = if (j < n) b.idAt(j) else Long.MAX_VALUE
+                when {
+                    j >= n || (i < m && ai < bj) -> action(ai, a.coefficientAt(i++), 0.0)
+                    i >= m || bj < ai -> action(bj, 0.0, b.coefficientAt(j++))
+                    else -> action(ai, a.coefficientAt(i++), b.coefficientAt(j++))
+                }
+            }
+        }
+
+        /**
+         * Merges [a] and [b] into new noise terms, computing each coefficient by [op]
+         * of the coefficients of both (0.0 if not present).
+         * @param dropZeros if true, terms with a zero result are not stored.
+         */
+        internal inline fun merge(
+            a: NoiseTerms,
+            b: NoiseTerms,
+            dropZeros: Boolean = true,
+            op: (x: Double, y: Double) -> Double
+        ): NoiseTerms {
+            val result = NoiseTerms(a.size + b.size)
+            forEachPair(a, b) { id, x, y ->
+                val v = op(x, y)
+                if (!dropZeros || v != 0.0) result.append(id, v)
+            }
+            return result
+        }
+
+        /**
+         * Maps the coefficients of [a] to new noise terms by [op].
+         * @param dropZeros if true, terms with a zero result are not stored.
+         */
+        internal inline fun map(a: NoiseTerms, dropZeros: Boolean = true, op: (x: Double) -> Double): NoiseTerms {
+            val result = NoiseTerms(a.size)
+            for (k in 0 until a.size) {
+                val v = op(a.coefficientAt(k))
+                if (!dropZeros || v != 0.0) result.append(a.idAt(k), v)
+            }
+            return result
+        }
+
+        /**
+         * Writes the union of the noise symbols of [a] and [b] to [ids], and their coefficients
+         * (0.0 if not present) at the same positions to [x] and [y].
+         * @return the number of noise symbols in the union.
+         */
+        private fun align(a: NoiseTerms, b: NoiseTerms, ids: LongArray, x: DoubleArray, y: DoubleArray): Int {
+            var n = 0
+            forEachPair(a, b) { id, xi, yi ->
+                ids[n] = id
+                x[n] = xi
+                y[n] = yi
+                n++
+            }
+            return n
+        }
+
+        /**
+         * Applies [kernel] to the aligned coefficients of [a] and [b], writing the coefficients of the result.
+         * If both have the same noise symbols, which is frequent, the coefficients need not be aligned.
+         */
+        private inline fun combine(
+            a: NoiseTerms,
+            b: NoiseTerms,
+            kernel: (x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int) -> Unit
+        ): NoiseTerms {
+            val result: NoiseTerms
+            if (a.count == b.count && a.ids.contentEquals(b.ids, a.count)) {
+                result = NoiseTerms(a.count)
+                a.ids.copyInto(result.ids, 0, 0, a.count)
+                result.count = a.count
+                kernel(a.coefficients, b.coefficients, result.coefficients, a.count)
+            } else {
+                result = NoiseTerms(a.count + b.count)
+                val y = DoubleArray(a.count + b.count)
+                result.count = align(a, b, result.ids, result.coefficients, y)
+                kernel(result.coefficients, y, result.coefficients, result.count)
+            }
+            result.removeIf { result.coefficients[it] == 0.0 }
+            return result
+        }
+
+        private fun LongArray.contentEquals(other: LongArray, count: Int): Boolean {
+            for (k in 0 until count)
+                if (this[k] != other[k]) return false
+            return true
+        }
+
+        /** Element-wise sum a+b, with given rounding by math. */
+        fun add(a: NoiseTerms, b: NoiseTerms, rounding: Rounding = Rounding.AWAY, math: RoundingMath = AffineForm.math): NoiseTerms =
+            combine(a, b) { x, y, result, count -> math.add(x, y, result, count, rounding) }
+
+        /** Element-wise difference a-b, with given rounding by math. */
+        fun subtract(a: NoiseTerms, b: NoiseTerms, rounding: Rounding = Rounding.AWAY, math: RoundingMath = AffineForm.math): NoiseTerms =
+            combine(a, b) { x, y, result, count -> math.sub(x, y, result, count, rounding) }
+
+        /** Negation; exact. */
+        fun negate(a: NoiseTerms): NoiseTerms = map(a, dropZeros = false) { -it }
+
+        /**
+         * Scaling by a factor alpha, with given rounding by math.
+         * @param dropZeros if true, terms with a zero result are not stored.
+         */
+        fun scale(
+            a: NoiseTerms,
+            alpha: Double,
+            rounding: Rounding = Rounding.AWAY,
+            dropZeros: Boolean = true,
+            math: RoundingMath = AffineForm.math
+        ): NoiseTerms {
+            val result = NoiseTerms(a.count)
+            a.ids.copyInto(result.ids, 0, 0, a.count)
+            result.count = a.count
+            math.mul(a.coefficients, alpha, result.coefficients, a.count, rounding)
+            if (dropZeros) result.removeIf { result.coefficients[it] == 0.0 }
+            return result
+        }
+
+        /**
+         * The sorted union of the noise symbol indexes of all given noise terms.
+         */
+        fun unionOfIds(terms: Iterable<NoiseTerms>): LongArray {
+            var result = LongArray(0)
+            for (t in terms) {
+                val merged = LongArray(result.size + t.size)
+                var i = 0
+                var j = 0
+                var n = 0
+                while (i < result.size || j < t.size) {
+                    val id = when {
+                        j >= t.size || (i < result.size && result[i] < t.idAt(j)) -> result[i++]
+                        i >= result.size || t.idAt(j) < result[i] -> t.idAt(j++)
+                        else -> { j++; result[i++] }
+                    }
+                    merged[n++] = id
+                }
+                result = merged.copyOf(n)
+            }
+            return result
+        }
+    }
+}
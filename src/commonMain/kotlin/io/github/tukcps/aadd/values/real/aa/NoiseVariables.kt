@@ -2,12 +2,15 @@ package io.github.tukcps.aadd.values.real.aa
 
 import io.github.tukcps.aadd.DDBuilder
 import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.values.real.rounding.Rounding
 import kotlin.math.abs
 
 /**
  * This class manages the noise variables.
  * - provides unique indexes, starting with maxIndex
  * - maintains information on kind and documentation
+ * - reclaims the indexes of noise variables that are no longer used, see [reclaim]
  * @param builder The builder for dependency injection
  */
 class NoiseVariables(val builder: DDBuilder) {
@@ -16,18 +19,31 @@ class NoiseVariables(val builder: DDBuilder) {
      * The maximum index for noise terms that define concrete values.
      * We use index numbers from 1, each new index increases maxIndex.
      */
-    private var maxIndex: Long = 0L
+    internal var maxIndex: Long = 0L
+        private set
 
     /**
      * The maximum index for noise terms that stem from approximation and linearization.
      * We use index numbers from 1, each new index increases maxIndex.
      */
-    private var maxIndexGarbage: Long = 0L
+    internal var maxIndexGarbage: Long = 0L
+        private set
 
     /**
      * String-based ids for each noise variable index.
      */
-    private var names = HashMap<Long, String>()
+    internal var names = HashMap<Long, String>()
+        private set
+
+    /** Index of each string-based id, the inverse of [names]. */
+    private var nameIndex = HashMap<String, Long>()
+
+    /** Number of noise variables created since the last [reclaim]. */
+    private var createdSinceReclaim: Long = 0L
+
+    /** Number of renumberings by [reclaim]; identifies a renumbering in [NoiseTerms.renumber]. */
+    internal var generation: Int = 0
+        private set
 
     /** HashMap that keeps track how often a nonlinear noise mapping is used **/
     private var used = HashMap <Long, Int>(300, 0.75F)
@@ -48,15 +64,19 @@ class NoiseVariables(val builder: DDBuilder) {
     fun newNoiseVar(id: String? = null): Long {
         if (id == null) {
             if (maxIndex < Long.MAX_VALUE){
+                createdSinceReclaim++
+                builder.statistics.noiseSymbolCreated()
                 return ++maxIndex
             } else {
                 throw DDException("max index exceeds maximum length (Long.MAX_VALUE)")
             }
         }
-        for ((index, name) in names)
-            if (id == name) return index
+        nameIndex[id]?.let { return it }
         maxIndex += 1
+        createdSinceReclaim++
+        builder.statistics.noiseSymbolCreated()
         names[maxIndex] = id
+        nameIndex[id] = maxIndex
         return maxIndex
     }
 
@@ -65,50 +85,153 @@ class NoiseVariables(val builder: DDBuilder) {
      * @return index of the noise variable, will be negative.
      */
     fun newGarbageVar(): Long {
-        if (maxIndexGarbage > Long.MIN_VALUE)
+        if (maxIndexGarbage > Long.MIN_VALUE) {
+            createdSinceReclaim++
+            builder.statistics.noiseSymbolCreated()
             return --maxIndexGarbage
-        else
+        } else
             throw DDException("max index exceeds maximum length (Long.MIN_VALUE)")
     }
 
     /**
      * Reduces the number of "garbage" noise variables.
-     * @param xi The map of noise terms of an affine form.
+     * As garbage variables have negative indexes, they are at the front of the sorted noise terms.
+     * @param xi The noise terms of an affine form.
      */
-    fun compressGarbageVariables(xi: HashMap<Long, Double>) {
-        class NoiseTerm(val id: Long, val coefficient: Double, val magnitude: Double)
+    fun compressGarbageVariables(xi: NoiseTerms) {
         val max = builder.settings.affineFormMaxNumberOfNoiseSymbols
         if (xi.size <= max) return
 
         val targetSize = max / 2
         val mergeCount = xi.size - targetSize + 1
 
-        val candidates = ArrayList<NoiseTerm>()
+        var garbageCount = 0
+        while (garbageCount < xi.size && xi.idAt(garbageCount) < 0L)
+            garbageCount++
 
-        for ((id, coefficient) in xi) {
-            if (id < 0L && coefficient.isFinite()) {
-                candidates.add(NoiseTerm(id = id, coefficient = coefficient, magnitude = abs(coefficient)))
-            }
-        }
+        val candidates = ArrayList<Int>(garbageCount)
+        for (k in 0 until garbageCount)
+            if (xi.coefficientAt(k).isFinite())
+                candidates.add(k)
 
         val actualCount = minOf(mergeCount, candidates.size)
         if (actualCount < 2) return
 
         if (actualCount < candidates.size) {
-            candidates.sortWith(compareBy<NoiseTerm> { it.magnitude }.thenBy { it.id })
+            candidates.sortWith(compareBy<Int> { abs(xi.coefficientAt(it)) }.thenBy { xi.idAt(it) })
         }
 
         var mergedRadius = 0.0
-
+        val merged = BooleanArray(garbageCount)
         for (i in 0 until actualCount) {
-            val term = candidates[i]
-            xi.remove(term.id)
-            mergedRadius += term.magnitude
+            val k = candidates[i]
+            merged[k] = true
+            mergedRadius = AffineForm.math.add(mergedRadius, abs(xi.coefficientAt(k)), Rounding.UP)
         }
+        xi.removeIf { k -> k < garbageCount && merged[k] }
+        builder.statistics.noiseSymbolsCompressed(actualCount)
 
         xi[newGarbageVar()] = mergedRadius
     }
 
+    /**
+     * Calls action for each affine form that is reachable by the builder:
+     * the leaves of all DD created via the unique table that have not been collected, and the constraints
+     * of the conditions.
+     */
+    private fun forEachLiveAffineForm(action: (AffineForm) -> Unit) {
+        builder.uniqueTable.forEachNode { if (it is AADD.Leaf) action(it.value) }
+        for (condition in builder.conditions.x.values)
+            if (condition is AADD.Leaf) action(condition.value)
+    }
+
+    /**
+     * @return the indexes of the noise variables used by affine forms that are reachable by the builder.
+     */
+    fun liveSymbols(): Set<Long> {
+        val live = HashSet<Long>()
+        forEachLiveAffineForm { af ->
+            for (k in 0 until af.xi.size) live.add(af.xi.idAt(k))
+        }
+        return live
+    }
+
+    /**
+     * Reclaims the noise variables that are no longer used by a reachable affine form or condition,
+     * and renumbers the remaining ones into the dense ranges 1..maxIndex and maxIndexGarbage..-1.
+     * The renumbering preserves the order of the indexes; hence, noise terms remain sorted.
+     * The ids of reclaimed noise variables are released; a new variable with the same id is
+     * not correlated with the old one, which no reachable affine form uses anyway.
+     *
+     * The noise terms of the leaves are renumbered in place, and the unique table is rehashed.
+     * The results of the LP solver and the operation cache, which depend on the indexes, are discarded.
+     * Affine forms that are held outside of a DD of the builder, e.g. AffineForm objects of a leaf
+     * of a collected DD, keep the old indexes and must not be used afterwards.
+     * Must not be called during an operation or getRange(); requires [DDBuilderSettings.ddUniqueTable].
+     * @return the number of reclaimed noise variables.
+     */
+    fun reclaim(): Int {
+        createdSinceReclaim = 0L
+        if (!builder.settings.ddUniqueTable) return 0
+
+        val live = liveSymbols()
+        val positive = live.filter { it > 0L }.sorted()
+        val negative = live.filter { it < 0L }.sorted()
+        val newIndex = HashMap<Long, Long>(live.size * 2)
+        positive.forEachIndexed { k, index -> newIndex[index] = k + 1L }
+        negative.forEachIndexed { k, index -> newIndex[index] = k.toLong() - negative.size }
+        val reclaimed = maxIndex - maxIndexGarbage - live.size
+
+        generation++
+        forEachLiveAffineForm { af -> af.xi.renumber(generation) { newIndex.getValue(it) } }
+
+        val oldNames = names
+        names = HashMap()
+        nameIndex = HashMap()
+        for ((index, name) in oldNames) {
+            val renumbered = newIndex[index] ?: continue
+            names[renumbered] = name
+            nameIndex[name] = renumbered
+        }
+        maxIndex = positive.size.toLong()
+        maxIndexGarbage = -negative.size.toLong()
+        used.clear()
+        originalAffineForm.clear()
+        timesused.clear()
+
+        builder.uniqueTable.rehash()
+        builder.lpResultCache.clear()
+        builder.operationCache.invalidate()
+        builder.statistics.noiseSymbolsReclaimed(reclaimed.toInt())
+        return reclaimed.toInt()
+    }
+
+    /**
+     * Calls [reclaim] if more than [DDBuilderSettings.noiseReclaimInterval] noise variables
+     * have been created since the last one; called by the builder between operations.
+     */
+    internal fun reclaimIfDue() {
+        val interval = builder.settings.noiseReclaimInterval
+        if (interval > 0 && createdSinceReclaim > interval) reclaim()
+    }
+
+    /**
+     * Restores the state saved by a [io.github.tukcps.aadd.dao.Checkpoint].
+     * @param names the names of the noise variables; if not full, they are added to the existing ones.
+     */
+    internal fun restore(maxIndex: Long, maxIndexGarbage: Long, names: Map<Long, String>, full: Boolean) {
+        if (full) {
+            this.names = HashMap()
+            nameIndex = HashMap()
+        }
+        for ((index, name) in names) {
+            this.names[index] = name
+            nameIndex[name] = index
+        }
+        this.maxIndex = maxIndex
+        this.maxIndexGarbage = maxIndexGarbage
+    }
+
     override fun toString(): String {
         var s = "Noise variables: (max=$maxIndex): "
         for( (key, doc) in names) {
@@ -64,3 +64,9 @@ internal object ErrorFreeTransforms {
 }
 
 internal expect fun twoProdImpl(a: Double, b: Double): Rounded
+
+/**
+ * The exact rounding error of a finite [product] = a*b, without allocation;
+ * used by the array kernels in [RoundingKernels].
+ */
+internal expect fun twoProdError(a: Double, b: Double, product: Double): Double
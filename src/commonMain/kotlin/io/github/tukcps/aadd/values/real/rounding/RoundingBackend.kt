@@ -0,0 +1,30 @@
+package io.github.tukcps.aadd.values.real.rounding
+
+/**
+ * Implementation of directed rounding used by the affine arithmetic of a builder,
+ * see [io.github.tukcps.aadd.DDBuilderSettings.roundingBackend].
+ */
+enum class RoundingBackend {
+    /** Error-free transformations in the default rounding mode; available on all targets. */
+    SOFTWARE,
+
+    /**
+     * The rounding modes of the FPU; available on the native targets.
+     * Where it is not available, [SOFTWARE] is used instead.
+     */
+    HARDWARE;
+
+    /** The implementation of the backend on this platform. */
+    val math: RoundingMath
+        get() = when (this) {
+            SOFTWARE -> IEEE754RoundingMath
+            HARDWARE -> hardwareRoundingMath ?: IEEE754RoundingMath
+        }
+
+    /** true if the backend is implemented on this platform. */
+    val isAvailable: Boolean
+        get() = this == SOFTWARE || hardwareRoundingMath != null
+}
+
+/** Directed rounding by the rounding modes of the FPU, or null if the platform does not allow setting them. */
+internal expect val hardwareRoundingMath: RoundingMath?
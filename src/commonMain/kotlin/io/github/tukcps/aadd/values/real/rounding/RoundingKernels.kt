@@ -0,0 +1,166 @@
+package io.github.tukcps.aadd.values.real.rounding
+
+import kotlin.math.abs
+
+/**
+ * ## Rounding Kernels
+ *
+ * Directed rounding on arrays of doubles, e.g. the coefficients of noise terms.
+ *
+ * Element by element, [add], [sub] and [mul] compute the same results as [IEEE754RoundingMath]:
+ * the rounded result and its exact error are computed by TwoSum or TwoProd, and the result is moved
+ * by one ULP if the error is in the wrong direction. Unlike the scalar functions,
+ * - the rounding mode is dispatched once per array, not once per element,
+ * - no [Rounded] object is created, and
+ * - the ULP step is done by integer arithmetic on the bit pattern instead of nextUp/nextDown.
+ *
+ * Hence, the loop bodies are straight-line code without calls, allocations, or data-dependent jumps,
+ * which the JIT of the JVM and the LLVM backend of Kotlin/Native can vectorize.
+ *
+ * Only the first count elements of the arrays are used; the result array may be one of the arguments.
+ */
+internal object RoundingKernels {
+
+    /** result[k] = x[k] + y[k], rounded as given. */
+    fun add(x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        directed(rounding, result, count, { x[it] + y[it] }) { k, s -> sumError(x[k], y[k], s) }
+
+    /** result[k] = x[k] - y[k], rounded as given. */
+    fun sub(x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        directed(rounding, result, count, { x[it] - y[it] }) { k, s -> sumError(x[k], -y[k], s) }
+
+    /** result[k] = x[k] * alpha, rounded as given. */
+    fun mul(x: DoubleArray, alpha: Double, result: DoubleArray, count: Int, rounding: Rounding) =
+        directed(rounding, result, count, { x[it] * alpha }) { k, p -> twoProdError(x[k], alpha, p) }
+
+    /**
+     * result[k] = x[k] * alpha + y[k], rounded as given.
+     * With directed rounding, the product and the sum are both rounded in the direction of the result;
+     * hence, the result encloses the exact value, but may be one ULP less tight than a single rounding.
+     */
+    fun fma(x: DoubleArray, alpha: Double, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) {
+        when (rounding) {
+            Rounding.NEAREST -> for (k in 0 until count) result[k] = FMA.compute(x[k], alpha, y[k])
+            Rounding.UP -> for (k in 0 until count) result[k] = fmaUp(x[k], alpha, y[k])
+            Rounding.DOWN -> for (k in 0 until count) result[k] = fmaDown(x[k], alpha, y[k])
+            Rounding.AWAY -> for (k in 0 until count) {
+                val hi = fmaUp(x[k], alpha, y[k])
+                val lo = fmaDown(x[k], alpha, y[k])
+                result[k] = if (hi >= -lo) hi else lo
+            }
+            Rounding.TO_ZERO -> for (k in 0 until count) {
+                val hi = fmaUp(x[k], alpha, y[k])
+                val lo = fmaDown(x[k], alpha, y[k])
+                result[k] = if (lo >= 0.0) lo else if (hi <= 0.0) hi else 0.0
+            }
+        }
+    }
+
+    /**
+     * Σ |x[k]|, rounded as given.
+     * The sum is accumulated in four independent partial sums that are added at the end. Each addition is
+     * rounded as given; hence, the result is a bound as the sequential sum, although for four or more
+     * elements it may differ in the last bits.
+     */
+    fun absSum(x: DoubleArray, count: Int, rounding: Rounding): Double = when (rounding) {
+        Rounding.NEAREST -> absSum(x, count) { s, _ -> s }
+        Rounding.UP -> absSum(x, count) { s, e -> up(s, e) }
+        Rounding.DOWN -> absSum(x, count) { s, e -> down(s, e) }
+        Rounding.AWAY -> absSum(x, count) { s, e -> away(s, e) }
+        Rounding.TO_ZERO -> absSum(x, count) { s, e -> toZero(s, e) }
+    }
+
+    private inline fun absSum(x: DoubleArray, count: Int, round: (value: Double, error: Double) -> Double): Double {
+        var s0 = 0.0
+        var s1 = 0.0
+        var s2 = 0.0
+        var s3 = 0.0
+        var k = 0
+        while (k + 4 <= count) {
+            s0 = roundedSum(s0, abs(x[k]), round)
+            s1 = roundedSum(s1, abs(x[k + 1]), round)
+            s2 = roundedSum(s2, abs(x[k + 2]), round)
+            s3 = roundedSum(s3, abs(x[k + 3]), round)
+            k += 4
+        }
+        while (k < count) s0 = roundedSum(s0, abs(x[k++]), round)
+        return roundedSum(roundedSum(s0, s1, round), roundedSum(s2, s3, round), round)
+    }
+
+    private inline fun roundedSum(a: Double, b: Double, round: (value: Double, error: Double) -> Double): Double {
+        val s = a + b
+        return round(s, sumError(a, b, s))
+    }
+
+    private inline fun directed(
+        rounding: Rounding,
+        result: DoubleArray,
+        count: Int,
+        value: (k: Int) -> Double,
+        error: (k: Int, value: Double) -> Double
+    ) {
+        when (rounding) {
+            Rounding.NEAREST -> for (k in 0 until count) result[k] = value(k)
+            Rounding.UP -> for (k in 0 until count) { val v = value(k); result[k] = up(v, error(k, v)) }
+            Rounding.DOWN -> for (k in 0 until count) { val v = value(k); result[k] = down(v, error(k, v)) }
+            Rounding.AWAY -> for (k in 0 until count) { val v = value(k); result[k] = away(v, error(k, v)) }
+            Rounding.TO_ZERO -> for (k in 0 until count) { val v = value(k); result[k] = toZero(v, error(k, v)) }
+        }
+    }
+
+    private fun fmaUp(x: Double, alpha: Double, y: Double): Double {
+        val p = x * alpha
+        val pUp = up(p, twoProdError(x, alpha, p))
+        val s = pUp + y
+        return up(s, sumError(pUp, y, s))
+    }
+
+    private fun fmaDown(x: Double, alpha: Double, y: Double): Double {
+        val p = x * alpha
+        val pDown = down(p, twoProdError(x, alpha, p))
+        val s = pDown + y
+        return down(s, sumError(pDown, y, s))
+    }
+
+    /** Knuth's TwoSum error of s = a + b; not meaningful if s is not finite. */
+    private inline fun sumError(a: Double, b: Double, s: Double): Double {
+        val bp = s - a
+        return (a - (s - bp)) + (b - bp)
+    }
+
+    /*
+     * Doubles are stored as sign and magnitude: adding 1 to the bits of a nonzero finite value
+     * increases its magnitude by one ULP, subtracting 1 decreases it.
+     * (step xor sign) - sign negates the step for negative values, where sign is 0 or -1.
+     */
+
+    /** value rounded up if the exact result value + error is larger. */
+    private inline fun up(value: Double, error: Double): Double {
+        val bits = value.toRawBits()
+        val sign = bits shr 63
+        val step = if (error > 0.0 && value.isFinite()) 1L else 0L
+        val next = Double.fromBits(bits + ((step xor sign) - sign))
+        return if (value == 0.0 && step != 0L) Double.MIN_VALUE else next
+    }
+
+    /** value rounded down if the exact result value + error is smaller. */
+    private inline fun down(value: Double, error: Double): Double {
+        val bits = value.toRawBits()
+        val sign = bits shr 63
+        val step = if (error < 0.0 && value.isFinite()) 1L else 0L
+        val next = Double.fromBits(bits - ((step xor sign) - sign))
+        return if (value == 0.0 && step != 0L) -Double.MIN_VALUE else next
+    }
+
+    /** value rounded away from zero if the exact result value + error has a larger magnitude. */
+    private inline fun away(value: Double, error: Double): Double {
+        val step = if (value.isFinite() && ((value > 0.0 && error > 0.0) || (value < 0.0 && error < 0.0))) 1L else 0L
+        return Double.fromBits(value.toRawBits() + step)
+    }
+
+    /** value rounded towards zero if the exact result value + error has a smaller magnitude. */
+    private inline fun toZero(value: Double, error: Double): Double {
+        val step = if (value.isFinite() && ((value > 0.0 && error < 0.0) || (value < 0.0 && error > 0.0))) 1L else 0L
+        return Double.fromBits(value.toRawBits() - step)
+    }
+}
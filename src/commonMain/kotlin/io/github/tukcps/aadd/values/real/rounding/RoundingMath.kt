@@ -110,4 +110,30 @@ interface RoundingMath {
     fun addRounded(a: Double, b: Double): Rounded
     fun subRounded(a: Double, b: Double): Rounded
     fun mulRounded(a: Double, b: Double): Rounded
+
+    /*
+     * Operations on arrays, e.g. the coefficients of noise terms, for the first count elements.
+     * The result array may be one of the arguments. By default, the kernels of [RoundingKernels] are used;
+     * implementations may override them to set up the rounding once per array.
+     */
+
+    /** result[k] = x[k] + y[k], directed. */
+    fun add(x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        RoundingKernels.add(x, y, result, count, rounding)
+
+    /** result[k] = x[k] - y[k], directed. */
+    fun sub(x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        RoundingKernels.sub(x, y, result, count, rounding)
+
+    /** result[k] = x[k] * alpha, directed. */
+    fun mul(x: DoubleArray, alpha: Double, result: DoubleArray, count: Int, rounding: Rounding) =
+        RoundingKernels.mul(x, alpha, result, count, rounding)
+
+    /** result[k] = x[k] * alpha + y[k], directed. */
+    fun fma(x: DoubleArray, alpha: Double, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        RoundingKernels.fma(x, alpha, y, result, count, rounding)
+
+    /** Σ |x[k]|, directed. */
+    fun absSum(x: DoubleArray, count: Int, rounding: Rounding): Double =
+        RoundingKernels.absSum(x, count, rounding)
 }
\ No newline at end of file
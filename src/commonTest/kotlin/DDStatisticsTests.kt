@@ -0,0 +1,89 @@
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.minus
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.DDStatistics
+import io.github.tukcps.aadd.TimeHistogram
+import io.github.tukcps.aadd.dd.AADD
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class DDStatisticsTests {
+
+    /** A sum of |x_i - y_i| with one condition per i; returns the statistics after getRange. */
+    private fun sumOfDifferences(settings: DDBuilderSettings, n: Int = 4): DDStatistics.Snapshot {
+        var result = DDStatistics.Snapshot()
+        DDBuilder(settings).apply {
+            var sum: AADD = real(0.0)
+            for (i in 0 until n) {
+                val x = real(0.0..1.0, "x$i")
+                val y = real(0.0..1.0, "y$i")
+                var d: AADD = real(0.0)
+                IF(x.greaterThanOrEquals(y))
+                    d = assign(d, x - y)
+                ELSE()
+                    d = assign(d, y - x)
+                END()
+                sum = sum + d
+            }
+            sum.getRange()
+            result = statistics.snapshot()
+            assertEquals(lpCalls.toLong(), result.lpSolves)
+        }
+        return result
+    }
+
+    @Test
+    fun testCounters() {
+        val s = sumOfDifferences(DDBuilderSettings(lpBoundPropagation = false))
+        assertEquals(4L, s.conditionsCreated)
+        assertTrue(s.noiseSymbolsCreated >= 8L)
+        assertTrue(s.aaddLeaves > 0L && s.aaddInternals > 0L && s.bddInternals > 0L)
+        assertTrue(s.peakNodes > 0L)
+        assertTrue(s.applyCalls >= s.applyComputed && s.applyComputed > 0L)
+        assertTrue(s.lpSolves > 0L)
+        assertEquals(s.lpSolves, s.lpTime.count)
+        assertEquals(s.lpTime.count, s.lpTime.counts.sum())
+        assertTrue(s.lpTime.quantileNanos(0.5) <= s.lpTime.maxNanos)
+        assertEquals(23 + TimeHistogram.BUCKETS, s.toLongArray().size)
+    }
+
+    @Test
+    fun testParallelCountsEqualSequential() {
+        val sequential = sumOfDifferences(DDBuilderSettings())
+        val parallel = sumOfDifferences(DDBuilderSettings(lpParallelWorkers = 4, lpParallelCutoff = 2))
+        assertEquals(sequential.lpSolves, parallel.lpSolves)
+        assertEquals(sequential.lpAvoided, parallel.lpAvoided)
+    }
+
+    @Test
+    fun testResetAndSnapshot() {
+        DDBuilder {
+            val x = real(0.0..1.0, "x")
+            val before = statistics.snapshot()
+            val y = x + real(1.0..2.0, "y")
+            assertTrue(statistics.snapshot().aaddLeaves > before.aaddLeaves)
+            assertEquals(before, before.copy())
+            statistics.reset()
+            assertEquals(DDStatistics.Snapshot(), statistics.snapshot())
+            assertEquals(0, lpCalls)
+            (x greaterThan real(0.5)).ite(y, x)
+            assertEquals(1L, statistics.snapshot().conditionsCreated)
+        }
+    }
+
+    @Test
+    fun testSnapshotAndReset() {
+        DDBuilder {
+            val x = real(0.0..1.0, "x")
+            x + real(1.0..2.0, "y")
+            val taken = statistics.snapshotAndReset()
+            assertTrue(taken.aaddLeaves > 0L)
+            assertEquals(DDStatistics.Snapshot(), statistics.snapshot())
+            x greaterThan real(0.5)
+            assertEquals(1L, statistics.snapshotAndReset().conditionsCreated)
+            assertEquals(0L, statistics.snapshot().conditionsCreated)
+        }
+    }
+}
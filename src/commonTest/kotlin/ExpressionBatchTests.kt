@@ -0,0 +1,63 @@
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilder.RealMath.times
+import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.ExpressionBatch
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertSame
+
+class ExpressionBatchTests {
+
+    @Test
+    fun testBatchComputesLikeSingleOperations() {
+        DDBuilder {
+            val x = real(1.0..2.0, "x")
+            val u = real(0.0..1.0, "u")
+            // next = x + u * 0.1
+            val batch = ExpressionBatch(this, "in 0; in 1; const 2 0.1; mul 3 1 2; add 4 0 3; out 4")
+            batch.setReal(0, x)
+            batch.setReal(1, u)
+            batch.run()
+            val expected = x + u * 0.1
+            assertEquals(expected.getRange().min.toDouble(), batch.getReal(4).getRange().min.toDouble(), 1e-9)
+            assertEquals(expected.getRange().max.toDouble(), batch.getReal(4).getRange().max.toDouble(), 1e-9)
+            assertEquals(2, batch.length)
+        }
+    }
+
+    @Test
+    fun testResultsAreStateAcrossRuns() {
+        DDBuilder {
+            // x = x + 1, with x as result that is kept between runs.
+            val batch = ExpressionBatch(this, "in 0\nconst 1 1.0\nadd 2 0 1\nmov 0 2\nout 0")
+            batch.setReal(0, real(0.0))
+            repeat(3) { batch.run() }
+            assertEquals(3.0, batch.getReal(0).getRange().min.toDouble(), 1e-9)
+        }
+    }
+
+    @Test
+    fun testComparisonAndIte() {
+        DDBuilder {
+            val batch = ExpressionBatch(this, "in 0; const 1 0.0; gt 2 0 1; ite 3 2 0 1; out 2; out 3")
+            batch.setReal(0, real(5.0))
+            batch.run()
+            assertSame(Bool.True, batch.getBool(2))
+            assertEquals(5.0, batch.getReal(3).getRange().max.toDouble(), 1e-9)
+        }
+    }
+
+    @Test
+    fun testInvalidPrograms() {
+        DDBuilder {
+            assertFailsWith<DDException> { ExpressionBatch(this, "foo 1 2") }
+            assertFailsWith<DDException> { ExpressionBatch(this, "add 1 2") }
+            val batch = ExpressionBatch(this, "in 0; not 1 0; out 1")
+            batch.setReal(0, real(1.0))
+            assertFailsWith<DDException> { batch.run() }
+        }
+    }
+}
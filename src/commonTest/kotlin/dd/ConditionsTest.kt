@@ -2,6 +2,7 @@ package dd
 
 import io.github.tukcps.aadd.DDBuilder
 import io.github.tukcps.aadd.DDBuilder.RealMath.div
+import io.github.tukcps.aadd.dd.AADD
 import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
 import kotlin.test.*
 
@@ -78,4 +79,46 @@ class ConditionsTest {
             assertEquals(8.0, evalDown.getRange().max.toDouble(), 0.000001)
         }
     }
-}
\ No newline at end of file
+
+    // Conditions that are not referenced by a DD are removed, the others are renumbered in order.
+    @Test
+    fun testCollectConditions() {
+        DDBuilder {
+            val x = real(1.0 .. 8.0)
+            repeat(100) { conditions.newConstraint((x as AADD.Leaf).value) }
+            val ge = x greaterThan real(4.0)
+            repeat(100) { conditions.newConstraint((x as AADD.Leaf).value) }
+            val flag = boolean("flag")
+            val rangeBefore = ge.ite(x, Reals.Empty).getRange()
+
+            assertEquals(200, collectConditions())
+            assertEquals(2, conditions.topIndex)
+            assertEquals(1, ge.index)
+            assertEquals(2, flag.index)
+            assertEquals(2, conditions.indexes["flag"])
+            assertTrue(conditions.getCondition(ge.index) is AADD.Leaf)
+            assertEquals(rangeBefore, ge.ite(x, Reals.Empty).getRange())
+
+            val le = x lessThan real(2.0)
+            assertEquals(3, le.index)
+            assertEquals(3, conditions.indexes.size)
+        }
+    }
+
+    // After renumbering, a new path with the index of a former condition does not see the LP results of that condition.
+    @Test
+    fun testCollectDiscardsPathResults() {
+        DDBuilder {
+            val x = real(0.0 .. 1.0, "x")
+            conditions.newConstraint((x as AADD.Leaf).value)
+            val above = (x greaterThan real(0.5)).ite(x, real(1.0))
+            assertEquals(0.5, above.getRange().min.toDouble(), 1e-6)
+            assertEquals(1.0, above.getRange().max.toDouble(), 1e-6)
+
+            assertEquals(1, collectConditions())
+            val below = (x lessThan real(0.25)).ite(x, real(0.0))
+            assertEquals(0.0, below.getRange().min.toDouble(), 1e-6)
+            assertEquals(0.25, below.getRange().max.toDouble(), 1e-6)
+        }
+    }
+}
@@ -1,5 +1,9 @@
 package dd
 
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.BoolMath.and
+import io.github.tukcps.aadd.DDBuilder.BoolMath.not
+import io.github.tukcps.aadd.DDBuilder.BoolMath.xor
 import io.github.tukcps.aadd.Integer
 import io.github.tukcps.aadd.Real
 import io.github.tukcps.aadd.dd.AADD
@@ -8,6 +12,8 @@ import io.github.tukcps.aadd.dd.div
 import io.github.tukcps.aadd.dd.intersect
 import io.github.tukcps.aadd.dd.ite
 import io.github.tukcps.aadd.dd.minus
+import io.github.tukcps.aadd.dd.numInternalNodes
+import io.github.tukcps.aadd.dd.numUnknownVars
 import io.github.tukcps.aadd.dd.plus
 import io.github.tukcps.aadd.dd.times
 import io.github.tukcps.aadd.util.Assertions
@@ -15,6 +21,7 @@ import io.github.tukcps.aadd.values.real.ia.RealRange
 import testutil.ddTest
 import kotlin.test.Test
 import kotlin.test.assertEquals
+import kotlin.test.assertFalse
 import kotlin.test.assertTrue
 
 class DDFunctionsTests {
@@ -108,4 +115,25 @@ class DDFunctionsTests {
         val c = a intersect b
         Assertions.assertSafeInclusion(2.0..3.0, c.asAadd(), 1e-10)
     }
-}
\ No newline at end of file
+
+    /** The parity of n variables has 2n-1 nodes, but 2^n paths; counting must not visit each path. */
+    @Test
+    fun testCountingOnSharedNodes() {
+        DDBuilder {
+            val parity40 = (1..40).map { boolean("x$it") }.reduce { a, b -> a xor b }
+            assertEquals(79, parity40.numInternalNodes())
+            assertEquals(40, parity40.height())
+            assertEquals(40, parity40.numUnknownVars())
+            assertEquals(1L shl 40, parity40.countLeaves())
+            assertEquals(1L shl 39, parity40.countTrue())
+            assertEquals(1L shl 39, parity40.countFalse())
+            assertEquals(Int.MAX_VALUE, parity40.numLeaves())
+            assertTrue(parity40.satisfiable())
+
+            val parity70 = (41..70).map { boolean("x$it") }.fold(parity40) { a, b -> a xor b }
+            assertEquals(Long.MAX_VALUE, parity70.countLeaves())
+            assertEquals(139, parity70.numInternalNodes())
+            assertFalse((parity70 and parity70.not()).satisfiable())
+        }
+    }
+}
@@ -0,0 +1,87 @@
+package dd
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.BoolMath.and
+import io.github.tukcps.aadd.DDBuilder.BoolMath.or
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class OperationCacheTests {
+
+    @Test
+    fun testRepeatedOperationHitsCache() {
+        DDBuilder {
+            val a = boolean("a")
+            val b = boolean("b")
+            val c = boolean("c")
+            val f = (a and b) or c
+            val g = (a or c) and b
+            val r1 = f and g
+            val hits = operationCache.hits
+            val r2 = f and g
+            assertTrue(operationCache.hits > hits)
+            assertSame(r1, r2)
+        }
+    }
+
+    @Test
+    fun testIteOnSharedSubgraphs() {
+        DDBuilder {
+            val a = boolean("a")
+            val b = boolean("b")
+            val x = real(1.0..2.0, "x")
+            val y = real(3.0..4.0, "y")
+            val r1 = (a and b).ite(x, y)
+            val hits = operationCache.hits
+            val r2 = (a and b).ite(x, y)
+            assertTrue(operationCache.hits > hits)
+            assertSame(r1, r2)
+            assertEquals(1.0, r1.getRange().min.toDouble(), 1e-9)
+            assertEquals(4.0, r1.getRange().max.toDouble(), 1e-9)
+        }
+    }
+
+    @Test
+    fun testGetRangeKeepsCache() {
+        DDBuilder {
+            val x = real(0.0..1.0, "x")
+            val y = real(2.0..3.0, "y")
+            val c = x greaterThan real(0.5)
+            val r1 = c.ite(y, x)
+            r1.getRange()
+            val hits = operationCache.hits
+            val r2 = c.ite(y, x)
+            assertTrue(operationCache.hits > hits)
+            assertSame(r1, r2)
+        }
+    }
+
+    @Test
+    fun testCacheCanBeDisabled() {
+        DDBuilder(DDBuilderSettings(ddOperationCacheSize = 0)).apply {
+            val a = boolean("a")
+            val b = boolean("b")
+            val r1 = a and b
+            val r2 = a and b
+            assertEquals(r1, r2)
+            assertEquals(0L, operationCache.hits)
+        }
+    }
+
+    @Test
+    fun testSettingsChangeInvalidates() {
+        DDBuilder {
+            val a = boolean("a")
+            val b = boolean("b")
+            a and b
+            settings.ddOperationCacheSize = 16
+            val hits = operationCache.hits
+            a and b
+            assertEquals(hits, operationCache.hits)
+        }
+    }
+}
@@ -0,0 +1,90 @@
+package dd
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.BoolMath.and
+import io.github.tukcps.aadd.DDBuilder.BoolMath.or
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.DD
+import io.github.tukcps.aadd.dd.ReorderingMethod
+import io.github.tukcps.aadd.values.bool.XBool
+import io.github.tukcps.aadd.values.real.aa.AffineForm
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class ReorderingTests {
+
+    private val n = 4
+
+    /** (a1 and b1) or ... or (an and bn), with all a created before all b: exponential in n. */
+    private fun DDBuilder.badlyOrdered(): BDD {
+        val a = (1..n).map { boolean("a$it") }
+        val b = (1..n).map { boolean("b$it") }
+        return (0 until n).map { a[it] and b[it] }.reduce { x, y -> x or y }
+    }
+
+    /** Evaluates a DD for an assignment of the variables by name. */
+    private fun DDBuilder.evaluate(dd: DD<*>, assignment: Map<String, Boolean>): Any {
+        var node = dd
+        while (node is DD.Internal<*>) {
+            val index = node.index
+            val name = conditions.indexes.entries.first { it.value == index }.key
+            node = if (assignment.getValue(name)) node.T else node.F
+        }
+        return (node as DD.Leaf<*>).value
+    }
+
+    private fun assignments(): List<Map<String, Boolean>> =
+        (0 until (1 shl (2 * n))).map { bits ->
+            (1..n).associate { "a$it" to (bits shr (it - 1) and 1 == 1) } +
+                (1..n).associate { "b$it" to (bits shr (n + it - 1) and 1 == 1) }
+        }
+
+    private fun expected(assignment: Map<String, Boolean>) =
+        (1..n).any { assignment.getValue("a$it") && assignment.getValue("b$it") }
+
+    @Test
+    fun testSiftingReducesNodes() {
+        DDBuilder {
+            val f = badlyOrdered()
+            val result = reorder(ReorderingMethod.SIFTING)
+            assertTrue(result.nodesAfter < result.nodesBefore, "$result")
+            assertTrue(result.nodesAfter <= 3 * n, "$result")
+            for (assignment in assignments())
+                assertEquals(if (expected(assignment)) XBool.True else XBool.False, evaluate(f, assignment))
+        }
+    }
+
+    @Test
+    fun testWindowPermutationKeepsFunction() {
+        for (method in listOf(ReorderingMethod.WINDOW2, ReorderingMethod.WINDOW3)) {
+            DDBuilder {
+                val f = badlyOrdered()
+                val result = reorder(method)
+                assertTrue(result.nodesAfter <= result.nodesBefore, "$method: $result")
+                for (assignment in assignments())
+                    assertEquals(if (expected(assignment)) XBool.True else XBool.False, evaluate(f, assignment))
+            }
+        }
+    }
+
+    @Test
+    fun testReorderedAADDAndSharing() {
+        DDBuilder {
+            val f = badlyOrdered()
+            val x = f.ite(real(1.0), real(2.0))
+            val rangeBefore = x.getRange()
+            reorder()
+            assertEquals(rangeBefore, x.getRange())
+            for (assignment in assignments()) {
+                val value = evaluate(x, assignment) as AffineForm
+                assertEquals(if (expected(assignment)) 1.0 else 2.0, value.central)
+            }
+            // New nodes are shared with the reordered ones.
+            assertSame(f, badlyOrdered())
+            assertTrue(x is AADD.Internal)
+        }
+    }
+}
@@ -0,0 +1,89 @@
+package dd
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.BoolMath.and
+import io.github.tukcps.aadd.DDBuilder.BoolMath.or
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.DD
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.aa.AffineForm
+import io.github.tukcps.aadd.values.real.aa.minus
+import io.github.tukcps.aadd.values.real.aa.plus
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNotSame
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class UniqueTableTests {
+
+    @Test
+    fun testIsomorphicNodesAreShared() {
+        DDBuilder {
+            val a = boolean("a")
+            val b = boolean("b")
+            val c = boolean("c")
+            assertSame(a and b, a and b)
+            assertSame((a and b) or c, (a and b) or c)
+            assertSame(real(2.0), real(2.0))
+            assertSame(integer(1L..5L), integer(1L..5L))
+            assertSame(string("abc"), string("abc"))
+        }
+    }
+
+    @Test
+    fun testUniqueTableCanBeDisabled() {
+        DDBuilder(DDBuilderSettings(ddUniqueTable = false)).apply {
+            val a = boolean("a")
+            val b = boolean("b")
+            assertNotSame(a and b, a and b)
+            assertEquals(a and b, a and b)
+            assertNotSame(real(2.0), real(2.0))
+        }
+    }
+
+    @Test
+    fun testSharedLeafIsSolvedForAllPaths() {
+        DDBuilder {
+            val x = AffineForm.range(this, -1.0..1.0, "x")
+            val y = AffineForm.range(this, -1.0..1.0, "y")
+            val k = conditions.newConstraint(x - 0.5)   // true: x >= 0.5
+            val j = conditions.newConstraint(y)         // true: y >= 0
+            val shared = leaf(x)
+            val dd = internal(k, internal(j, shared, leaf(y + 5.0)), shared)
+
+            // The shared leaf is reached with x >= 0.5 and with x <= 0.5; its bounds must cover both.
+            val range = dd.getRange()
+            assertTrue(range.min.toDouble() <= -0.999)
+            assertTrue(shared.max.toDouble() >= 0.999)
+            assertEquals(DD.Status.NotSolved, shared.status)
+        }
+    }
+
+    @Test
+    fun testSharedLeafOnInfeasiblePathStaysFeasibleElsewhere() {
+        DDBuilder {
+            val x = AffineForm.range(this, -1.0..1.0, "x")
+            val y = AffineForm.range(this, -1.0..1.0, "y")
+            val k = conditions.newConstraint(x - 0.5)   // true: x >= 0.5
+            val m = conditions.newConstraint(x - 0.7)   // true: x >= 0.7
+            val shared = leaf(x)
+            val dd2 = internal(m, shared, leaf(y - 5.0))
+            val dd1 = internal(k, leaf(y + 5.0), dd2)
+
+            // In dd1, the shared leaf is reached with x <= 0.5 and x >= 0.7, which is infeasible.
+            val range1 = dd1.getRange()
+            assertEquals(-6.0, range1.min.toDouble(), 1e-6)
+            assertEquals(6.0, range1.max.toDouble(), 1e-6)
+
+            // In dd2, the same leaf is reached with x >= 0.7 only; it must neither be dropped nor narrowed.
+            assertTrue(!shared.isInfeasible())
+            assertTrue(dd2.max.toDouble() >= 0.999)
+            assertTrue((dd2 + 1.0).max.toDouble() >= 1.999)
+            val range2 = dd2.getRange()
+            assertEquals(-6.0, range2.min.toDouble(), 1e-6)
+            assertEquals(1.0, range2.max.toDouble(), 1e-6)
+        }
+    }
+}
@@ -64,6 +64,23 @@ class AADDTests {
         }
     }
 
+    @Test
+    // Check that comparisons yield Infeasible on the paths that the LP solver found infeasible.
+    fun infeasibleComparisonTest() {
+        DDBuilder {
+            val a = real(0.0..1.0, "n")
+            val b = real(3.0..4.0, "n")
+            val d = (a greaterThan real(0.5)).ite(a, b)
+            val e = (a lessThan real(0.3)).ite(a, b)
+            val f = d + e
+            val g = f greaterThan real(-100.0)
+            assertEquals(1, g.numInfeasible())
+            assertEquals(3, g.numFeasible())
+            f.getRange()
+            assertEquals(3, f.numFeasible())
+        }
+    }
+
     /**
      * Check that order of indexes in maintained and that ite function orders
      * the result dd nodes according to index order.
@@ -0,0 +1,70 @@
+package dd.aaddtests
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.bounded
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class BoundedSizeTests {
+
+    /** Sum of b_i.ite(2^i, 0) for i in 1..k: 2^k leaves with distinct values. */
+    private fun DDBuilder.sum(k: Int): AADD {
+        var x: AADD = real(0.0)
+        for (i in 1..k) x += boolean("b$i").ite(real((1 shl i).toDouble()), real(0.0))
+        return x
+    }
+
+    @Test
+    fun testBoundedEnclosesOriginal() {
+        DDBuilder {
+            val x = sum(5)
+            assertEquals(32, x.numLeaves())
+            assertSame(x, x.bounded(0))
+            assertSame(x, x.bounded(32))
+
+            val y = x.bounded(4)
+            assertTrue(y.numLeaves() <= 4)
+            assertTrue(y.min.toDouble() <= x.min.toDouble())
+            assertTrue(y.max.toDouble() >= x.max.toDouble())
+            assertTrue(leafMerges > 0)
+            assertTrue(leafMergeLoss > 0.0)
+            assertEquals(leafMergeLoss, statistics.snapshotAndReset().leafMergeLoss)
+            assertEquals(0.0, leafMergeLoss)
+        }
+    }
+
+    @Test
+    fun testBoundedCreatesOnlyChosenLeaves() {
+        DDBuilder {
+            val x = sum(6)
+            val before = statistics.snapshot()
+            val y = x.bounded(5)
+            val after = statistics.snapshot()
+            assertTrue(y.numLeaves() <= 5)
+            assertTrue(after.leafMerges > before.leafMerges)
+            // One leaf per merge at most, none for the candidates that were not chosen.
+            assertTrue(after.aaddLeaves - before.aaddLeaves <= after.leafMerges - before.leafMerges)
+        }
+    }
+
+    @Test
+    fun testBoundedAssign() {
+        DDBuilder(DDBuilderSettings(ddMaxLeaves = 4)).apply {
+            var x: AADD = real(0.0)
+            for (i in 1..6) {
+                IF(boolean("b$i"))
+                x = assign(x, x + (1 shl i).toDouble())
+                END()
+                assertTrue(x.numLeaves() <= 4)
+            }
+            assertTrue(x.min.toDouble() <= 0.0)
+            assertTrue(x.max.toDouble() >= 126.0)
+        }
+    }
+}
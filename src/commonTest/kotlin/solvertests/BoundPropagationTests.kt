@@ -0,0 +1,61 @@
+package solvertests
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.lpsolver.BoundPropagation
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.ia.RealRange
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class BoundPropagationTests {
+
+    @Test
+    fun tightenAndDropTest() {
+        val ids = longArrayOf(1L, 2L)
+        // e1 >= 0.5 and e1 + e2 <= 0, hence e2 <= -0.5.
+        val propagation = BoundPropagation()
+        propagation.addRow(longArrayOf(1L), doubleArrayOf(1.0), 1, true, 0.5)
+        propagation.addRow(ids, doubleArrayOf(1.0, 1.0), 2, false, 0.0)
+        assertEquals(BoundPropagation.Verdict.UNDECIDED, propagation.propagate())
+        assertTrue(propagation.isRedundant(0))
+        assertFalse(propagation.isRedundant(1))
+        assertEquals(-0.5, propagation.maximize(longArrayOf(2L), doubleArrayOf(1.0), 1), 1e-6)
+
+        // e1 >= 0.5 and e1 <= 0.2
+        val infeasible = BoundPropagation()
+        infeasible.addRow(longArrayOf(1L), doubleArrayOf(1.0), 1, true, 0.5)
+        infeasible.addRow(longArrayOf(1L), doubleArrayOf(1.0), 1, false, 0.2)
+        assertEquals(BoundPropagation.Verdict.INFEASIBLE, infeasible.propagate())
+    }
+
+    /** x for x >= 0.5, else x + 1; the single-symbol conditions need no LP solver. */
+    private fun singleSymbol(settings: DDBuilderSettings): Triple<RealRange, Int, Int> {
+        var result = Triple(RealRange.Empty, 0, 0)
+        DDBuilder(settings).apply {
+            val x = real(0.0..1.0, "x")
+            var r: AADD = real(0.0)
+            IF(x.greaterThanOrEquals(0.5))
+                r = assign(r, x)
+            ELSE()
+                r = assign(r, x + 1.0)
+            END()
+            result = Triple(r.getRange(), lpCalls, lpCallsAvoided)
+        }
+        return result
+    }
+
+    @Test
+    fun avoidsLpCallsTest() {
+        val (range, calls, avoided) = singleSymbol(DDBuilderSettings(lpBoundPropagation = true))
+        val (reference, _, _) = singleSymbol(DDBuilderSettings(lpBoundPropagation = false))
+        assertEquals(0, calls)
+        assertTrue(avoided > 0)
+        assertEquals(reference.min.toDouble(), range.min.toDouble(), 1e-6)
+        assertEquals(reference.max.toDouble(), range.max.toDouble(), 1e-6)
+    }
+}
@@ -0,0 +1,96 @@
+package solvertests
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.minus
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.lpsolver.IncrementalLpSolver
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.ia.RealRange
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNull
+
+class IncrementalLpSolverTests {
+
+    @Test
+    fun pushAndPopTest() {
+        val solver = IncrementalLpSolver()
+        val ids = longArrayOf(1L, 2L)
+        val ones = doubleArrayOf(1.0, 1.0)
+        assertEquals(2.0, solver.maximize(ids, ones, 2)!!, 1e-9)
+        // e1 + e2 <= 0.5
+        assertEquals(IncrementalLpSolver.Verdict.FEASIBLE, solver.push(ids, ones, 2, false, 0.5))
+        assertEquals(0.5, solver.maximize(ids, ones, 2)!!, 1e-9)
+        assertEquals(-2.0, solver.minimize(ids, ones, 2)!!, 1e-9)
+        // e1 - e2 >= 1.0, hence max of e1 is 1.0 and e2 <= -0.25
+        assertEquals(IncrementalLpSolver.Verdict.FEASIBLE, solver.push(ids, doubleArrayOf(1.0, -1.0), 2, true, 1.0))
+        assertEquals(-0.25, solver.maximize(longArrayOf(2L), doubleArrayOf(1.0), 1)!!, 1e-9)
+        // e1 + e2 >= 1.0 contradicts the first constraint
+        assertEquals(IncrementalLpSolver.Verdict.INFEASIBLE, solver.push(ids, ones, 2, true, 1.0))
+        assertNull(solver.maximize(ids, ones, 2))
+        solver.pop()
+        assertEquals(IncrementalLpSolver.Verdict.FEASIBLE, solver.verdict)
+        solver.pop()
+        solver.pop()
+        assertEquals(0, solver.depth)
+        assertEquals(2.0, solver.maximize(ids, ones, 2)!!, 1e-9)
+    }
+
+    @Test
+    fun popUndoesPivotsTest() {
+        val solver = IncrementalLpSolver()
+        val ids = longArrayOf(1L, 2L, 3L)
+        val ones = doubleArrayOf(1.0, 1.0, 1.0)
+        // e1 + e2 + e3 <= 1.0, then optimizing pivots the rows of the first level
+        solver.push(ids, ones, 3, false, 1.0)
+        assertEquals(1.0, solver.maximize(ids, ones, 3)!!, 1e-9)
+        repeat(3) {
+            // e1 - e3 >= 0.5 and e2 + e4 <= -0.5 in sibling levels
+            solver.push(longArrayOf(1L, 3L), doubleArrayOf(1.0, -1.0), 2, true, 0.5)
+            assertEquals(1.0, solver.maximize(ids, ones, 3)!!, 1e-9)
+            assertEquals(0.5, solver.maximize(longArrayOf(3L), doubleArrayOf(1.0), 1)!!, 1e-9)
+            solver.pop()
+            solver.push(longArrayOf(2L, 4L), doubleArrayOf(1.0, 1.0), 2, false, -0.5)
+            assertEquals(0.5, solver.maximize(longArrayOf(2L), doubleArrayOf(1.0), 1)!!, 1e-9)
+            assertEquals(1.0, solver.maximize(ids, ones, 3)!!, 1e-9)
+            solver.pop()
+            assertEquals(-3.0, solver.minimize(ids, ones, 3)!!, 1e-9)
+            assertEquals(1, solver.depth)
+        }
+        solver.pop()
+        assertEquals(3.0, solver.maximize(ids, ones, 3)!!, 1e-9)
+    }
+
+    /** |x - y| on paths of two nested conditions; both traversals must compute the same bounds. */
+    private fun absoluteDifference(settings: DDBuilderSettings): RealRange {
+        var range: RealRange = RealRange.Empty
+        DDBuilder(settings).apply {
+            val x = real(0.0..1.0, "x")
+            val y = real(0.0..1.0, "y")
+            var r: AADD = real(0.0)
+            IF(x.greaterThanOrEquals(y))
+                IF((x + y).lessThanOrEquals(real(1.0)))
+                    r = assign(r, x - y)
+                ELSE()
+                    r = assign(r, x + y - 1.0)
+                END()
+            ELSE()
+                r = assign(r, y - x)
+            END()
+            range = r.getRange()
+        }
+        return range
+    }
+
+    @Test
+    fun incrementalEqualsFullSolveTest() {
+        val incremental = absoluteDifference(DDBuilderSettings(lpIncremental = true))
+        val full = absoluteDifference(DDBuilderSettings(lpIncremental = false))
+        assertEquals(0.0, incremental.min.toDouble(), 1e-6)
+        assertEquals(1.0, incremental.max.toDouble(), 1e-6)
+        assertEquals(full.min.toDouble(), incremental.min.toDouble(), 1e-6)
+        assertEquals(full.max.toDouble(), incremental.max.toDouble(), 1e-6)
+    }
+}
@@ -4,6 +4,7 @@ import io.github.tukcps.aadd.DDBuilder.RealMath.plus
 import io.github.tukcps.aadd.dd.AADD
 import io.github.tukcps.aadd.lpsolver.*
 import kotlin.math.ulp
+import kotlin.random.Random
 import kotlin.test.Test
 import kotlin.test.assertEquals
 
@@ -70,6 +71,51 @@ class LPSolverTests {
         assertEquals(-2.0, (minSol as Solved).functionValue)
     }
 
+    @Test
+    fun minMaxBoxTest() {
+        val x0 = LpVariable("x0", canBeNegative = true)
+        val x1 = LpVariable("x1", canBeNegative = true)
+        val function = LpExpression(mapOf(x0 to 1.0, x1 to 1.0), 0.5)
+        // x0 - x1 >= 1
+        val c0 = LpConstraint(LpExpression(mapOf(x0 to 1.0, x1 to -1.0)), LpConstraintSign.GREATER_OR_EQUAL, 1.0)
+        val c1 = LpConstraint(LpExpression(mapOf(x0 to 1.0)), LpConstraintSign.LESS_OR_EQUAL, -0.5)
+        for (engine in LpSolverEngine.values()) {
+            val unconstrained = solveMinMax(listOf(), function, engine = engine) as SolvedMinMax
+            assertEquals(-1.5, unconstrained.min, 1e-9)
+            assertEquals(2.5, unconstrained.max, 1e-9)
+            val constrained = solveMinMax(listOf(c0), function, engine = engine) as SolvedMinMax
+            assertEquals(-0.5, constrained.min, 1e-9)
+            assertEquals(1.5, constrained.max, 1e-9)
+            assertEquals(NoSolution, solveMinMax(listOf(c0, c1), function, engine = engine))
+            // Not converged is reported as such, not as unbounded.
+            assertEquals(Failed, solveMinMax(listOf(c0), function, engine = engine, maxIterations = 0))
+        }
+    }
+
+    // The engines agree on random sparse problems as callLPSolver creates them, see LpSolverBenchmark.
+    @Test
+    fun enginesAgreeTest() {
+        val random = Random(16)
+        val variables = List(32) { LpVariable("e$it", canBeNegative = true) }
+        fun sparse(terms: Int) = LpExpression(
+            List(terms) { variables[random.nextInt(variables.size)] }.associateWith { random.nextDouble(-1.0, 1.0) }
+        )
+        repeat(20) {
+            // Conditions with a positive constant are feasible at the origin.
+            val constraints = List(8) {
+                if (random.nextBoolean())
+                    LpConstraint(sparse(4), LpConstraintSign.GREATER_OR_EQUAL, -random.nextDouble(0.1, 1.0))
+                else
+                    LpConstraint(sparse(4), LpConstraintSign.LESS_OR_EQUAL, random.nextDouble(0.1, 1.0))
+            }
+            val function = sparse(8)
+            val byDense = solveMinMax(constraints, function, engine = LpSolverEngine.DENSE) as SolvedMinMax
+            val bySparse = solveMinMax(constraints, function, engine = LpSolverEngine.SPARSE) as SolvedMinMax
+            assertEquals(byDense.min, bySparse.min, 1e-6)
+            assertEquals(byDense.max, bySparse.max, 1e-6)
+        }
+    }
+
     @Test
     fun simpleTest() {
         DDBuilder {
@@ -0,0 +1,56 @@
+package solvertests
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.minus
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class LpResultCacheTests {
+
+    /** |x - y| for x, y in [0, 1]; the leaves on both paths need the LP solver. */
+    private fun DDBuilder.absoluteDifference(): AADD {
+        val x = real(0.0..1.0, "x")
+        val y = real(0.0..1.0, "y")
+        var r: AADD = real(0.0)
+        IF(x.greaterThanOrEquals(y))
+            r = assign(r, x - y)
+        ELSE()
+            r = assign(r, y - x)
+        END()
+        return r
+    }
+
+    @Test
+    fun constantOffsetReusesResultsTest() {
+        DDBuilder {
+            val r = absoluteDifference()
+            val range = r.getRange()
+            val calls = lpCalls
+            assertTrue(lpResultCache.size > 0)
+
+            val shifted = (r + 1.0).getRange()
+            assertEquals(calls, lpCalls)
+            assertTrue(lpResultCache.hits > 0)
+            assertEquals(range.min.toDouble() + 1.0, shifted.min.toDouble(), 1e-6)
+            assertEquals(range.max.toDouble() + 1.0, shifted.max.toDouble(), 1e-6)
+        }
+    }
+
+    @Test
+    fun cacheCanBeDisabledTest() {
+        DDBuilder(DDBuilderSettings(lpResultCacheSize = 0)).apply {
+            val r = absoluteDifference()
+            r.getRange()
+            val calls = lpCalls
+            (r + 1.0).getRange()
+            assertTrue(lpCalls > calls)
+            assertEquals(0, lpResultCache.size)
+            assertEquals(0L, lpResultCache.hits)
+        }
+    }
+}
@@ -0,0 +1,47 @@
+package solvertests
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.minus
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.ia.RealRange
+import kotlin.test.Test
+import kotlin.test.assertEquals
+
+class ParallelBoundsTests {
+
+    /** A sum of |x_i - y_i| with one condition per i, i.e. 2^n paths; returns the range and the number of LP calls. */
+    private fun sumOfDifferences(settings: DDBuilderSettings, n: Int = 4): Pair<RealRange, Int> {
+        var result = Pair(RealRange.Empty, 0)
+        DDBuilder(settings).apply {
+            var sum: AADD = real(0.0)
+            for (i in 0 until n) {
+                val x = real(0.0..1.0, "x$i")
+                val y = real(0.0..1.0, "y$i")
+                var d: AADD = real(0.0)
+                IF(x.greaterThanOrEquals(y))
+                    d = assign(d, x - y)
+                ELSE()
+                    d = assign(d, y - x)
+                END()
+                sum = sum + d
+            }
+            result = Pair(sum.getRange(), lpCalls)
+        }
+        return result
+    }
+
+    @Test
+    fun parallelEqualsSequentialTest() {
+        val (sequential, sequentialCalls) = sumOfDifferences(DDBuilderSettings())
+        for (incremental in listOf(true, false)) {
+            val settings = DDBuilderSettings(lpIncremental = incremental, lpParallelWorkers = 4, lpParallelCutoff = 2)
+            val (parallel, parallelCalls) = sumOfDifferences(settings)
+            assertEquals(sequential.min.toDouble(), parallel.min.toDouble(), 1e-6)
+            assertEquals(sequential.max.toDouble(), parallel.max.toDouble(), 1e-6)
+            assertEquals(sequentialCalls, parallelCalls)
+        }
+    }
+}
@@ -0,0 +1,92 @@
+package util
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.BoolMath.xor
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilder.RealMath.times
+import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.dao.*
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.greaterThanOrEquals
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+class BinaryFormatTests {
+
+    private fun DDBuilder.example(): AADD {
+        val a = real(1.0..2.0, "a")
+        val b = real(3.0..4.0, "b")
+        val c = (a greaterThanOrEquals real(1.5)).ite(a * b, b + 1.0)
+        return (b greaterThanOrEquals real(3.5)).ite(c + a, c)
+    }
+
+    @Test
+    fun testRoundTripSharesNodes() {
+        DDBuilder {
+            val x = example()
+            val bytes = x.toBinary()
+            assertSame(x, fromBinary(bytes))
+            assertEquals(x.toDAO(), (fromBinary(bytes) as AADD).toDAO())
+        }
+    }
+
+    @Test
+    fun testRoundTripWithJsonDAO() {
+        DDBuilder {
+            val dao = example().toDAO()
+            val fromJson = json.decodeFromString<AaddDAO>(dao.toJson()).toAADD(this)
+            val other = DDBuilder()
+            val fromBinary = other.fromBinary(fromJson.toBinary()) as AADD
+            assertEquals(dao, fromBinary.toDAO())
+            assertEquals(Reals.All.toDAO(), (fromBinary(Reals.All.toBinary()) as AADD).toDAO())
+            assertSame(Reals.Empty, fromBinary(Reals.Empty.toBinary()))
+        }
+    }
+
+    @Test
+    fun testSharingKeepsStreamSmall() {
+        DDBuilder {
+            // Parity of 40 variables: 2^40 paths, but 79 internal nodes.
+            val parity = (1..40).map { boolean("b$it") }.reduce { x, y -> x xor y }
+            val bytes = parity.toBinary()
+            assertTrue(bytes.size < 1000, "${bytes.size} bytes")
+            assertSame(parity, fromBinary(bytes))
+        }
+    }
+
+    @Test
+    fun testNamedStream() {
+        DDBuilder {
+            val b = boolean("b")
+            val dds = mapOf(
+                "x" to b.ite(real(1.0..2.0), real(3.0)),
+                "b" to b,
+                "i" to b.ite(integer(1L..2L), integer(5L)),
+                "s" to b.ite(string("yes"), string("no")),
+                "t" to Bool.True
+            )
+            val sink = ByteArraySink()
+            val writer = DDBinaryWriter(sink)
+            for ((name, dd) in dds) writer.write(dd, name)
+            writer.close()
+            val read = DDBinaryReader(this, ByteArraySource(sink.toByteArray())).readNamed()
+            assertEquals(dds.keys, read.keys)
+            for ((name, dd) in dds) assertSame(dd, read[name], name)
+            assertTrue(read["b"] is BDD)
+        }
+    }
+
+    @Test
+    fun testRejectsUnknownVersion() {
+        DDBuilder {
+            val bytes = real(1.0).toBinary()
+            bytes[DDBinary.MAGIC.size] = (DDBinary.VERSION + 1).toByte()
+            assertFailsWith<DDException> { fromBinary(bytes) }
+            assertFailsWith<DDException> { fromBinary(byteArrayOf(1, 2, 3, 4)) }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+package util
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilder.RealMath.times
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.dao.*
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.greaterThanOrEquals
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFailsWith
+import kotlin.test.assertFalse
+import kotlin.test.assertTrue
+
+class CheckpointTests {
+
+    @Test
+    fun testFullAndIncrementalCheckpoints() {
+        val builder = DDBuilder(DDBuilderSettings(lpParallelWorkers = 1, ddOperationCacheSize = 128))
+        val sink = ByteArraySink()
+        val checkpoint = Checkpoint(builder, sink)
+        with(builder) {
+            val a = real(1.0..2.0, "a")
+            val b = real(3.0..4.0, "b")
+            val x = (a greaterThanOrEquals real(1.5)).ite(a * b, b + 1.0)
+            checkpoint["x"] = x
+            assertTrue(checkpoint.save())
+            val fullSize = sink.size
+
+            val flag = variable("flag", "flag = input", isDecVar = true)
+            val y = (x greaterThanOrEquals real(6.0)).ite(x + a, x)
+            checkpoint["y"] = y
+            checkpoint["flag"] = flag
+            assertFalse(checkpoint.save())
+            assertTrue(sink.size - fullSize < fullSize)
+
+            val restored = DDBuilder()
+            val dds = restored.restore(ByteArraySource(sink.toByteArray()))
+            assertEquals(setOf("x", "y", "flag"), dds.keys)
+            assertEquals(conditions.indexes, restored.conditions.indexes)
+            assertEquals(conditions.topIndex, restored.conditions.topIndex)
+            assertEquals(conditions.introducedDecVars, restored.conditions.introducedDecVars)
+            assertEquals(conditions.isDecVar, restored.conditions.isDecVar)
+            assertEquals(conditions.decVarsIntroducedBy, restored.conditions.decVarsIntroducedBy)
+            assertEquals(128, restored.settings.ddOperationCacheSize)
+            assertEquals(y.getRange(), (dds.getValue("y") as AADD).getRange())
+            assertTrue(dds.getValue("flag") is BDD)
+
+            // Named noise variables keep their index; new ones continue after the restored ones.
+            assertEquals(noiseVariables.newNoiseVar("a"), restored.noiseVariables.newNoiseVar("a"))
+            assertEquals(noiseVariables.newNoiseVar(), restored.noiseVariables.newNoiseVar())
+        }
+    }
+
+    @Test
+    fun testChangedConditionsWriteFullCheckpoint() {
+        DDBuilder {
+            val sink = ByteArraySink()
+            val checkpoint = Checkpoint(this, sink)
+            val a = real(1.0..2.0, "a")
+            repeat(10) { conditions.newConstraint((a as AADD.Leaf).value) }
+            val x = (a greaterThanOrEquals real(1.5)).ite(a, a * 2.0)
+            checkpoint["x"] = x
+            assertTrue(checkpoint.save())
+            assertFalse(checkpoint.save())
+            assertTrue(collectConditions() > 0)
+            assertTrue(checkpoint.save())
+
+            val restored = DDBuilder()
+            val dds = restored.restore(ByteArraySource(sink.toByteArray()))
+            assertEquals(conditions.x.keys, restored.conditions.x.keys)
+            assertEquals(x.getRange(), (dds.getValue("x") as AADD).getRange())
+        }
+    }
+
+    @Test
+    fun testRestoreRequiresNewBuilder() {
+        val sink = ByteArraySink()
+        DDBuilder {
+            Checkpoint(this, sink).apply { this["x"] = real(1.0..2.0); save() }
+        }
+        DDBuilder {
+            real(1.0..2.0)
+            assertFailsWith<DDException> { restore(ByteArraySource(sink.toByteArray())) }
+        }
+    }
+}
@@ -0,0 +1,67 @@
+package values.real.aa
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.values.real.aa.*
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertFalse
+import kotlin.test.assertNull
+import kotlin.test.assertTrue
+
+class NoiseTermsTests {
+
+    @Test
+    fun testPutKeepsIndexesSorted() {
+        val xi = NoiseTerms()
+        xi[5L] = 5.0
+        xi[-2L] = -2.0
+        xi[1L] = 1.0
+        xi[3L] = 3.0
+        xi[1L] = 1.5
+        assertEquals(4, xi.size)
+        assertEquals(listOf(-2L, 1L, 3L, 5L), (0 until xi.size).map { xi.idAt(it) })
+        assertEquals(1.5, xi[1L])
+        assertNull(xi[2L])
+        assertEquals(3.0, xi.remove(3L))
+        assertFalse(xi.containsKey(3L))
+        assertEquals(listOf(-2L, 1L, 5L), xi.keys.toList())
+    }
+
+    @Test
+    fun testMapCompatibility() {
+        val map = hashMapOf(3L to 1.0, -1L to 0.5, 7L to -2.0)
+        val xi = NoiseTerms(map)
+        assertEquals<Map<Long, Double>>(map, xi)
+        assertEquals(map.hashCode(), xi.hashCode())
+        assertEquals(NoiseTerms(xi), xi)
+        assertEquals(3.5, xi.absSum())
+    }
+
+    @Test
+    fun testMergeOperations() {
+        val a = NoiseTerms(hashMapOf(1L to 1.0, 2L to 2.0, 4L to 4.0))
+        val b = NoiseTerms(hashMapOf(-1L to 0.5, 2L to -2.0, 3L to 3.0))
+
+        val sum = NoiseTerms.add(a, b)
+        assertEquals(mapOf(-1L to 0.5, 1L to 1.0, 3L to 3.0, 4L to 4.0), sum)  // 2.0 - 2.0 is dropped
+
+        val difference = NoiseTerms.subtract(a, b)
+        assertEquals(mapOf(-1L to -0.5, 1L to 1.0, 2L to 4.0, 3L to -3.0, 4L to 4.0), difference)
+
+        assertEquals(mapOf(1L to -1.0, 2L to -2.0, 4L to -4.0), NoiseTerms.negate(a))
+        assertEquals(mapOf(1L to 2.0, 2L to 4.0, 4L to 8.0), NoiseTerms.scale(a, 2.0))
+        assertTrue(NoiseTerms.unionOfIds(listOf(a, b)).contentEquals(longArrayOf(-1L, 1L, 2L, 3L, 4L)))
+    }
+
+    @Test
+    fun testAffineFormsUseSortedTerms() {
+        DDBuilder {
+            val a = AffineForm.range(this, 1.0..3.0, "a")
+            val b = AffineForm.range(this, 2.0..4.0, "b")
+            val c = (a * b) - a
+            for (k in 1 until c.xi.size)
+                assertTrue(c.xi.idAt(k - 1) < c.xi.idAt(k))
+            assertEquals(c.radius, c.xi.absSum())
+        }
+    }
+}
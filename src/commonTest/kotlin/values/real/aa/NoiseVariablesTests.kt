@@ -0,0 +1,61 @@
+package values.real.aa
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.dd.AADD
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertNotEquals
+import kotlin.test.assertTrue
+
+class NoiseVariablesTests {
+
+    private val AADD.ids: List<Long> get() = (this as AADD.Leaf).value.xi.keys.toList()
+
+    @Test
+    fun testNamedNoiseVariables() {
+        val builder = DDBuilder()
+        val x = builder.noiseVariables.newNoiseVar("x")
+        val y = builder.noiseVariables.newNoiseVar("y")
+        assertNotEquals(x, y)
+        assertEquals(x, builder.noiseVariables.newNoiseVar("x"))
+        assertEquals(y, builder.noiseVariables.newNoiseVar("y"))
+        assertNotEquals(x, builder.noiseVariables.newNoiseVar())
+    }
+
+    @Test
+    fun testReclaimRenumbersDensely() {
+        DDBuilder {
+            repeat(100) { noiseVariables.newNoiseVar() }
+            val a = real(1.0..2.0, "a")
+            repeat(50) { noiseVariables.newGarbageVar() }
+            val b = real(3.0..4.0)
+            val c = a * b
+            val rangeBefore = c.getRange()
+
+            assertTrue(reclaimNoiseSymbols() >= 150)
+            val live = noiseVariables.liveSymbols()
+            val positive = live.count { it > 0L }
+            val negative = live.count { it < 0L }
+            assertTrue(live.all { it in -negative.toLong()..positive.toLong() && it != 0L })
+            assertTrue((a.ids + b.ids + c.ids).all { it in live })
+            assertEquals(c.ids.sorted(), c.ids)
+
+            // Named variables keep their name, and dependencies are kept.
+            assertEquals(a.ids, listOf(noiseVariables.newNoiseVar("a")))
+            assertEquals(rangeBefore, c.getRange())
+            assertEquals(0.0, ((a + b - b - a) as AADD.Leaf).value.radius, 1e-9)
+        }
+    }
+
+    @Test
+    fun testReclaimInterval() {
+        val builder = DDBuilder(DDBuilderSettings(noiseReclaimInterval = 10))
+        val a = builder.real(1.0..2.0)
+        repeat(100) { builder.noiseVariables.newNoiseVar() }
+        val b = builder.real(1.0..2.0)
+        assertTrue(b.ids.single() < 100L)
+        assertNotEquals(a.ids, b.ids)
+        assertEquals(0.0, ((a - a) as AADD.Leaf).value.radius, 1e-9)
+    }
+}
@@ -3,14 +3,15 @@ package values.real.rounding
 import io.github.tukcps.aadd.values.real.rounding.ErrorFreeTransforms
 import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
 import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
 import kotlin.math.nextDown
 import kotlin.test.Test
 import kotlin.test.assertEquals
 import kotlin.test.assertTrue
 
-class IEEE754RoundingMathAddTest {
+open class IEEE754RoundingMathAddTest {
 
-    private val math = IEEE754RoundingMath
+    protected open val math: RoundingMath = IEEE754RoundingMath
 
     @Test
     fun exactAdditionIsNotExpanded() {
@@ -2,11 +2,12 @@ package values.real.rounding
 
 import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
 import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
 import kotlin.test.*
 
-class IEEE754RoundingMathMulTest {
+open class IEEE754RoundingMathMulTest {
 
-    private val math = IEEE754RoundingMath
+    protected open val math: RoundingMath = IEEE754RoundingMath
 
     @Test
     fun exactProduct() {
@@ -2,14 +2,15 @@ package values.real.rounding
 
 import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
 import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
 
 import kotlin.test.Test
 import kotlin.test.assertEquals
 import kotlin.test.assertTrue
 
-class IEEE754RoundingMathSubTest {
+open class IEEE754RoundingMathSubTest {
 
-    private val math = IEEE754RoundingMath
+    protected open val math: RoundingMath = IEEE754RoundingMath
 
     @Test
     fun exactSubtractionIsNotExpanded() {
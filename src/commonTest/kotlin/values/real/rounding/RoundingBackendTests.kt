@@ -0,0 +1,112 @@
+package values.real.rounding
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDBuilder.RealMath.minus
+import io.github.tukcps.aadd.DDBuilder.RealMath.plus
+import io.github.tukcps.aadd.DDBuilder.RealMath.times
+import io.github.tukcps.aadd.DDBuilderSettings
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingBackend
+import io.github.tukcps.aadd.values.real.rounding.RoundingMath
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertSame
+import kotlin.test.assertTrue
+
+/*
+ * The tests of the software rounding, run with the hardware rounding.
+ * Where the hardware rounding is not available, they test the software rounding again.
+ */
+
+class HardwareRoundingMathAddTest : IEEE754RoundingMathAddTest() {
+    override val math: RoundingMath = RoundingBackend.HARDWARE.math
+}
+
+class HardwareRoundingMathSubTest : IEEE754RoundingMathSubTest() {
+    override val math: RoundingMath = RoundingBackend.HARDWARE.math
+}
+
+class HardwareRoundingMathMulTest : IEEE754RoundingMathMulTest() {
+    override val math: RoundingMath = RoundingBackend.HARDWARE.math
+}
+
+class RoundingBackendTests {
+
+    private val software = IEEE754RoundingMath
+    private val hardware = RoundingBackend.HARDWARE.math
+    private val n = 1000
+
+    private fun values(random: Random) = DoubleArray(n) { random.nextDouble(-1.0, 1.0) * (1 shl random.nextInt(0, 30)) }
+
+    /** Both backends compute the tightest bound for +, - and *, as the error-free transformations are exact. */
+    @Test
+    fun sameBoundsAsSoftware() {
+        val random = Random(16)
+        val x = values(random)
+        val y = values(random)
+        for (rounding in Rounding.values()) for (k in 0 until n) {
+            assertEquals(software.add(x[k], y[k], rounding), hardware.add(x[k], y[k], rounding), "add $rounding")
+            assertEquals(software.sub(x[k], y[k], rounding), hardware.sub(x[k], y[k], rounding), "sub $rounding")
+            assertEquals(software.mul(x[k], y[k], rounding), hardware.mul(x[k], y[k], rounding), "mul $rounding")
+        }
+    }
+
+    /** The software division adds one ULP; the hardware bounds are in between. */
+    @Test
+    fun divisionIsSound() {
+        val random = Random(17)
+        val x = values(random)
+        val y = values(random)
+        for (k in 0 until n) {
+            val nearest = x[k] / y[k]
+            val down = hardware.div(x[k], y[k], Rounding.DOWN)
+            val up = hardware.div(x[k], y[k], Rounding.UP)
+            assertTrue(software.div(x[k], y[k], Rounding.DOWN) <= down && down <= nearest)
+            assertTrue(nearest <= up && up <= software.div(x[k], y[k], Rounding.UP))
+            assertTrue(hardware.sqrt(abs(x[k]), Rounding.DOWN) <= hardware.sqrt(abs(x[k]), Rounding.UP))
+        }
+    }
+
+    private fun abs(x: Double) = if (x < 0.0) -x else x
+
+    @Test
+    fun arraysAsScalars() {
+        val random = Random(18)
+        val x = values(random)
+        val y = values(random)
+        val result = DoubleArray(n)
+        for (math in listOf(software, hardware)) for (rounding in Rounding.values()) {
+            math.add(x, y, result, n, rounding)
+            for (k in 0 until n) assertEquals(math.add(x[k], y[k], rounding), result[k], "add $rounding")
+            math.sub(x, y, result, n, rounding)
+            for (k in 0 until n) assertEquals(math.sub(x[k], y[k], rounding), result[k], "sub $rounding")
+            math.mul(x, 0.1, result, n, rounding)
+            for (k in 0 until n) assertEquals(math.mul(x[k], 0.1, rounding), result[k], "mul $rounding")
+        }
+        val up = hardware.absSum(x, n, Rounding.UP)
+        val down = hardware.absSum(x, n, Rounding.DOWN)
+        assertTrue(down <= up)
+        assertTrue(down <= software.absSum(x, n, Rounding.UP) && software.absSum(x, n, Rounding.DOWN) <= up)
+    }
+
+    @Test
+    fun selectedAtBuilderCreation() {
+        assertTrue(RoundingBackend.SOFTWARE.isAvailable)
+        assertSame(IEEE754RoundingMath, DDBuilder().math)
+        val builder = DDBuilder(DDBuilderSettings(roundingBackend = RoundingBackend.HARDWARE))
+        assertSame(RoundingBackend.HARDWARE.math, builder.math)
+
+        val reference = DDBuilder()
+        val a = builder.real(0.1..0.7, "a")
+        val b = builder.real(-0.3..0.2, "b")
+        val c = (a * b + a - b * 0.1).getRange()
+        val ra = reference.real(0.1..0.7, "a")
+        val rb = reference.real(-0.3..0.2, "b")
+        val rc = (ra * rb + ra - rb * 0.1).getRange()
+        assertEquals(rc.min.toDouble(), c.min.toDouble(), 1e-12)
+        assertEquals(rc.max.toDouble(), c.max.toDouble(), 1e-12)
+    }
+}
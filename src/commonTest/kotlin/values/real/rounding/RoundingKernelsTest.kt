@@ -0,0 +1,108 @@
+package values.real.rounding
+
+import io.github.tukcps.aadd.values.real.rounding.IEEE754RoundingMath
+import io.github.tukcps.aadd.values.real.rounding.Rounding
+import io.github.tukcps.aadd.values.real.rounding.RoundingKernels
+import kotlin.math.abs
+import kotlin.random.Random
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class RoundingKernelsTest {
+
+    private val math = IEEE754RoundingMath
+    private val n = 1000
+
+    /** Random values of mixed signs and magnitudes, with some special values. */
+    private fun values(random: Random) = DoubleArray(n) {
+        when (it % 50) {
+            0 -> 0.0
+            1 -> -0.0
+            2 -> Double.MIN_VALUE
+            3 -> Double.MAX_VALUE
+            4 -> Double.NEGATIVE_INFINITY
+            5 -> Double.NaN
+            else -> random.nextDouble(-1.0, 1.0) * 10.0.pow(random.nextInt(-20, 20))
+        }
+    }
+
+    private fun Double.pow(e: Int): Double {
+        var result = 1.0
+        repeat(abs(e)) { result *= this }
+        return if (e < 0) 1.0 / result else result
+    }
+
+    private fun assertSame(expected: Double, actual: Double, message: String) =
+        assertEquals(expected.toRawBits(), actual.toRawBits(), "$message: expected $expected, was $actual")
+
+    @Test
+    fun elementWiseAsScalarMath() {
+        val random = Random(15)
+        val x = values(random)
+        val y = values(random).also { it.shuffle(random) }
+        val alpha = 0.1
+        val result = DoubleArray(n)
+        for (rounding in Rounding.values()) {
+            RoundingKernels.add(x, y, result, n, rounding)
+            for (k in 0 until n) assertSame(math.add(x[k], y[k], rounding), result[k], "add ${x[k]}, ${y[k]}, $rounding")
+            RoundingKernels.sub(x, y, result, n, rounding)
+            for (k in 0 until n) assertSame(math.sub(x[k], y[k], rounding), result[k], "sub ${x[k]}, ${y[k]}, $rounding")
+            RoundingKernels.mul(x, alpha, result, n, rounding)
+            for (k in 0 until n) assertSame(math.mul(x[k], alpha, rounding), result[k], "mul ${x[k]}, $rounding")
+        }
+    }
+
+    @Test
+    fun resultMayBeArgument() {
+        val x = doubleArrayOf(0.1, 0.2, 0.3)
+        val y = doubleArrayOf(0.2, 0.3, 0.4)
+        val expected = DoubleArray(3) { math.add(x[it], y[it], Rounding.UP) }
+        RoundingKernels.add(x, y, x, 3, Rounding.UP)
+        for (k in 0 until 3) assertSame(expected[k], x[k], "add")
+    }
+
+    @Test
+    fun fmaEnclosesExactValue() {
+        val random = Random(16)
+        val x = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        val y = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        val alpha = 0.1
+        val lo = DoubleArray(n)
+        val hi = DoubleArray(n)
+        val away = DoubleArray(n)
+        val toZero = DoubleArray(n)
+        RoundingKernels.fma(x, alpha, y, lo, n, Rounding.DOWN)
+        RoundingKernels.fma(x, alpha, y, hi, n, Rounding.UP)
+        RoundingKernels.fma(x, alpha, y, away, n, Rounding.AWAY)
+        RoundingKernels.fma(x, alpha, y, toZero, n, Rounding.TO_ZERO)
+        for (k in 0 until n) {
+            assertTrue(lo[k] <= hi[k])
+            assertTrue(lo[k] <= math.add(math.mul(x[k], alpha, Rounding.DOWN), y[k], Rounding.DOWN))
+            assertTrue(hi[k] >= math.add(math.mul(x[k], alpha, Rounding.UP), y[k], Rounding.UP))
+            assertTrue(abs(away[k]) >= abs(toZero[k]))
+            assertTrue(away[k] == lo[k] || away[k] == hi[k])
+        }
+    }
+
+    @Test
+    fun absSumIsBound() {
+        val random = Random(17)
+        val x = DoubleArray(n) { random.nextDouble(-1.0, 1.0) }
+        var sequentialUp = 0.0
+        var sequentialDown = 0.0
+        for (c in x) {
+            sequentialUp = math.add(sequentialUp, abs(c), Rounding.UP)
+            sequentialDown = math.add(sequentialDown, abs(c), Rounding.DOWN)
+        }
+        val up = RoundingKernels.absSum(x, n, Rounding.UP)
+        val down = RoundingKernels.absSum(x, n, Rounding.DOWN)
+        assertTrue(down <= up)
+        assertEquals(sequentialUp, up, 1e-12)
+        assertEquals(sequentialDown, down, 1e-12)
+        // Up to three elements, the sum is the sequential one.
+        assertSame(math.add(math.add(0.1, 0.2, Rounding.UP), 0.3, Rounding.UP),
+            RoundingKernels.absSum(doubleArrayOf(0.1, -0.2, 0.3), 3, Rounding.UP), "absSum")
+        assertEquals(0.0, RoundingKernels.absSum(x, 0, Rounding.UP))
+    }
+}
@@ -0,0 +1,8 @@
+package io.github.tukcps.aadd.util
+
+import java.lang.ref.WeakReference
+
+internal actual class WeakRef<T: Any> actual constructor(referred: T) {
+    private val reference = WeakReference(referred)
+    actual fun get(): T? = reference.get()
+}
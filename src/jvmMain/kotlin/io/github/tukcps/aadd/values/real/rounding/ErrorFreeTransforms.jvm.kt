@@ -3,5 +3,8 @@ package io.github.tukcps.aadd.values.real.rounding
 internal actual fun twoProdImpl(a: Double, b: Double): Rounded {
     val value = a * b
     if (!value.isFinite()) return Rounded(value, 0.0)
-    return Rounded(value, FMA.compute(a, b, -value))
-}
\ No newline at end of file
+    return Rounded(value, twoProdError(a, b, value))
+}
+
+internal actual fun twoProdError(a: Double, b: Double, product: Double): Double =
+    FMA.compute(a, b, -product)
@@ -0,0 +1,4 @@
+package io.github.tukcps.aadd.values.real.rounding
+
+/** The JVM always rounds to nearest; there is no access to the rounding mode. */
+internal actual val hardwareRoundingMath: RoundingMath? = null
@@ -0,0 +1,30 @@
+package dd
+
+import io.github.tukcps.aadd.DDBuilder
+import kotlin.test.Test
+import kotlin.test.assertEquals
+import kotlin.test.assertTrue
+
+class CollectConditionsTest {
+
+    // With the default operation cache, conditions of dropped intermediate results are collected.
+    @Test
+    fun testCollectAfterIntermediateResultsAreDropped() {
+        DDBuilder {
+            val x = real(0.0 .. 100.0, "x")
+            val y = real(200.0 .. 300.0, "y")
+            for (i in 1 .. 50) (x greaterThan real(i.toDouble())).ite(x, y)
+            val kept = x lessThan real(10.0)
+            assertTrue(conditions.topIndex > 50)
+
+            // The weak references of the unique table are cleared by a garbage collection that may take some tries.
+            for (attempt in 1 .. 10) {
+                System.gc()
+                collectConditions()
+                if (conditions.topIndex == 1) break
+            }
+            assertEquals(1, conditions.topIndex)
+            assertEquals(1, kept.index)
+        }
+    }
+}
@@ -0,0 +1,28 @@
+package io.github.tukcps.aadd
+
+import kotlinx.cinterop.COpaquePointer
+import kotlinx.cinterop.CPointer
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.LongVar
+import kotlinx.cinterop.asStableRef
+import kotlinx.cinterop.set
+import kotlin.experimental.ExperimentalNativeApi
+
+/**
+ * Copies the statistics of a builder into the struct AADDStatistics of the C++ wrappers (see aaddhandle.hpp),
+ * 64-bit counts in the order of [DDStatistics.Snapshot.toLongArray].
+ * Exported to C as `aadd_statistics(void* builder, void* counts, int size, bool reset)`.
+ * @param builder the stable pointer of the builder, i.e. the field pinned of its reference.
+ * @param counts the struct to write to.
+ * @param size the number of counts of the struct; at most that many are written.
+ * @param reset whether the statistics are set to zero after the copy.
+ * @return the number of counts of the statistics.
+ */
+@OptIn(ExperimentalForeignApi::class, ExperimentalNativeApi::class)
+@CName("aadd_statistics")
+fun exportStatistics(builder: COpaquePointer, counts: CPointer<LongVar>, size: Int, reset: Boolean): Int {
+    val statistics = builder.asStableRef<DDBuilder>().get().statistics
+    val values = (if (reset) statistics.snapshotAndReset() else statistics.snapshot()).toLongArray()
+    for (k in 0 until minOf(size, values.size)) counts[k] = values[k]
+    return values.size
+}
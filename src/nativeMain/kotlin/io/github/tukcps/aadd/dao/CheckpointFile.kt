@@ -0,0 +1,153 @@
+package io.github.tukcps.aadd.dao
+
+import io.github.tukcps.aadd.DDBuilder
+import io.github.tukcps.aadd.DDException
+import io.github.tukcps.aadd.dd.AADD
+import io.github.tukcps.aadd.dd.BDD
+import io.github.tukcps.aadd.dd.DD
+import kotlinx.cinterop.CPointer
+import kotlinx.cinterop.ExperimentalForeignApi
+import kotlinx.cinterop.addressOf
+import kotlinx.cinterop.convert
+import kotlinx.cinterop.usePinned
+import platform.posix.FILE
+import platform.posix.fclose
+import platform.posix.fflush
+import platform.posix.fopen
+import platform.posix.fread
+import platform.posix.fwrite
+import platform.posix.remove
+import platform.posix.rename
+import kotlin.experimental.ExperimentalNativeApi
+import kotlin.native.ref.createCleaner
+
+/**
+ * A sink that writes to a file; each write is flushed to the operating system.
+ * The bytes go to "<path>.tmp" until [commit] replaces the file at path by it; hence, an existing file is not
+ * truncated before the new content is complete. Writes after [commit] are appended to the file at path.
+ * The file is closed by [close], or when the sink is collected.
+ */
+@OptIn(ExperimentalForeignApi::class, ExperimentalNativeApi::class)
+class FileSink(val path: String) : ByteSink {
+    private val temporary = "$path.tmp"
+    private val handle = FileHandle(fopen(temporary, "wb") ?: throw DDException("Cannot open $temporary for writing"))
+    @Suppress("unused")
+    private val cleaner = createCleaner(handle) { it.close() }
+    private var committed = false
+
+    override fun write(bytes: ByteArray, offset: Int, length: Int) {
+        val file = handle.file ?: throw DDException("File is closed")
+        if (length == 0) return
+        val written = bytes.usePinned { fwrite(it.addressOf(offset), 1.convert(), length.convert(), file) }
+        if (written.toLong() != length.toLong() || fflush(file) != 0) throw DDException("Write error")
+    }
+
+    /** Replaces the file at path by the bytes written so far; does nothing after the first call. */
+    fun commit() {
+        if (committed) return
+        val file = handle.file ?: throw DDException("File is closed")
+        if (fflush(file) != 0) throw DDException("Write error")
+        handle.close()
+        // On Windows, rename does not replace an existing file.
+        if (rename(temporary, path) != 0 && (remove(path) != 0 || rename(temporary, path) != 0))
+            throw DDException("Cannot replace $path")
+        handle.file = fopen(path, "ab") ?: throw DDException("Cannot open $path for writing")
+        committed = true
+    }
+
+    fun close() = handle.close()
+}
+
+/** An open file, closed at most once. */
+@OptIn(ExperimentalForeignApi::class)
+private class FileHandle(var file: CPointer<FILE>?) {
+    fun close() {
+        file?.let { fclose(it) }
+        file = null
+    }
+}
+
+/** A source that reads from a file. */
+@OptIn(ExperimentalForeignApi::class)
+class FileSource(path: String) : ByteSource {
+    private var file: CPointer<FILE>? = fopen(path, "rb") ?: throw DDException("Cannot open $path for reading")
+
+    override fun read(bytes: ByteArray, offset: Int, length: Int): Int {
+        val file = file ?: return -1
+        if (length == 0) return 0
+        val n = bytes.usePinned { fread(it.addressOf(offset), 1.convert(), length.convert(), file) }.toInt()
+        return if (n == 0) -1 else n
+    }
+
+    fun close() {
+        file?.let { fclose(it) }
+        file = null
+    }
+}
+
+/**
+ * Checkpoints of a builder in a file, for the C++ wrapper; see [Checkpoint] and [restore].
+ * The named DD are kept by this object. The first [save] after [restore] starts the file anew with a full checkpoint,
+ * which replaces the file only when it is complete; hence, a restored file is not lost if the program stops meanwhile.
+ */
+class CheckpointFile(val builder: DDBuilder, val path: String) {
+    private val live = LinkedHashMap<String, DD<*>>()
+    private var sink: FileSink? = null
+    private var checkpoint: Checkpoint? = null
+
+    /**
+     * Restores the session from the file into the builder, which must be new.
+     * @return the number of named DD restored.
+     */
+    fun restore(): Int {
+        close()
+        val source = FileSource(path)
+        try {
+            live.clear()
+            live.putAll(builder.restore(source))
+        } finally {
+            source.close()
+        }
+        return live.size
+    }
+
+    fun setReal(name: String, dd: AADD) = set(name, dd)
+
+    fun setBool(name: String, dd: BDD) = set(name, dd)
+
+    /** @return the named AADD, or null if there is none. */
+    fun getReal(name: String): AADD? = live[name] as? AADD
+
+    /** @return the named BDD, or null if there is none. */
+    fun getBool(name: String): BDD? = live[name] as? BDD
+
+    fun remove(name: String) {
+        live.remove(name)
+        checkpoint?.remove(name)
+    }
+
+    /**
+     * Appends a checkpoint to the file.
+     * @return true if the checkpoint is full.
+     */
+    fun save(full: Boolean): Boolean {
+        val checkpoint = checkpoint ?: Checkpoint(builder, FileSink(path).also { sink = it }).also { checkpoint ->
+            this.checkpoint = checkpoint
+            for ((name, dd) in live) checkpoint[name] = dd
+        }
+        val saved = checkpoint.save(full)
+        sink?.commit()
+        return saved
+    }
+
+    fun close() {
+        sink?.close()
+        sink = null
+        checkpoint = null
+    }
+
+    private fun set(name: String, dd: DD<*>) {
+        live[name] = dd
+        checkpoint?.set(name, dd)
+    }
+}
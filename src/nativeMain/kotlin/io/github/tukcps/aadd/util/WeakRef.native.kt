@@ -0,0 +1,10 @@
+package io.github.tukcps.aadd.util
+
+import kotlin.experimental.ExperimentalNativeApi
+import kotlin.native.ref.WeakReference
+
+@OptIn(ExperimentalNativeApi::class)
+internal actual class WeakRef<T: Any> actual constructor(referred: T) {
+    private val reference = WeakReference(referred)
+    actual fun get(): T? = reference.value
+}
@@ -5,13 +5,19 @@ internal actual fun twoProdImpl(a: Double, b: Double): Rounded {
     val value = a * b
     if (!value.isFinite()) return Rounded(value, 0.0)
 
-    val sa = ErrorFreeTransforms.split(a)
-    val sb = ErrorFreeTransforms.split(b)
+    return Rounded(value, twoProdError(a, b, value))
+}
 
-    val error =
-        ((sa.hi * sb.hi - value)
-                + sa.hi * sb.lo
-                + sa.lo * sb.hi)+ sa.lo * sb.lo
+/** Dekker's product error, as [twoProdImpl], with the splits of a and b inlined to avoid allocation. */
+internal actual fun twoProdError(a: Double, b: Double, product: Double): Double {
+    val ca = 134217729.0 * a
+    val aHi = ca - (ca - a)
+    val aLo = a - aHi
+    val cb = 134217729.0 * b
+    val bHi = cb - (cb - b)
+    val bLo = b - bHi
 
-    return Rounded(value, error)
-}
\ No newline at end of file
+    return ((aHi * bHi - product)
+            + aHi * bLo
+            + aLo * bHi) + aLo * bLo
+}
@@ -0,0 +1,175 @@
+package io.github.tukcps.aadd.values.real.rounding
+
+import io.github.tukcps.aadd.values.real.DoubleBound
+import io.github.tukcps.aadd.values.real.DoubleBoundMath.toDouble
+import io.github.tukcps.aadd.values.real.toDoubleBound
+import kotlinx.cinterop.ExperimentalForeignApi
+import platform.posix.FE_DOWNWARD
+import platform.posix.FE_TONEAREST
+import platform.posix.FE_TOWARDZERO
+import platform.posix.FE_UPWARD
+import platform.posix.fegetround
+import platform.posix.fesetround
+import kotlin.math.abs
+import kotlin.math.sqrt
+import kotlin.native.concurrent.ThreadLocal
+
+/**
+ * Operands and results of the scalar operations, see [HardwareRoundingMath].
+ * Each thread has its own rounding mode and hence its own buffer.
+ */
+@ThreadLocal
+private val scratch = DoubleArray(4)
+
+/**
+ * Implementation of [RoundingMath] by the rounding modes of the FPU.
+ *
+ * The rounding mode is set to the requested direction, the operation is done by plain arithmetic,
+ * and the previous mode is restored; for the operations on arrays, the mode is set once per array.
+ * IEEE-754 requires +, -, *, / and sqrt to be correctly rounded in each mode; hence, the results
+ * are the tightest directed bounds. There is no mode for [Rounding.AWAY]; it is the bound of larger
+ * magnitude of [Rounding.UP] and [Rounding.DOWN].
+ *
+ * The functions of the math library (exp, sin, ...) are not specified for directed modes, and the
+ * error-free transformations need rounding to nearest; these are delegated to [IEEE754RoundingMath].
+ *
+ * The compiler assumes the default rounding mode and could move arithmetic across the calls that
+ * set the mode. The operands are therefore loaded from memory after, and the results are stored to memory
+ * before, these calls, which the compiler must assume to access memory.
+ * [Rounding.NEAREST] expects the default rounding mode and does not set it.
+ */
+@OptIn(ExperimentalForeignApi::class)
+object HardwareRoundingMath : RoundingMath {
+
+    private val software = IEEE754RoundingMath
+
+    private fun mode(rounding: Rounding): Int = when (rounding) {
+        Rounding.UP -> FE_UPWARD
+        Rounding.DOWN -> FE_DOWNWARD
+        Rounding.TO_ZERO -> FE_TOWARDZERO
+        Rounding.NEAREST, Rounding.AWAY -> FE_TONEAREST
+    }
+
+    /** Runs action with the given rounding mode of the FPU, and restores the previous mode afterwards. */
+    private inline fun withMode(mode: Int, action: () -> Unit) {
+        val saved = fegetround()
+        fesetround(mode)
+        try {
+            action()
+        } finally {
+            fesetround(saved)
+        }
+    }
+
+    /** The bound of larger magnitude; hi and lo are the results rounded up and down. */
+    private fun away(hi: Double, lo: Double): Double = if (hi >= -lo) hi else lo
+
+    private inline fun binary(a: Double, b: Double, rounding: Rounding, op: (Double, Double) -> Double): Double {
+        if (rounding == Rounding.NEAREST) return op(a, b)
+        val buffer = scratch
+        buffer[0] = a
+        buffer[1] = b
+        if (rounding == Rounding.AWAY) {
+            withMode(FE_UPWARD) { buffer[2] = op(buffer[0], buffer[1]) }
+            withMode(FE_DOWNWARD) { buffer[3] = op(buffer[0], buffer[1]) }
+            return away(buffer[2], buffer[3])
+        }
+        withMode(mode(rounding)) { buffer[2] = op(buffer[0], buffer[1]) }
+        // Rounded down, x - x is -0.0; the software rounding returns 0.0.
+        return if (buffer[2] == 0.0) 0.0 else buffer[2]
+    }
+
+    override fun add(a: Double, b: Double, rounding: Rounding): Double =
+        binary(a, b, rounding) { x, y -> x + y }
+
+    override fun add(a: DoubleBound, b: DoubleBound, rounding: Rounding): DoubleBound? =
+        add(a.toDouble(), b.toDouble(), rounding).toDoubleBound()
+
+    override fun sub(a: Double, b: Double, rounding: Rounding): Double =
+        binary(a, b, rounding) { x, y -> x - y }
+
+    override fun sub(a: DoubleBound, b: DoubleBound, rounding: Rounding): DoubleBound? =
+        sub(a.toDouble(), b.toDouble(), rounding).toDoubleBound()
+
+    override fun mul(a: Double, b: Double, rounding: Rounding): Double =
+        binary(a, b, rounding) { x, y -> x * y }
+
+    override fun div(a: Double, b: Double, rounding: Rounding): Double =
+        binary(a, b, rounding) { x, y -> x / y }
+
+    override fun sqrt(x: Double, rounding: Rounding): Double =
+        binary(x, 0.0, rounding) { y, _ -> sqrt(y) }
+
+    override fun exp(x: Double, rounding: Rounding) = software.exp(x, rounding)
+    override fun exp(x: DoubleBound, rounding: Rounding) = software.exp(x, rounding)
+    override fun ln(x: Double, rounding: Rounding) = software.ln(x, rounding)
+    override fun pow(x: Double, exponent: Double, rounding: Rounding) = software.pow(x, exponent, rounding)
+    override fun sin(x: Double, rounding: Rounding) = software.sin(x, rounding)
+    override fun cos(x: Double, rounding: Rounding) = software.cos(x, rounding)
+    override fun tan(x: Double, rounding: Rounding) = software.tan(x, rounding)
+    override fun asin(x: Double, rounding: Rounding) = software.asin(x, rounding)
+    override fun acos(x: Double, rounding: Rounding) = software.acos(x, rounding)
+    override fun atan(x: Double, rounding: Rounding) = software.atan(x, rounding)
+    override fun midpoint(a: Double, b: Double, rounding: Rounding) = software.midpoint(a, b, rounding)
+    override fun midpoint(a: DoubleBound, b: DoubleBound, rounding: Rounding) = software.midpoint(a, b, rounding)
+    override fun midpoint(a: Double, b: Double) = software.midpoint(a, b)
+    override fun midpoint(a: DoubleBound, b: DoubleBound) = software.midpoint(a, b)
+    override fun addRounded(a: Double, b: Double) = software.addRounded(a, b)
+    override fun subRounded(a: Double, b: Double) = software.subRounded(a, b)
+    override fun mulRounded(a: Double, b: Double) = software.mulRounded(a, b)
+
+    /**
+     * Applies op to all elements with the rounding mode set once; for AWAY, the elements are
+     * computed rounded up into result and rounded down into a temporary array, as result may be an argument.
+     */
+    private inline fun elementWise(result: DoubleArray, count: Int, rounding: Rounding, op: (k: Int) -> Double) {
+        when (rounding) {
+            Rounding.NEAREST -> for (k in 0 until count) result[k] = op(k)
+            Rounding.AWAY -> {
+                val lo = DoubleArray(count)
+                withMode(FE_DOWNWARD) { for (k in 0 until count) lo[k] = op(k) }
+                withMode(FE_UPWARD) { for (k in 0 until count) result[k] = op(k) }
+                for (k in 0 until count) result[k] = away(result[k], lo[k])
+            }
+            else -> withMode(mode(rounding)) { for (k in 0 until count) result[k] = op(k) }
+        }
+    }
+
+    override fun add(x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        elementWise(result, count, rounding) { x[it] + y[it] }
+
+    override fun sub(x: DoubleArray, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) =
+        elementWise(result, count, rounding) { x[it] - y[it] }
+
+    override fun mul(x: DoubleArray, alpha: Double, result: DoubleArray, count: Int, rounding: Rounding) =
+        elementWise(result, count, rounding) { x[it] * alpha }
+
+    /** As [RoundingKernels.fma], the product and the sum are rounded in the same direction. */
+    override fun fma(x: DoubleArray, alpha: Double, y: DoubleArray, result: DoubleArray, count: Int, rounding: Rounding) {
+        if (rounding == Rounding.TO_ZERO) {
+            // The direction of each rounding depends on the sign of the result.
+            val hi = DoubleArray(count)
+            val lo = DoubleArray(count)
+            withMode(FE_UPWARD) { for (k in 0 until count) hi[k] = x[k] * alpha + y[k] }
+            withMode(FE_DOWNWARD) { for (k in 0 until count) lo[k] = x[k] * alpha + y[k] }
+            for (k in 0 until count) result[k] = if (lo[k] >= 0.0) lo[k] else if (hi[k] <= 0.0) hi[k] else 0.0
+        } else
+            elementWise(result, count, rounding) { x[it] * alpha + y[it] }
+    }
+
+    override fun absSum(x: DoubleArray, count: Int, rounding: Rounding): Double {
+        // All terms are positive: AWAY rounds up, TO_ZERO rounds down.
+        val mode = when (rounding) {
+            Rounding.NEAREST -> FE_TONEAREST
+            Rounding.UP, Rounding.AWAY -> FE_UPWARD
+            Rounding.DOWN, Rounding.TO_ZERO -> FE_DOWNWARD
+        }
+        val buffer = scratch
+        withMode(mode) {
+            var sum = 0.0
+            for (k in 0 until count) sum += abs(x[k])
+            buffer[0] = sum
+        }
+        return buffer[0]
+    }
+}
@@ -0,0 +1,3 @@
+package io.github.tukcps.aadd.values.real.rounding
+
+internal actual val hardwareRoundingMath: RoundingMath? = HardwareRoundingMath
@@ -2,9 +2,17 @@
 #define SYMBOLICSYSTEMC
 
 #include <ostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#define SC_INCLUDE_DYNAMIC_PROCESSES
 #include <systemc>
 #include <systemc-ams>
 #include "libnative_api.h"
+#include "aaddhandle.hpp"
 
 //
 // !!!! NEEDS UPDATE TO VERSION 0.9 !!!!
@@ -18,21 +26,15 @@ typedef libnative_kref_com_github_tukcps_jaadd_DDBuilder builder_t;
 
 class nr_s {
 public:
-	nr_s(range_t _numberRangeStruct, libnative_ExportedSymbols* _lib) {
-		numberRangeStruct = _numberRangeStruct;
-		lib = _lib;
-	}
-
-	~nr_s() {
-		lib->DisposeStablePointer(numberRangeStruct.pinned);
-	}
+	nr_s(range_t _numberRangeStruct, libnative_ExportedSymbols* _lib)
+		: numberRangeHandle(_numberRangeStruct, _lib), lib(_lib) {}
 
-	range_t getStruct() {
-		return numberRangeStruct;
+	range_t getStruct() const {
+		return numberRangeHandle.get();
 	}
 
 private:
-	range_t numberRangeStruct;
+	KHandle<range_t> numberRangeHandle;
 	libnative_ExportedSymbols* lib;
 };
 
@@ -40,7 +42,7 @@ class bool_s {
 
 public:
 
-	bool_s(BDD_t _bddStruct, libnative_ExportedSymbols* _lib) : bddStruct(_bddStruct),lib(_lib)
+	bool_s(BDD_t _bddStruct, libnative_ExportedSymbols* _lib) : bddHandle(_bddStruct, _lib), lib(_lib)
 	{}
 
 	// Base BDD functions
@@ -62,58 +64,66 @@ public:
 	}
 
 	bool_s and_(bool_s other) {
-		libnative_kref_com_github_tukcps_jaadd_BDD res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.and_(bddStruct, other.getStruct());
+		libnative_kref_com_github_tukcps_jaadd_BDD res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.and_(bddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s evaluate() {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.evaluate(bddStruct);
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.evaluate(bddHandle.get());
 		return bool_s(res, lib);
 	}
 
 	bool_s intersect(bool_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.intersect(bddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.intersect(bddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s nand(bool_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.nand(bddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.nand(bddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s not_() {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.not_(bddStruct);
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.not_(bddHandle.get());
 		return bool_s(res, lib);
 	}
 
 	bool_s or_(bool_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.or_(bddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.or_(bddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s xor_(bool_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.xor_(bddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.BDD.xor_(bddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool satisfiable() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.satisfiable(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.satisfiable(bddHandle.get());
 	}
 
 	int numFalse() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.numFalse(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.numFalse(bddHandle.get());
 	}
 
 	int numTrue() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.numTrue(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.numTrue(bddHandle.get());
+	}
+
+	int numLeaves() {
+		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.numLeaves(bddHandle.get());
+	}
+
+	int numFeasible() {
+		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.numFeasible(bddHandle.get());
 	}
 
 	const char* toIteString() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.toIteString(bddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.BDD.toIteString(bddHandle.get());
 	}
 
-	libnative_kref_com_github_tukcps_jaadd_BDD getStruct() {
-		return bddStruct;
+	libnative_kref_com_github_tukcps_jaadd_BDD getStruct() const {
+		return bddHandle.get();
 	}
 
 	/* SystemC and AMS required functions */
@@ -122,36 +132,27 @@ public:
 		return false;
 	}
 
-	bool_s& operator=(const bool_s& other) {
-		bddStruct = other.bddStruct;
-		return *this;
-	}
-
 	friend std::ostream& operator<<(std::ostream& os, bool_s& val);
 
 protected:
-	BDD_t bddStruct;
+	KHandle<BDD_t> bddHandle;
 	libnative_ExportedSymbols* lib;
 
 };
 
+class context_s;
+
 class double_s {
 
 public:
 
+	/* The zero of the current context (see context_s::current()); shares its handle, no library call. */
+	double_s();
 
-	double_s() {
-		lib = libnative_symbols();
-		conditions_t conds = lib->kotlin.root.io.github.tukcps.jaadd.Conditions.Conditions__();
-		// Builder Noise Vars Creation
-		noiseVariables_t noiseVars = lib->kotlin.root.io.github.tukcps.jaadd.NoiseVariables.NoiseVariables_();
-		// Initialize our Builder Struct
-		builder_t builderStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.DDBuilder___(conds, noiseVars);
-		aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.range_(builderStruct, 0.0, 0.0, "a");
-	}
-
+	double_s(AADD_t _aaddStruct, libnative_ExportedSymbols* _lib) : aaddHandle(_aaddStruct, _lib), lib(_lib)
+	{}
 
-	double_s(AADD_t _aaddStruct, libnative_ExportedSymbols* _lib) : aaddStruct(_aaddStruct),lib(_lib)
+	double_s(const KHandle<AADD_t>& _aaddHandle, libnative_ExportedSymbols* _lib) : aaddHandle(_aaddHandle), lib(_lib)
 	{}
 
 	// Base AADD Functions
@@ -223,133 +224,136 @@ public:
 		return greaterThanOrEquals(other);
 	}
 
-	/*
-	~AADD() {
-		lib->DisposeStablePointer(aaddStruct.pinned);
-	}*/
-
-	AADD_t getStruct()  {
-		return aaddStruct;
+	AADD_t getStruct() const {
+		return aaddHandle.get();
 	}
 
 	double_s plus(double_s other)  {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.plus(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.plus(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	int get_index()  {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_index(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_index(aaddHandle.get());
 	}
 
 	double get_max()  {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_max(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_max(aaddHandle.get());
 	}
 
 	bool get_maxIsInf()  {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_maxIsInf(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_maxIsInf(aaddHandle.get());
 	}
 
 	bool get_maxIsNaN()  {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_maxIsNaN(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_maxIsNaN(aaddHandle.get());
 	}
 
 	double get_min()  {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_min(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_min(aaddHandle.get());
 	}
 
 	bool get_minIsInf() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_minIsInf(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_minIsInf(aaddHandle.get());
 	}
 
 	bool get_minIsNaN() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_minIsNaN(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.get_minIsNaN(aaddHandle.get());
+	}
+
+	int numLeaves() {
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.numLeaves(aaddHandle.get());
+	}
+
+	int numFeasible() {
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.numFeasible(aaddHandle.get());
 	}
 
 	double_s ceil() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.ceil(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.ceil(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	long long ceilAsLong() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.ceilAsLong(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.ceilAsLong(aaddHandle.get());
 	}
 
 	double_s constrainTo(nr_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.constrainTo(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.constrainTo(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	bool contains(double value) {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.contains(aaddStruct, value);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.contains(aaddHandle.get(), value);
 	}
 
 	double_s div(double_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.div(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.div(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	double_s div(double other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.div__(aaddStruct, other);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.div__(aaddHandle.get(), other);
 		return double_s(res, lib);
 	}
 
 	double_s evaluate() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.evaluate(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.evaluate(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s exp() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.exp(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.exp(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	bool_s ge(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.ge(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.ge(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s greaterThan(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThan(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThan(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s greaterThan(double other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThan__(aaddStruct, other);
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThan__(aaddHandle.get(), other);
 		return bool_s(res, lib);
 	}
 
 	bool_s greaterThanOrEquals(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThanOrEquals(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThanOrEquals(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s greaterThanOrEquals(double other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThanOrEquals__(aaddStruct, other);
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.greaterThanOrEquals__(aaddHandle.get(), other);
 		return bool_s(res, lib);
 	}
 
 	bool_s gt(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.gt(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.gt(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	double_s intersect(double_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.intersect(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.intersect(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	double_s inv() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.inv(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.inv(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s invCeil() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.invCeil(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.invCeil(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s invFloor() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.invFloor(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.invFloor(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
@@ -358,116 +362,116 @@ public:
 	}
 
 	bool_s le(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.le(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.le(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s lessThan(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThan(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThan(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s lessThan(double other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThan__(aaddStruct, other);
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThan__(aaddHandle.get(), other);
 		return bool_s(res, lib);
 	}
 
 	bool_s lessThanOrEquals(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThanOrEquals(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThanOrEquals(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	bool_s lessThanOrEquals(double other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThanOrEquals__(aaddStruct, other);
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lessThanOrEquals__(aaddHandle.get(), other);
 		return bool_s(res, lib);
 	}
 
 	double_s log() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.log(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.log(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	bool_s lt(double_s other) {
-		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lt(aaddStruct, other.getStruct());
+		BDD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.lt(aaddHandle.get(), other.getStruct());
 		return bool_s(res, lib);
 	}
 
 	double_s minus(double_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.minus(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.minus(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 
 	}
 
 	double_s minus(double other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.minus__(aaddStruct, other);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.minus__(aaddHandle.get(), other);
 		return double_s(res, lib);
 	}
 
 	double_s negate() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.negate(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.negate(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s floor() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.floor(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.floor(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s plus(double other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.plus__(aaddStruct, other);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.plus__(aaddHandle.get(), other);
 		return double_s(res, lib);
 	}
 
 	double_s pow(double_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.pow(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.pow(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	double_s pow(double other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.pow___(aaddStruct, other);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.pow___(aaddHandle.get(), other);
 		return double_s(res, lib);
 	}
 
 	double_s power(double_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.power(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.power(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	double_s power2() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.power2(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.power2(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s sqrt() {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.sqrt(aaddStruct);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.sqrt(aaddHandle.get());
 		return double_s(res, lib);
 	}
 
 	double_s times(double_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.times(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.times(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	double_s times(bool_s other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.times_(aaddStruct, other.getStruct());
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.times_(aaddHandle.get(), other.getStruct());
 		return double_s(res, lib);
 	}
 
 	double_s times(double other) {
-		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.times___(aaddStruct, other);
+		AADD_t res = lib->kotlin.root.io.github.tukcps.jaadd.AADD.times___(aaddHandle.get(), other);
 		return double_s(res, lib);
 	}
 
 	const char* toString() {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.toString(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.toString(aaddHandle.get());
 	}
 	// TODO rewrite so it converts the sus pointer to std::String
 	const char* toIteString() const {
-		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.toIteString(aaddStruct);
+		return lib->kotlin.root.io.github.tukcps.jaadd.AADD.toIteString(aaddHandle.get());
 	}
 
 	void getRange() {
-		lib->kotlin.root.io.github.tukcps.jaadd.AADD.getRange(aaddStruct);
+		lib->kotlin.root.io.github.tukcps.jaadd.AADD.getRange(aaddHandle.get());
 	}
 
 	/* SystemC and AMS required functions */
@@ -476,15 +480,10 @@ public:
 		return false;
 	}
 
-	double_s& operator=(const double_s& other) {
-		aaddStruct = other.aaddStruct;
-		return *this;
-	}
-
 	friend std::ostream& operator<<(std::ostream& os,const double_s& val);
 
 protected:
-	AADD_t aaddStruct;
+	KHandle<AADD_t> aaddHandle;
 	libnative_ExportedSymbols* lib;
 };
 
@@ -500,58 +499,322 @@ public:
 		// Builder Noise Vars Creation
 		libnative_kref_com_github_tukcps_jaadd_NoiseVariables noiseVars = lib->kotlin.root.io.github.tukcps.jaadd.NoiseVariables.NoiseVariables_();
 		// Initialize our Builder Struct
-		builderStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.DDBuilder___(conds, noiseVars);
+		builderHandle = KHandle<builder_t>(lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.DDBuilder___(conds, noiseVars), lib);
+		lib->DisposeStablePointer(noiseVars.pinned);
+		lib->DisposeStablePointer(conds.pinned);
+		// Preallocated constant for default-constructed values
+		zeroHandle = KHandle<AADD_t>(lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.scalar(builderHandle.get(), 0.0), lib);
 	}
-	
+
 	~context_s() {
-		lib->DisposeStablePointer(builderStruct.pinned);
+		if (currentContext() == this) currentContext() = nullptr;
+	}
+
+	context_s(const context_s&) = delete;
+	context_s& operator=(const context_s&) = delete;
+
+	/*
+	 * The context of default-constructed values, e.g. of sc_signal<double_s>, ports and arrays.
+	 * Unless another context has been made current, this is a context of the calling thread created on first use,
+	 * such that all values of a design share one builder. Builders are not thread-safe; hence, each thread
+	 * has its own current context.
+	 */
+	static context_s& current() {
+		if (currentContext() == nullptr) {
+			// Intentionally not destroyed: its stable pointers must not be disposed after the runtime has shut down.
+			static thread_local context_s* threadContext = new context_s(libnative_symbols(), "default");
+			return *threadContext;
+		}
+		return *currentContext();
+	}
+
+	/* Makes this context the one of default-constructed values in the calling thread. */
+	void makeCurrent() {
+		currentContext() = this;
+	}
+
+	/* Statistics of the builder of this context, see AADDStatistics; reset sets them to zero after the copy. */
+	AADDStatistics statistics(bool reset = false) {
+		return aaddStatistics(builderHandle.get().pinned, reset);
+	}
+
+	/* The constant zero of this context; created once, shared by all default-constructed values. */
+	double_s zero() const {
+		return double_s(zeroHandle, lib);
 	}
 
 	double_s range(double min, double max, int index) {
-		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.range(builderStruct, min, max, index);
+		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.range(builderHandle.get(), min, max, index);
 		return double_s(aaddStruct, lib);
 	}
 
 	double_s range(double min, double max, const char* id) {
-		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.range_(builderStruct, min, max, id);
+		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.range_(builderHandle.get(), min, max, id);
 		return double_s(aaddStruct, lib);
 	}
 
 	double_s scalar(double value) {
-		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.scalar(builderStruct, value);
+		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.scalar(builderHandle.get(), value);
 		return double_s(aaddStruct, lib);
 	}
 
 	double_s assign(double_s old, double_s new_) {
-		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.assign(builderStruct, old.getStruct(), new_.getStruct());
+		AADD_t aaddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.assign(builderHandle.get(), old.getStruct(), new_.getStruct());
 		return double_s(aaddStruct, lib);
 	}
 
 	bool_s assign(bool_s old, bool_s new_) {
-		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.assign_(builderStruct, old.getStruct(), new_.getStruct());
+		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.assign_(builderHandle.get(), old.getStruct(), new_.getStruct());
 		return bool_s(bddStruct, lib);
 	}
 
 	bool_s IF(bool_s cond) {
 		BDD_t condstruct = cond.getStruct();
-		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.IF(builderStruct, condstruct);
+		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.IF(builderHandle.get(), condstruct);
 		return bool_s(bddStruct, lib);
 	}
 
 	bool_s END() {
-		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.END(builderStruct);
+		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.END(builderHandle.get());
 		return bool_s(bddStruct, lib);
 	}
 
 	bool_s ELSE() {
-		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.ELSE(builderStruct);
+		libnative_kref_com_github_tukcps_jaadd_BDD bddStruct = lib->kotlin.root.io.github.tukcps.jaadd.DDBuilder.ELSE(builderHandle.get());
 		return bool_s(bddStruct, lib);
 	}
 
 protected:
-	libnative_kref_com_github_tukcps_jaadd_DDBuilder builderStruct;
+	KHandle<builder_t> builderHandle;
+	KHandle<AADD_t> zeroHandle;
 	libnative_ExportedSymbols* lib;
-	
+
+private:
+	static context_s*& currentContext() {
+		static thread_local context_s* context = nullptr;
+		return context;
+	}
+};
+
+inline double_s::double_s() : double_s(context_s::current().zero()) {}
+
+/*
+ * Trace file for symbolic signals.
+ * Instead of the string representation of the DD, it records per timestep only a summary of each signal:
+ * its bounds (min, max), its number of leaves, and its number of feasible leaves.
+ * For bool_s, min and max are 0/1: min is 1 iff there is no false leaf, max is 1 iff there is a true leaf.
+ *
+ * Formats:
+ * - BINARY: "AADDTRC1", uint32 number of signals, per signal uint8 kind (0 real, 1 bool), uint16 length, name;
+ *   then per sample the double time in seconds and, per signal, double min, double max, uint32 leaves, uint32 feasible.
+ *   All values are little-endian, doubles as IEEE 754 binary64, independent of the host.
+ * - VCD: real variables <name>.min, <name>.max and integer variables <name>.leaves, <name>.feasible;
+ *   as usual in VCD, only changes are written.
+ *
+ * Sampling happens when sample() is called, or periodically after start(period).
+ * With decimation n, only every n-th timestep is recorded.
+ */
+class sym_trace_file {
+
+public:
+
+	enum format_t { BINARY, VCD };
+
+	sym_trace_file(const std::string& fileName, format_t _format = BINARY, unsigned _decimation = 1)
+		: out(fileName.c_str(), std::ios::binary), format(_format), decimation(_decimation == 0 ? 1 : _decimation),
+		  steps(0), headerWritten(false), lastTime(-1.0) {}
+
+	~sym_trace_file() {
+		out.flush();
+	}
+
+	sym_trace_file(const sym_trace_file&) = delete;
+	sym_trace_file& operator=(const sym_trace_file&) = delete;
+
+	/* Registers a signal; must be called before the first sample, otherwise an error is reported. */
+	void trace(double_s& val, const std::string& name) {
+		add(&val, nullptr, name);
+	}
+
+	void trace(bool_s& val, const std::string& name) {
+		add(nullptr, &val, name);
+	}
+
+	/* Records all signals at the current simulation time; further calls in the same timestep are ignored. */
+	void sample() {
+		double now = sc_core::sc_time_stamp().to_seconds();
+		if (now == lastTime) return;
+		lastTime = now;
+		if (steps++ % decimation != 0) return;
+		if (!headerWritten) writeHeader();
+		if (format == BINARY)
+			putDouble(now);
+		else
+			out << '#' << static_cast<unsigned long long>(now * 1e12 + 0.5) << '\n';
+		for (size_t i = 0; i < signals.size(); i++)
+			write(signals[i], summarize(signals[i]));
+	}
+
+	/* Spawns a process that samples every period. */
+	void start(const sc_core::sc_time& period) {
+		samplingPeriod = period;
+		sc_core::sc_spawn(sc_core::sc_bind(&sym_trace_file::samplingThread, this));
+	}
+
+	void flush() {
+		out.flush();
+	}
+
+private:
+
+	struct summary_t {
+		double min;
+		double max;
+		uint32_t leaves;
+		uint32_t feasible;
+	};
+
+	struct signal_t {
+		double_s* real;
+		bool_s* boolean;
+		std::string name;
+		std::string id;
+		summary_t last;
+		bool written;
+	};
+
+	void add(double_s* real, bool_s* boolean, const std::string& name) {
+		if (headerWritten) {
+			SC_REPORT_ERROR("sym_trace_file", ("signal " + name + " traced after the first sample").c_str());
+			return;
+		}
+		signal_t sig;
+		sig.real = real;
+		sig.boolean = boolean;
+		sig.name = name;
+		sig.id = vcdId(signals.size());
+		sig.written = false;
+		signals.push_back(sig);
+	}
+
+	static summary_t summarize(signal_t& sig) {
+		summary_t s;
+		if (sig.real) {
+			s.min = sig.real->get_min();
+			s.max = sig.real->get_max();
+			s.leaves = static_cast<uint32_t>(sig.real->numLeaves());
+			s.feasible = static_cast<uint32_t>(sig.real->numFeasible());
+		} else {
+			s.min = sig.boolean->numFalse() == 0 ? 1.0 : 0.0;
+			s.max = sig.boolean->numTrue() > 0 ? 1.0 : 0.0;
+			s.leaves = static_cast<uint32_t>(sig.boolean->numLeaves());
+			s.feasible = static_cast<uint32_t>(sig.boolean->numFeasible());
+		}
+		return s;
+	}
+
+	/* Identifier prefix of the i-th signal in VCD; vcdSub appends one character for each of its four variables. */
+	static std::string vcdId(size_t i) {
+		std::string id;
+		size_t n = i;
+		do {
+			id += static_cast<char>('!' + n % 94);
+			n /= 94;
+		} while (n > 0);
+		return id;
+	}
+
+	static std::string vcdSub(const std::string& id, int k) {
+		return id + static_cast<char>('!' + k);
+	}
+
+	void writeHeader() {
+		headerWritten = true;
+		if (format == BINARY) {
+			out.write("AADDTRC1", 8);
+			putUnsigned(signals.size(), 4);
+			for (size_t i = 0; i < signals.size(); i++) {
+				uint16_t len = static_cast<uint16_t>(signals[i].name.size());
+				putUnsigned(signals[i].real ? 0 : 1, 1);
+				putUnsigned(len, 2);
+				out.write(signals[i].name.data(), len);
+			}
+		} else {
+			out << "$timescale 1 ps $end\n$scope module aadd $end\n";
+			for (size_t i = 0; i < signals.size(); i++) {
+				const std::string& id = signals[i].id;
+				out << "$var real 64 " << vcdSub(id, 0) << ' ' << signals[i].name << ".min $end\n";
+				out << "$var real 64 " << vcdSub(id, 1) << ' ' << signals[i].name << ".max $end\n";
+				out << "$var integer 32 " << vcdSub(id, 2) << ' ' << signals[i].name << ".leaves $end\n";
+				out << "$var integer 32 " << vcdSub(id, 3) << ' ' << signals[i].name << ".feasible $end\n";
+			}
+			out << "$upscope $end\n$enddefinitions $end\n";
+		}
+	}
+
+	void write(signal_t& sig, const summary_t& s) {
+		if (format == BINARY) {
+			putDouble(s.min);
+			putDouble(s.max);
+			putUnsigned(s.leaves, 4);
+			putUnsigned(s.feasible, 4);
+			return;
+		}
+		char buf[32];
+		if (!sig.written || s.min != sig.last.min) {
+			std::snprintf(buf, sizeof(buf), "%.17g", s.min);
+			out << 'r' << buf << ' ' << vcdSub(sig.id, 0) << '\n';
+		}
+		if (!sig.written || s.max != sig.last.max) {
+			std::snprintf(buf, sizeof(buf), "%.17g", s.max);
+			out << 'r' << buf << ' ' << vcdSub(sig.id, 1) << '\n';
+		}
+		if (!sig.written || s.leaves != sig.last.leaves)
+			out << 'b' << binary(s.leaves) << ' ' << vcdSub(sig.id, 2) << '\n';
+		if (!sig.written || s.feasible != sig.last.feasible)
+			out << 'b' << binary(s.feasible) << ' ' << vcdSub(sig.id, 3) << '\n';
+		sig.last = s;
+		sig.written = true;
+	}
+
+	/* Writes the lowest bytes of v, least significant first. */
+	void putUnsigned(uint64_t v, int bytes) {
+		char buf[8];
+		for (int i = 0; i < bytes; i++)
+			buf[i] = static_cast<char>((v >> (8 * i)) & 0xffu);
+		out.write(buf, bytes);
+	}
+
+	void putDouble(double v) {
+		uint64_t bits;
+		std::memcpy(&bits, &v, sizeof(bits));
+		putUnsigned(bits, 8);
+	}
+
+	static std::string binary(uint32_t v) {
+		std::string bits;
+		do {
+			bits.insert(bits.begin(), static_cast<char>('0' + (v & 1u)));
+			v >>= 1;
+		} while (v != 0);
+		return bits;
+	}
+
+	void samplingThread() {
+		while (true) {
+			sample();
+			sc_core::wait(samplingPeriod);
+		}
+	}
+
+	std::ofstream out;
+	format_t format;
+	unsigned decimation;
+	unsigned long long steps;
+	bool headerWritten;
+	double lastTime;
+	sc_core::sc_time samplingPeriod;
+	std::vector<signal_t> signals;
 };
 
 // Required Global overloads
@@ -569,6 +832,10 @@ inline void sc_trace(sc_trace_file*& f, double_s& val, std::string name) {
 	sc_trace(f, val.toString(), name);
 }
 
+inline void sc_trace(sym_trace_file* f, double_s& val, std::string name) {
+	f->trace(val, name);
+}
+
 // overloads for bool_s
 
 inline std::ostream& operator<<(std::ostream& os, bool_s& val) {
@@ -582,6 +849,10 @@ inline void sc_trace(sc_trace_file*& f, bool_s& val, std::string name) {
 	sc_trace(f, val.toIteString(), name);
 }
 
+inline void sc_trace(sym_trace_file* f, bool_s& val, std::string name) {
+	f->trace(val, name);
+}
+
 
 
 // Macros for code readability: